@@ -0,0 +1,102 @@
+#ifndef BENCH_H
+#define BENCH_H
+
+#include <chrono>
+#include <string>
+#include <vector>
+#include <utility>
+
+namespace AstrocoreBench
+{
+    // Handed to each benchmark. Only the body of the KeepRunning() loop is timed,
+    // so setup/teardown can happen before and after it.
+    class BenchState
+    {
+    private:
+        int iterations;
+        int currentIteration = 0;
+        std::chrono::steady_clock::time_point startTime;
+        double elapsedMs = 0;
+        std::vector<std::pair<std::string, double>> counters;
+        std::vector<std::string> failedChecks;
+
+    public:
+        BenchState(int iterations)
+        {
+            this->iterations = iterations;
+        }
+
+        bool KeepRunning()
+        {
+            if (currentIteration == 0)
+            {
+                startTime = std::chrono::steady_clock::now();
+            }
+            if (currentIteration < iterations)
+            {
+                currentIteration++;
+                return true;
+            }
+            elapsedMs = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - startTime).count();
+            return false;
+        }
+
+        // Report an extra value alongside the timing (item counts, cache hits, etc)
+        void SetCounter(std::string name, double value)
+        {
+            counters.push_back({name, value});
+        }
+
+        // Something the benchmark relies on being right (e.g. parallel results matching serial ones),
+        // a failed check makes the whole run fail
+        void Check(std::string name, bool isPassing)
+        {
+            if (!isPassing)
+            {
+                failedChecks.push_back(name);
+            }
+        }
+
+        inline int GetIterations() { return iterations; }
+        inline double GetElapsedMs() { return elapsedMs; }
+        inline const std::vector<std::pair<std::string, double>>& GetCounters() { return counters; }
+        inline const std::vector<std::string>& GetFailedChecks() { return failedChecks; }
+    };
+
+    typedef void (*BenchFunction)(BenchState& state);
+
+    struct BenchEntry
+    {
+        const char* name;
+        BenchFunction function;
+        int iterations;
+    };
+
+    inline std::vector<BenchEntry>& GetBenchRegistry()
+    {
+        static std::vector<BenchEntry> registry;
+        return registry;
+    }
+
+    inline bool RegisterBench(const char* name, BenchFunction function, int iterations)
+    {
+        GetBenchRegistry().push_back({name, function, iterations});
+        return true;
+    }
+
+    // Keeps the optimizer from throwing away results that are never read
+    template <typename T>
+    inline void DoNotOptimize(const T& value)
+    {
+        asm volatile("" : : "r,m"(value) : "memory");
+    }
+
+    // The number of heap allocations made by the whole program so far (see allocations.cpp)
+    size_t GetAllocationCount();
+}
+
+// Registers a benchmark function to be run by astrocore_bench
+#define ASTRO_BENCH(function, iterations) \
+    static bool function##_registered = ::AstrocoreBench::RegisterBench(#function, function, iterations);
+
+#endif // !BENCH
@@ -0,0 +1,19 @@
+# Writes the current commit to OUTPUT as ASTROCORE_BENCH_COMMIT, for bench/main.cpp.
+# Run at build time: cmake -DSOURCE_DIR=<repo> -DOUTPUT=<header> -P commitstamp.cmake
+execute_process(COMMAND git rev-parse --short HEAD
+    WORKING_DIRECTORY ${SOURCE_DIR}
+    OUTPUT_VARIABLE COMMIT
+    OUTPUT_STRIP_TRAILING_WHITESPACE
+    ERROR_QUIET)
+if(NOT COMMIT)
+    set(COMMIT "unknown")
+endif()
+
+set(CONTENTS "#define ASTROCORE_BENCH_COMMIT \"${COMMIT}\"\n")
+if(EXISTS ${OUTPUT})
+    file(READ ${OUTPUT} EXISTING)
+endif()
+# Leave the file alone when nothing changed, so the bench isn't rebuilt every time
+if(NOT "${EXISTING}" STREQUAL "${CONTENTS}")
+    file(WRITE ${OUTPUT} "${CONTENTS}")
+endif()
@@ -0,0 +1,122 @@
+#include "bench.h"
+#include "../include/astrocore/nodes/shapenode.h"
+
+using namespace Astrocore;
+using namespace AstrocoreBench;
+
+static const int MAP_NODE_COUNT = 50000;
+static const float MAP_SIZE = 20000.0f;
+
+// A big scrolling map: lots of small shapes spread out, and a camera-sized view moving across it
+static void BM_CullingScrollingMap(BenchState& state)
+{
+    SceneTree tree;
+    Node* root = new Node("map");
+    root->EnterTree(&tree);
+
+    std::vector<ShapeNode*> movers;
+    for (int i = 0; i < MAP_NODE_COUNT; i++)
+    {
+        ShapeNode* node = new ShapeNode(Shape().AsRect(8, 8).SetFilled(true));
+        // Deterministic scatter
+        float x = (float)(((int64_t)i * 7919) % 10007) / 10007.0f * MAP_SIZE;
+        float y = (float)(((int64_t)i * 104729) % 10009) / 10009.0f * MAP_SIZE;
+        node->GetTransform()->SetPosition({x, y});
+        root->AddChild(node);
+        if (i % 500 == 0)
+        {
+            movers.push_back(node);
+        }
+    }
+    tree.PropagateTransforms();
+    tree.UpdateSpatialIndex();
+
+    std::vector<TreeNode*> visible;
+    size_t visibleTotal = 0;
+    float cameraX = 0;
+    while (state.KeepRunning())
+    {
+        for (ShapeNode* mover : movers)
+        {
+            mover->GetTransform()->Translate({3, 1});
+        }
+        tree.PropagateTransforms();
+        tree.UpdateSpatialIndex();
+
+        cameraX += 16;
+        visible.clear();
+        tree.QueryVisible({cameraX, MAP_SIZE / 2, 1280, 720}, &visible);
+        visibleTotal += visible.size();
+    }
+
+    state.SetCounter("nodes in scene", MAP_NODE_COUNT + 1);
+    state.SetCounter("visible per frame", visibleTotal / state.GetIterations());
+    delete root;
+}
+ASTRO_BENCH(BM_CullingScrollingMap, 500)
+
+// Four targets over one scene: the main view, a minimap, a UI overlay and a
+// main view with the overlay on top. Each only visits the layers it draws.
+static const uint32_t LAYER_WORLD = 1 << 0;
+static const uint32_t LAYER_MINIMAP = 1 << 1;
+static const uint32_t LAYER_UI = 1 << 2;
+
+static void BM_CullingLayeredTargets(BenchState& state)
+{
+    SceneTree tree;
+    Node* root = new Node("map");
+    root->EnterTree(&tree);
+
+    for (int i = 0; i < MAP_NODE_COUNT; i++)
+    {
+        ShapeNode* node = new ShapeNode(Shape().AsRect(8, 8).SetFilled(true));
+        float x = (float)(((int64_t)i * 7919) % 10007) / 10007.0f * MAP_SIZE;
+        float y = (float)(((int64_t)i * 104729) % 10009) / 10009.0f * MAP_SIZE;
+        node->GetTransform()->SetPosition({x, y});
+        node->SetLayerMask(i % 100 == 0 ? LAYER_WORLD | LAYER_MINIMAP : LAYER_WORLD);
+        root->AddChild(node);
+    }
+    for (int i = 0; i < 200; i++)
+    {
+        ShapeNode* node = new ShapeNode(Shape().AsRect(32, 16).SetFilled(true));
+        node->GetTransform()->SetPosition({(float)(i % 20) * 64, (float)(i / 20) * 32});
+        node->SetLayerMask(LAYER_UI);
+        root->AddChild(node);
+    }
+    tree.PropagateTransforms();
+    tree.UpdateSpatialIndex();
+
+    struct TargetView
+    {
+        Rectangle area;
+        uint32_t cullMask;
+    };
+    TargetView views[4] = {
+        {{0, MAP_SIZE / 2, 1280, 720}, LAYER_WORLD},
+        {{0, 0, MAP_SIZE, MAP_SIZE}, LAYER_MINIMAP},
+        {{0, 0, 1280, 720}, LAYER_UI},
+        {{0, MAP_SIZE / 2, 1280, 720}, LAYER_WORLD | LAYER_UI}};
+
+    std::vector<TreeNode*> visible;
+    size_t visibleTotal = 0;
+    float cameraX = 0;
+    while (state.KeepRunning())
+    {
+        cameraX += 16;
+        for (TargetView& view : views)
+        {
+            if (view.area.width < MAP_SIZE)
+            {
+                view.area.x = cameraX;
+            }
+            visible.clear();
+            tree.QueryVisible(view.area, &visible, view.cullMask);
+            visibleTotal += visible.size();
+        }
+    }
+
+    state.SetCounter("nodes in scene", MAP_NODE_COUNT + 201);
+    state.SetCounter("returned per frame (4 targets)", visibleTotal / state.GetIterations());
+    delete root;
+}
+ASTRO_BENCH(BM_CullingLayeredTargets, 500)
@@ -0,0 +1,67 @@
+#include "bench.h"
+#include "../include/astrocore/nodes/shapenode.h"
+#include "../include/astrocore/systems/rendering/renderer.h"
+#include "../include/astrocore/systems/rendering/nullrenderbackend.h"
+
+using namespace Astrocore;
+using namespace AstrocoreBench;
+
+static const int SHAPE_COUNT = 20000;
+static const float WORLD_SIZE = 4000.0f;
+
+// A whole frame (update, transforms, culling, sorting, batching) with nothing behind the draw calls
+static void BM_HeadlessFullFrame(BenchState& state)
+{
+    RenderBackend* previousBackend = RenderBackend::GetCurrent();
+    NullRenderBackend* backend = new NullRenderBackend();
+    Renderer* renderer = new Renderer(backend);
+    renderer->SetFinalTargetDimensions(1280, 720);
+
+    SceneTree tree;
+    Node* root = new Node("root");
+    root->EnterTree(&tree);
+    std::vector<ShapeNode*> shapes;
+    for (int i = 0; i < SHAPE_COUNT; i++)
+    {
+        ShapeNode* node = new ShapeNode(i % 2 == 0 ? Shape().AsCircle(6, 12).SetFilled(true) : Shape().AsRect(10, 10).SetFilled(false));
+        float x = (float)(((int64_t)i * 7919) % 10007) / 10007.0f * WORLD_SIZE - WORLD_SIZE / 2;
+        float y = (float)(((int64_t)i * 104729) % 10009) / 10009.0f * WORLD_SIZE - WORLD_SIZE / 2;
+        node->GetTransform()->SetPosition({x, y});
+        node->SetZIndex(i % 4);
+        root->AddChild(node);
+        shapes.push_back(node);
+    }
+
+    size_t allocationsBefore = 0;
+    while (state.KeepRunning())
+    {
+        for (size_t i = 0; i < shapes.size(); i += 10)
+        {
+            shapes[i]->GetTransform()->Translate({1, 0});
+        }
+        root->Update(1.0f / 60.0f);
+        tree.PropagateTransforms();
+        tree.UpdateSpatialIndex();
+        renderer->Render(&tree);
+
+        // The first frame sizes every buffer
+        if (backend->GetFrameCount() == 1)
+        {
+            allocationsBefore = GetAllocationCount();
+        }
+    }
+
+    uint64_t frameVertices = 0;
+    for (const RecordedDraw& draw : backend->GetDraws())
+    {
+        frameVertices += draw.triangleVertexCount + draw.lineVertexCount;
+    }
+    state.SetCounter("vertices per frame", frameVertices);
+    state.SetCounter("draw calls per frame", backend->GetDraws().size());
+    state.SetCounter("allocations after first frame", GetAllocationCount() - allocationsBefore);  // Mostly movers reaching new grid cells
+
+    delete root;
+    delete renderer;
+    RenderBackend::SetCurrent(previousBackend);
+}
+ASTRO_BENCH(BM_HeadlessFullFrame, 200)
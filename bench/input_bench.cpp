@@ -0,0 +1,148 @@
+#include "bench.h"
+#include "../include/astrocore/systems/input/input.h"
+#include <map>
+
+using namespace Astrocore;
+using namespace AstrocoreBench;
+
+static const int ACTION_COUNT = 32;
+static const int BINDINGS_PER_ACTION = 3;
+static const int QUERIES_PER_FRAME = 2000;  // e.g. lots of nodes checking input in their Update()
+
+static std::string ActionName(int action)
+{
+    return "action_" + std::to_string(action);
+}
+
+static void BindActions(SimulatedInputBackend& backend)
+{
+    for (int action = 0; action < ACTION_COUNT; action++)
+    {
+        Input::AddBinding(ActionName(action), InputAction(KEYBOARD, 32 + action));
+        Input::AddBinding(ActionName(action), InputAction(MOUSE_BUTTON, action % 3));
+        Input::AddBinding(ActionName(action), InputAction(JOY_BUTTON, action % 16, 0));
+    }
+    // Some of everything held, on every kind of device
+    for (int action = 0; action < ACTION_COUNT; action += 4)
+    {
+        backend.SetKeyDown(32 + action, true);
+        backend.SetGamepadButtonDown(0, (action + 1) % 16, true);
+    }
+    Input::SetBackend(&backend);
+}
+
+// The old lookup: a map search, a copy of the bindings, and a device poll per query
+// (checking every binding, rather than just the first like it used to)
+class MapInput
+{
+public:
+    std::map<std::string, std::vector<InputAction>> bindings;
+    InputBackend* backend;
+
+    bool IsActionHeld(std::string actionName)
+    {
+        if (bindings.find(actionName) != bindings.end())
+        {
+            std::vector<InputAction> actions = bindings.at(actionName);
+            for (InputAction action : actions)
+            {
+                bool isDown = false;
+                switch (action.type)
+                {
+                case KEYBOARD:
+                    isDown = backend->IsKeyDown(action.id);
+                    break;
+                case MOUSE_BUTTON:
+                    isDown = backend->IsMouseButtonDown(action.id);
+                    break;
+                case JOY_BUTTON:
+                    isDown = backend->IsGamepadButtonDown(action.deviceID, action.id);
+                    break;
+                default:
+                    break;
+                }
+                if (isDown)
+                {
+                    return true;
+                }
+            }
+        }
+        return false;
+    }
+};
+
+static void BM_InputMapLookup(BenchState& state)
+{
+    SimulatedInputBackend backend;
+    BindActions(backend);
+    MapInput input;
+    input.backend = &backend;
+    std::vector<std::string> names;
+    for (int action = 0; action < ACTION_COUNT; action++)
+    {
+        names.push_back(ActionName(action));
+        input.bindings[names.back()] = Input::GetAllActions(names.back());
+    }
+
+    size_t held = 0;
+    while (state.KeepRunning())
+    {
+        for (int i = 0; i < QUERIES_PER_FRAME; i++)
+        {
+            held += input.IsActionHeld(names[i % ACTION_COUNT]) ? 1 : 0;
+        }
+    }
+    state.SetCounter("held per frame", (double)held / state.GetIterations());
+    Input::SetBackend(nullptr);
+}
+ASTRO_BENCH(BM_InputMapLookup, 200)
+
+static void BM_InputSnapshotByName(BenchState& state)
+{
+    SimulatedInputBackend backend;
+    BindActions(backend);
+    std::vector<std::string> names;
+    for (int action = 0; action < ACTION_COUNT; action++)
+    {
+        names.push_back(ActionName(action));
+    }
+
+    size_t held = 0;
+    while (state.KeepRunning())
+    {
+        Input::Update();
+        for (int i = 0; i < QUERIES_PER_FRAME; i++)
+        {
+            held += Input::IsActionHeld(names[i % ACTION_COUNT]) ? 1 : 0;
+        }
+    }
+    state.SetCounter("held per frame", (double)held / state.GetIterations());
+    Input::SetBackend(nullptr);
+}
+ASTRO_BENCH(BM_InputSnapshotByName, 200)
+
+static void BM_InputSnapshotByID(BenchState& state)
+{
+    SimulatedInputBackend backend;
+    BindActions(backend);
+    std::vector<ActionID> ids;
+    for (int action = 0; action < ACTION_COUNT; action++)
+    {
+        ids.push_back(Input::GetActionID(ActionName(action)));
+    }
+
+    size_t held = 0;
+    size_t allocationsBefore = GetAllocationCount();
+    while (state.KeepRunning())
+    {
+        Input::Update();
+        for (int i = 0; i < QUERIES_PER_FRAME; i++)
+        {
+            held += Input::IsActionHeld(ids[i % ACTION_COUNT]) ? 1 : 0;
+        }
+    }
+    state.SetCounter("allocations per frame", (double)(GetAllocationCount() - allocationsBefore) / state.GetIterations());
+    state.SetCounter("held per frame", (double)held / state.GetIterations());
+    Input::SetBackend(nullptr);
+}
+ASTRO_BENCH(BM_InputSnapshotByID, 200)
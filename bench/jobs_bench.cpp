@@ -0,0 +1,199 @@
+#include "bench.h"
+#include "../include/astrocore/nodes/node.h"
+#include <cmath>
+
+using namespace Astrocore;
+using namespace AstrocoreBench;
+
+static const int AGENT_GROUPS = 64;
+static const int AGENTS_PER_GROUP = 32;
+static const int STEERING_ITERATIONS = 64;
+
+// Does a bit of CPU-bound "thinking" every frame, then moves, touching nothing outside itself
+class AgentNode : public Node
+{
+public:
+    float heading = 0;
+
+    void Update(float deltaTime) override
+    {
+        Vector2 position = GetTransform()->GetPosition();
+        float target = 0;
+        for (int i = 0; i < STEERING_ITERATIONS; i++)
+        {
+            target += sinf(position.x * 0.01f + i) * cosf(position.y * 0.01f - i);
+        }
+        heading += (target - heading) * deltaTime;
+        GetTransform()->SetPosition({position.x + cosf(heading) * deltaTime, position.y + sinf(heading) * deltaTime});
+        Node::Update(deltaTime);
+    }
+};
+
+static std::shared_ptr<Node> BuildAgentScene(bool isParallel)
+{
+    std::shared_ptr<Node> root = std::make_shared<Node>("agents");
+    for (int group = 0; group < AGENT_GROUPS; group++)
+    {
+        Node* groupNode = new Node();
+        groupNode->SetParallelUpdate(isParallel);
+        for (int i = 0; i < AGENTS_PER_GROUP; i++)
+        {
+            AgentNode* agent = new AgentNode();
+            agent->GetTransform()->SetPosition({(float)(group * 50), (float)(i * 10)});
+            groupNode->AddChild(agent);
+        }
+        root->AddChild(groupNode);
+    }
+    return root;
+}
+
+// The update pass of a frame, with every agent group either on the main thread or fanned out
+static double RunAgentFrames(BenchState& state, JobSystem* jobSystem)
+{
+    SceneTree tree;
+    tree.SetJobSystem(jobSystem);
+    std::shared_ptr<Node> root = BuildAgentScene(jobSystem != nullptr);
+    tree.SetCurrentScene(root);
+
+    while (state.KeepRunning())
+    {
+        tree.Update(1.0f / 60.0f);
+        tree.PropagateTransforms();
+    }
+
+    double checksum = 0;
+    for (Node* group : root->GetAllChildren())
+    {
+        for (Node* agent : group->GetAllChildren())
+        {
+            checksum += agent->GetTransform()->GetPosition().x + agent->GetTransform()->GetPosition().y;
+        }
+    }
+    state.SetCounter("agents", AGENT_GROUPS * AGENTS_PER_GROUP);
+    return checksum;
+}
+
+static void BM_AgentUpdateSerial(BenchState& state)
+{
+    DoNotOptimize(RunAgentFrames(state, nullptr));
+}
+ASTRO_BENCH(BM_AgentUpdateSerial, 200)
+
+static void BM_AgentUpdateParallel(BenchState& state)
+{
+    JobSystem jobSystem;
+    jobSystem.Start();
+    double checksum = RunAgentFrames(state, &jobSystem);
+    state.SetCounter("threads", jobSystem.GetThreadCount());
+    // The same frames run serially (untimed), the agents should have ended up in exactly the same places
+    BenchState serialState(state.GetIterations());
+    state.Check("matches serial", checksum == RunAgentFrames(serialState, nullptr));
+}
+ASTRO_BENCH(BM_AgentUpdateParallel, 200)
+
+// Moves on the main thread while every chaser group reads its world transform from a worker
+class TargetNode : public Node
+{
+public:
+    float time = 0;
+
+    void Update(float deltaTime) override
+    {
+        time += deltaTime;
+        GetTransform()->SetPosition({cosf(time) * 500, sinf(time) * 500});
+        Node::Update(deltaTime);
+    }
+};
+
+class ChaserNode : public Node
+{
+public:
+    Node* target = nullptr;
+
+    void Update(float deltaTime) override
+    {
+        // Every parallel subtree reads the same node here, build with -fsanitize=thread to check it stays race free
+        Vector2 targetPosition = target->GetWorldTransform().GetPosition();
+        Vector2 position = GetTransform()->GetPosition();
+        GetTransform()->SetPosition(Vector2Add(position, Vector2Scale(Vector2Subtract(targetPosition, position), deltaTime)));
+        Node::Update(deltaTime);
+    }
+};
+
+static double RunChaserFrames(BenchState& state, JobSystem* jobSystem)
+{
+    SceneTree tree;
+    tree.SetJobSystem(jobSystem);
+    std::shared_ptr<Node> root = std::make_shared<Node>("chasers");
+    TargetNode* target = new TargetNode();
+    root->AddChild(target);
+    for (int group = 0; group < AGENT_GROUPS; group++)
+    {
+        Node* groupNode = new Node();
+        groupNode->SetParallelUpdate(jobSystem != nullptr);
+        for (int i = 0; i < AGENTS_PER_GROUP; i++)
+        {
+            ChaserNode* chaser = new ChaserNode();
+            chaser->target = target;
+            chaser->GetTransform()->SetPosition({(float)(group * 50), (float)(i * 10)});
+            groupNode->AddChild(chaser);
+        }
+        root->AddChild(groupNode);
+    }
+    tree.SetCurrentScene(root);
+
+    while (state.KeepRunning())
+    {
+        tree.Update(1.0f / 60.0f);
+        tree.PropagateTransforms();
+    }
+
+    double checksum = 0;
+    for (Node* group : root->GetAllChildren())
+    {
+        for (Node* chaser : group->GetAllChildren())
+        {
+            checksum += chaser->GetTransform()->GetPosition().x + chaser->GetTransform()->GetPosition().y;
+        }
+    }
+    state.SetCounter("chasers", AGENT_GROUPS * AGENTS_PER_GROUP);
+    return checksum;
+}
+
+static void BM_SharedTargetSerial(BenchState& state)
+{
+    DoNotOptimize(RunChaserFrames(state, nullptr));
+}
+ASTRO_BENCH(BM_SharedTargetSerial, 200)
+
+static void BM_SharedTargetParallel(BenchState& state)
+{
+    JobSystem jobSystem;
+    jobSystem.Start();
+    double checksum = RunChaserFrames(state, &jobSystem);
+    state.SetCounter("threads", jobSystem.GetThreadCount());
+    BenchState serialState(state.GetIterations());
+    state.Check("matches serial", checksum == RunChaserFrames(serialState, nullptr));
+}
+ASTRO_BENCH(BM_SharedTargetParallel, 200)
+
+// Scheduling overhead: lots of jobs that do next to nothing
+static void BM_JobSystemEmptyJobs(BenchState& state)
+{
+    JobSystem jobSystem;
+    jobSystem.Start();
+    std::vector<int> values(10000);
+    while (state.KeepRunning())
+    {
+        jobSystem.ParallelFor(values.size(), 16, [&values](size_t begin, size_t end)
+        {
+            for (size_t i = begin; i < end; i++)
+            {
+                values[i]++;
+            }
+        });
+    }
+    DoNotOptimize(values[0]);
+    state.SetCounter("jobs per iteration", values.size() / 16);
+}
+ASTRO_BENCH(BM_JobSystemEmptyJobs, 200)
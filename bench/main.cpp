@@ -0,0 +1,202 @@
+#include "bench.h"
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <ctime>
+#include <fstream>
+#include <map>
+#include <string>
+
+using namespace AstrocoreBench;
+
+// Generated by the build (see bench/commitstamp.cmake), so it's the commit being built rather than the one configured
+#if __has_include("bench_commit.h")
+#include "bench_commit.h"
+#endif
+#ifndef ASTROCORE_BENCH_COMMIT
+#define ASTROCORE_BENCH_COMMIT "unknown"
+#endif
+
+struct BenchResult
+{
+    std::string name;
+    int iterations;
+    double totalMs;
+    std::vector<std::pair<std::string, double>> counters;
+};
+
+static std::string EscapeJson(const std::string& text)
+{
+    std::string escaped;
+    for (char c : text)
+    {
+        if (c == '"' || c == '\\')
+        {
+            escaped += '\\';
+        }
+        escaped += c;
+    }
+    return escaped;
+}
+
+// JSON has no NaN or infinity, those are written as null
+static void WriteJsonNumber(FILE* file, const char* format, double value)
+{
+    if (std::isfinite(value))
+    {
+        fprintf(file, format, value);
+    }
+    else
+    {
+        fprintf(file, "null");
+    }
+}
+
+// One benchmark per line, in registration order, so results from two commits diff cleanly
+static bool WriteJson(const char* path, const std::vector<BenchResult>& results)
+{
+    FILE* file = fopen(path, "w");
+    if (file == nullptr)
+    {
+        fprintf(stderr, "Couldn't open %s for writing\n", path);
+        return false;
+    }
+
+    char date[32];
+    time_t now = time(nullptr);
+    strftime(date, sizeof(date), "%Y-%m-%dT%H:%M:%SZ", gmtime(&now));
+    fprintf(file, "{\n  \"commit\": \"%s\",\n  \"date\": \"%s\",\n  \"benchmarks\": [\n", ASTROCORE_BENCH_COMMIT, date);
+    for (size_t i = 0; i < results.size(); i++)
+    {
+        const BenchResult& result = results[i];
+        fprintf(file, "    {\"name\": \"%s\", \"iterations\": %d, \"total_ms\": ", EscapeJson(result.name).c_str(), result.iterations);
+        WriteJsonNumber(file, "%.4f", result.totalMs);
+        fprintf(file, ", \"ms_per_iter\": ");
+        WriteJsonNumber(file, "%.6f", result.totalMs / result.iterations);
+        fprintf(file, ", \"counters\": {");
+        for (size_t c = 0; c < result.counters.size(); c++)
+        {
+            fprintf(file, "%s\"%s\": ", c > 0 ? ", " : "", EscapeJson(result.counters[c].first).c_str());
+            WriteJsonNumber(file, "%.6g", result.counters[c].second);
+        }
+        fprintf(file, "}}%s\n", i + 1 < results.size() ? "," : "");
+    }
+    fprintf(file, "  ]\n}\n");
+    fclose(file);
+    return true;
+}
+
+// Reads back the ms/iter of every benchmark in a file written by WriteJson()
+static bool ReadBaseline(const char* path, std::map<std::string, double>* msPerIter)
+{
+    std::ifstream file(path);
+    if (!file)
+    {
+        fprintf(stderr, "Couldn't open baseline %s\n", path);
+        return false;
+    }
+
+    std::string line;
+    while (std::getline(file, line))
+    {
+        size_t nameStart = line.find("\"name\": \"");
+        size_t timeStart = line.find("\"ms_per_iter\": ");
+        if (nameStart == std::string::npos || timeStart == std::string::npos)
+        {
+            continue;
+        }
+        nameStart += strlen("\"name\": \"");
+        size_t nameEnd = line.find('"', nameStart);
+        (*msPerIter)[line.substr(nameStart, nameEnd - nameStart)] = atof(line.c_str() + timeStart + strlen("\"ms_per_iter\": "));
+    }
+    return true;
+}
+
+// Usage: astrocore_bench [--json results.json] [--baseline old.json] [--threshold percent] [name filter]
+// With a baseline, every benchmark's change is printed, and the exit code is 1 if any got
+// slower by more than the threshold (10% by default). It's also 1 if any benchmark's checks failed
+int main(int argc, char** argv)
+{
+    const char* filter = nullptr;
+    const char* jsonPath = nullptr;
+    const char* baselinePath = nullptr;
+    double threshold = 10.0;
+    for (int i = 1; i < argc; i++)
+    {
+        if (strcmp(argv[i], "--json") == 0 && i + 1 < argc)
+        {
+            jsonPath = argv[++i];
+        }
+        else if (strcmp(argv[i], "--baseline") == 0 && i + 1 < argc)
+        {
+            baselinePath = argv[++i];
+        }
+        else if (strcmp(argv[i], "--threshold") == 0 && i + 1 < argc)
+        {
+            threshold = atof(argv[++i]);
+        }
+        else
+        {
+            filter = argv[i];
+        }
+    }
+
+    std::map<std::string, double> baseline;
+    if (baselinePath != nullptr && !ReadBaseline(baselinePath, &baseline))
+    {
+        return 2;
+    }
+
+    std::vector<BenchResult> results;
+    int regressions = 0;
+    int failedChecks = 0;
+    printf("%-40s %10s %12s %12s\n", "benchmark", "iterations", "total ms", "ms/iter");
+    for (BenchEntry& entry : GetBenchRegistry())
+    {
+        if (filter != nullptr && strstr(entry.name, filter) == nullptr)
+        {
+            continue;
+        }
+
+        BenchState state(entry.iterations);
+        entry.function(state);
+        double msPerIter = state.GetElapsedMs() / state.GetIterations();
+
+        printf("%-40s %10d %12.3f %12.5f", entry.name, state.GetIterations(), state.GetElapsedMs(), msPerIter);
+        std::map<std::string, double>::iterator previous = baseline.find(entry.name);
+        if (previous != baseline.end() && previous->second > 0)
+        {
+            double change = (msPerIter - previous->second) / previous->second * 100.0;
+            bool isRegression = change > threshold;
+            regressions += isRegression ? 1 : 0;
+            printf("   %+7.1f%%%s", change, isRegression ? "  REGRESSION" : "");
+        }
+        printf("\n");
+        for (auto& counter : state.GetCounters())
+        {
+            printf("    %-36s %.0f\n", counter.first.c_str(), counter.second);
+        }
+        for (const std::string& check : state.GetFailedChecks())
+        {
+            printf("    %-36s FAILED\n", check.c_str());
+        }
+        failedChecks += state.GetFailedChecks().size();
+
+        results.push_back({entry.name, state.GetIterations(), state.GetElapsedMs(), state.GetCounters()});
+    }
+
+    if (jsonPath != nullptr && !WriteJson(jsonPath, results))
+    {
+        return 2;
+    }
+    if (failedChecks > 0)
+    {
+        printf("%d check(s) failed\n", failedChecks);
+    }
+    if (regressions > 0)
+    {
+        printf("%d benchmark(s) more than %.0f%% slower than the baseline\n", regressions, threshold);
+    }
+    return failedChecks > 0 || regressions > 0 ? 1 : 0;
+}
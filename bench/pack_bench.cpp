@@ -0,0 +1,186 @@
+#include "bench.h"
+#include "../include/astrocore/systems/packfile.h"
+#include <cstdio>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <iterator>
+#include <string>
+
+using namespace Astrocore;
+using namespace AstrocoreBench;
+namespace fs = std::filesystem;
+
+static const int PACK_FILE_COUNT = 2000;
+static const int PACK_FILE_SIZE = 4096;
+
+// Lots of small assets (configs, sprite sheets' metadata, level chunks), loose and in a pack of each kind
+struct PackBenchAssets
+{
+    fs::path directory;
+    std::vector<std::string> paths;
+
+    PackBenchAssets()
+    {
+        directory = fs::temp_directory_path() / "astrocore_pack_bench";
+        fs::create_directories(directory);
+        PackWriter stored, lz4, zstd;
+        std::string contents;
+        for (int i = 0; i < PACK_FILE_COUNT; i++)
+        {
+            std::string path = "assets/" + std::to_string(i % 20) + "/asset" + std::to_string(i) + ".json";
+            contents.clear();
+            while ((int)contents.size() < PACK_FILE_SIZE)
+            {
+                contents += "{\"id\": " + std::to_string(i) + ", \"offset\": " + std::to_string(contents.size() * 7 % 1000) + "},\n";
+            }
+            fs::path loose = directory / path;
+            fs::create_directories(loose.parent_path());
+            std::ofstream(loose, std::ios::binary).write(contents.data(), contents.size());
+            stored.AddData(path, contents.data(), contents.size(), PACK_STORED);
+            lz4.AddData(path, contents.data(), contents.size(), PACK_LZ4);
+            zstd.AddData(path, contents.data(), contents.size(), PACK_ZSTD);
+            paths.push_back(path);
+        }
+        stored.Write((directory / "stored.apak").string());
+        lz4.Write((directory / "lz4.apak").string());
+        zstd.Write((directory / "zstd.apak").string());
+    }
+
+    ~PackBenchAssets()
+    {
+        std::error_code error;
+        fs::remove_all(directory, error);
+    }
+};
+
+// One open/read/close per asset, the way they're loaded without a pack
+static void BM_PackLooseFiles(BenchState& state)
+{
+    PackBenchAssets assets;
+    std::vector<std::string> loosePaths;
+    for (const std::string& path : assets.paths)
+    {
+        loosePaths.push_back((assets.directory / path).string());
+    }
+    size_t bytes = 0;
+    while (state.KeepRunning())
+    {
+        for (const std::string& path : loosePaths)
+        {
+            int dataSize = 0;
+            unsigned char* data = LoadFileData(path.c_str(), &dataSize);
+            bytes += dataSize;
+            UnloadFileData(data);
+        }
+    }
+    state.SetCounter("files per ms", PACK_FILE_COUNT * (double)state.GetIterations() / state.GetElapsedMs());
+    state.SetCounter("MB read", bytes / (1024.0 * 1024.0));
+}
+ASTRO_BENCH(BM_PackLooseFiles, 20)
+
+// Opening the pack and looking at every asset in place
+static void BM_PackStoredViews(BenchState& state)
+{
+    PackBenchAssets assets;
+    std::string packPath = (assets.directory / "stored.apak").string();
+    size_t checksum = 0;
+    bool isOpen = true;
+    bool isFound = true;
+    while (state.KeepRunning())
+    {
+        PackFile pack;
+        isOpen = isOpen && pack.Open(packPath);
+        for (size_t i = 0; isOpen && isFound && i < assets.paths.size(); i++)
+        {
+            PackView view = pack.GetView(assets.paths[i]);
+            isFound = view.data != nullptr && view.size > 0;
+            checksum += isFound ? view.size + view.data[view.size / 2] : 0;
+        }
+    }
+    state.Check("opens", isOpen);
+    state.Check("finds every asset", isFound);
+    state.SetCounter("files per ms", PACK_FILE_COUNT * (double)state.GetIterations() / state.GetElapsedMs());
+    state.SetCounter("checksum", (double)(checksum % 1000));
+}
+ASTRO_BENCH(BM_PackStoredViews, 20)
+
+static void RunPackReads(BenchState& state, const char* packName)
+{
+    PackBenchAssets assets;
+    std::string packPath = (assets.directory / packName).string();
+    std::vector<unsigned char> data;
+    uint64_t size = 0;
+    uint64_t storedSize = 0;
+    bool isOpen = true;
+    bool isRead = true;
+    while (state.KeepRunning())
+    {
+        PackFile pack;
+        isOpen = isOpen && pack.Open(packPath);
+        size = 0;
+        storedSize = 0;
+        for (size_t i = 0; isOpen && isRead && i < assets.paths.size(); i++)
+        {
+            const PackFileEntry* entry = pack.Find(assets.paths[i]);
+            isRead = entry != nullptr && pack.Read(assets.paths[i], &data);
+            size += isRead ? data.size() : 0;
+            storedSize += isRead ? entry->storedSize : 0;
+        }
+    }
+    state.Check("opens", isOpen);
+    state.Check("reads every asset", isRead);
+    state.SetCounter("files per ms", PACK_FILE_COUNT * (double)state.GetIterations() / state.GetElapsedMs());
+    state.SetCounter("compression ratio", (double)size / storedSize);
+}
+
+// Opening the pack and decompressing every asset
+static void BM_PackLz4Reads(BenchState& state)
+{
+    RunPackReads(state, "lz4.apak");
+}
+ASTRO_BENCH(BM_PackLz4Reads, 20)
+
+static void BM_PackZstdReads(BenchState& state)
+{
+    RunPackReads(state, "zstd.apak");
+}
+ASTRO_BENCH(BM_PackZstdReads, 20)
+
+// Opening (and validating) the pack on its own, then making sure a corrupt entry or chunk size gets caught
+static void BM_PackOpen(BenchState& state)
+{
+    PackBenchAssets assets;
+    std::string packPath = (assets.directory / "zstd.apak").string();
+    bool isOpen = false;
+    while (state.KeepRunning())
+    {
+        PackFile pack;
+        isOpen = pack.Open(packPath);
+    }
+    state.Check("opens", isOpen);
+
+    // A size near UINT64_MAX used to wrap around when counting chunks and get past validation
+    std::ifstream input(packPath, std::ios::binary);
+    const std::vector<char> bytes((std::istreambuf_iterator<char>(input)), std::istreambuf_iterator<char>());
+    PackFileHeader header;
+    memcpy(&header, bytes.data(), sizeof(header));
+    std::string corruptPath = (assets.directory / "corrupt.apak").string();
+
+    std::vector<char> corruptBytes = bytes;
+    uint64_t corruptSize = UINT64_MAX - 1;
+    memcpy(corruptBytes.data() + header.entriesOffset + offsetof(PackFileEntry, size), &corruptSize, sizeof(corruptSize));
+    std::ofstream(corruptPath, std::ios::binary | std::ios::trunc).write(corruptBytes.data(), corruptBytes.size());
+    PackFile corrupt;
+    state.Check("rejects corrupt size", !corrupt.Open(corruptPath));
+
+    // A chunk size past INT_MAX used to reach LZ4 as a negative size, which it reports the same way as success
+    corruptBytes = bytes;
+    uint32_t corruptChunkSize = UINT32_MAX;
+    memcpy(corruptBytes.data() + offsetof(PackFileHeader, chunkSize), &corruptChunkSize, sizeof(corruptChunkSize));
+    std::ofstream(corruptPath, std::ios::binary | std::ios::trunc).write(corruptBytes.data(), corruptBytes.size());
+    state.Check("rejects corrupt chunk size", !corrupt.Open(corruptPath));
+}
+ASTRO_BENCH(BM_PackOpen, 200)
@@ -0,0 +1,105 @@
+#include "bench.h"
+#include "../include/astrocore/systems/physics/physicsworld.h"
+#include "../include/astrocore/nodes/shapenode.h"
+#include <cmath>
+
+using namespace Astrocore;
+using namespace AstrocoreBench;
+
+static const float BOX_SIZE = 10;       // Half extents
+static const float STACK_SPACING = 40;
+static const int STACK_HEIGHT = 5;
+static const float PHYSICS_STEP = 1.0f / 60.0f;
+
+// Rows of short stacks of boxes on one long floor, dropped from just above each other. Every
+// other box is slightly turned, so they have to settle rather than landing perfectly flat,
+// and each stack is its own island so they can fall asleep separately
+static void BuildStacks(PhysicsWorld& world, int bodyCount)
+{
+    int stacks = (bodyCount + STACK_HEIGHT - 1) / STACK_HEIGHT;
+    float width = stacks * STACK_SPACING;
+    float floorY = STACK_HEIGHT * BOX_SIZE * 2.5f;
+
+    BodyDef ground;
+    ground.type = BODY_STATIC;
+    ground.polygon = world.CreatePolygon(Shape().AsRect(width * 0.5f + STACK_SPACING, BOX_SIZE));
+    ground.position = {width * 0.5f, floorY + BOX_SIZE};
+    world.AddBody(ground);
+
+    PolygonID box = world.CreatePolygon(Shape().AsRect(BOX_SIZE, BOX_SIZE));
+    for (int i = 0; i < bodyCount; i++)
+    {
+        int level = i % STACK_HEIGHT;
+        BodyDef body;
+        body.polygon = box;
+        body.position = {(i / STACK_HEIGHT) * STACK_SPACING + STACK_SPACING * 0.5f, floorY - BOX_SIZE - level * BOX_SIZE * 2.2f};
+        body.angle = (level % 2) * 0.05f;
+        world.AddBody(body);
+    }
+}
+
+// The first half second after the boxes are dropped (falling, landing and settling), while they're all awake
+static void RunPhysics(BenchState& state, int bodyCount)
+{
+    PhysicsWorld world;
+    BuildStacks(world, bodyCount);
+
+    size_t pairs = 0;
+    size_t contacts = 0;
+    size_t swaps = 0;
+    while (state.KeepRunning())
+    {
+        world.Step(PHYSICS_STEP);
+        pairs += world.GetPairCount();
+        contacts += world.GetContactCount();
+        swaps += world.GetSortSwapCount();
+    }
+
+    int iterations = state.GetIterations();
+    state.SetCounter("bodies", bodyCount);
+    state.SetCounter("bodies per ms", bodyCount * (double)iterations / state.GetElapsedMs());
+    state.SetCounter("awake at end", world.GetAwakeCount());
+    state.SetCounter("pairs per step", pairs / (double)iterations);
+    state.SetCounter("contacts per step", contacts / (double)iterations);
+    state.SetCounter("sort swaps per step", swaps / (double)iterations);
+    DoNotOptimize(world.GetPosition(bodyCount / 2));
+}
+
+static void BM_Physics1k(BenchState& state)
+{
+    RunPhysics(state, 1000);
+}
+ASTRO_BENCH(BM_Physics1k, 30)
+
+static void BM_Physics10k(BenchState& state)
+{
+    RunPhysics(state, 10000);
+}
+ASTRO_BENCH(BM_Physics10k, 30)
+
+static void BM_Physics50k(BenchState& state)
+{
+    RunPhysics(state, 50000);
+}
+ASTRO_BENCH(BM_Physics50k, 30)
+
+// Stacks that have settled and fallen asleep, so only the broadphase bookkeeping is left
+static void BM_PhysicsSleeping10k(BenchState& state)
+{
+    PhysicsWorld world;
+    BuildStacks(world, 10000);
+    for (int i = 0; i < 600 && world.GetAwakeCount() > 0; i++)
+    {
+        world.Step(PHYSICS_STEP);
+    }
+
+    size_t awake = world.GetAwakeCount();
+    while (state.KeepRunning())
+    {
+        world.Step(PHYSICS_STEP);
+    }
+    state.SetCounter("bodies per ms", 10000.0 * state.GetIterations() / state.GetElapsedMs());
+    state.SetCounter("awake", awake);
+    state.SetCounter("pairs", world.GetPairCount());
+}
+ASTRO_BENCH(BM_PhysicsSleeping10k, 60)
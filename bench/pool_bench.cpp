@@ -0,0 +1,152 @@
+#include "bench.h"
+#include "../include/astrocore/nodes/shapenode.h"
+#include "../include/astrocore/systems/nodepool.h"
+
+using namespace Astrocore;
+using namespace AstrocoreBench;
+
+static const int LIVE_BULLETS = 2000;
+static const int SPAWNS_PER_FRAME = 200;
+static const int WARMUP_FRAMES = 60;
+
+// Bullets spawned and despawned every frame, in a tree.
+// Spawn takes a recycled node if there is one, so it never runs a constructor after warm-up.
+static void BM_PoolBulletChurn(BenchState& state)
+{
+    SceneTree tree;
+    Node* root = new Node("root");
+    tree.RegisterToTree(root);
+
+    NodePool<ShapeNode> pool;
+    Shape bulletShape = Shape().AsCircle(2, 8).SetFilled(true);
+    std::vector<ShapeNode*> live;
+    size_t nextDespawn = 0;
+    int frame = 0;
+
+    auto runFrame = [&]()
+    {
+        for (int i = 0; i < SPAWNS_PER_FRAME; i++)
+        {
+            ShapeNode* bullet = pool.Reuse();
+            if (bullet == nullptr)
+            {
+                bullet = pool.Create(bulletShape);
+            }
+            bullet->GetTransform()->SetPosition({(float)(((frame % 10) * 37 + i * 11) % 2000), (float)(i * 5)});
+            root->AddChild(bullet);
+
+            if ((int)live.size() < LIVE_BULLETS)
+            {
+                live.push_back(bullet);
+            }
+            else
+            {
+                // Oldest bullet goes back to the pool
+                pool.Recycle(live[nextDespawn]);
+                live[nextDespawn] = bullet;
+                nextDespawn = (nextDespawn + 1) % LIVE_BULLETS;
+            }
+        }
+        for (ShapeNode* bullet : live)
+        {
+            bullet->GetTransform()->Translate({0, 4});
+        }
+        tree.PropagateTransforms();
+        tree.UpdateSpatialIndex();
+        frame++;
+    };
+
+    for (int i = 0; i < WARMUP_FRAMES; i++)
+    {
+        runFrame();
+    }
+
+    size_t allocationsBefore = GetAllocationCount();
+    while (state.KeepRunning())
+    {
+        runFrame();
+    }
+    size_t allocations = GetAllocationCount() - allocationsBefore;
+
+    state.SetCounter("spawns per frame", SPAWNS_PER_FRAME);
+    state.SetCounter("allocations (steady state)", allocations);
+    state.SetCounter("pool capacity", pool.GetCapacity());
+
+    // Bullets still parented to root are pooled, so they have to go before it
+    root->ExitTree();
+    for (ShapeNode* bullet : live)
+    {
+        root->RemoveChild(bullet);
+    }
+    pool.DestroyAll();
+    delete root;
+}
+ASTRO_BENCH(BM_PoolBulletChurn, 200)
+
+// Allocations per node when creating them with new versus from a warmed up pool
+static void BM_PoolCreateDestroy(BenchState& state)
+{
+    const int count = 10000;
+    std::vector<Node*> nodes(count);
+    NodePool<Node> pool;
+
+    // Warm the pool up to its peak size
+    for (int i = 0; i < count; i++)
+    {
+        nodes[i] = pool.Create();
+    }
+    pool.DestroyAll();
+
+    size_t allocationsBefore = GetAllocationCount();
+    while (state.KeepRunning())
+    {
+        for (int i = 0; i < count; i++)
+        {
+            nodes[i] = pool.Create();
+        }
+        for (int i = 0; i < count; i++)
+        {
+            pool.Destroy((Node*)nodes[i]);
+        }
+    }
+    size_t pooledAllocations = GetAllocationCount() - allocationsBefore;
+
+    allocationsBefore = GetAllocationCount();
+    for (int i = 0; i < count; i++)
+    {
+        nodes[i] = new Node();
+    }
+    for (int i = 0; i < count; i++)
+    {
+        delete nodes[i];
+    }
+    size_t heapAllocations = GetAllocationCount() - allocationsBefore;
+
+    state.SetCounter("allocations per pooled node", (double)pooledAllocations / ((size_t)count * state.GetIterations()));
+    state.SetCounter("allocations per new node", (double)heapAllocations / count);
+}
+ASTRO_BENCH(BM_PoolCreateDestroy, 100)
+
+// Tearing down a whole pooled scene at once versus deleting it node by node
+static void BM_PoolSceneTeardown(BenchState& state)
+{
+    const int count = 20000;
+    NodePool<Node> nodePool;
+    NodePool<ShapeNode> shapePool;
+    Shape shape = Shape().AsRect(4, 4);
+
+    while (state.KeepRunning())
+    {
+        Node* root = nodePool.Create("root");
+        for (int i = 0; i < count; i++)
+        {
+            Node* group = nodePool.Create();
+            root->AddChild(group);
+            group->AddChild(shapePool.Create(shape));
+        }
+        nodePool.DestroyAll();
+        shapePool.DestroyAll();
+    }
+    state.SetCounter("nodes per scene", count * 2 + 1);
+}
+ASTRO_BENCH(BM_PoolSceneTeardown, 20)
@@ -0,0 +1,26 @@
+#include "bench.h"
+#include "../include/astrocore/systems/profiler.h"
+
+using namespace Astrocore;
+using namespace AstrocoreBench;
+
+static const int ZONES_PER_FRAME = 5000;
+
+// The cost of instrumenting: a frame of nested zones, then collecting them at the end of the frame
+// (uses ProfileZone directly, so it measures the same thing with or without ASTROCORE_PROFILING)
+static void BM_ProfilerZones(BenchState& state)
+{
+    while (state.KeepRunning())
+    {
+        for (int i = 0; i < ZONES_PER_FRAME / 2; i++)
+        {
+            ProfileZone outer("BenchOuter");
+            ProfileZone inner("BenchInner");
+            DoNotOptimize(i);
+        }
+        Profiler::EndFrame();
+    }
+    state.SetCounter("zones per frame", ZONES_PER_FRAME);
+    state.SetCounter("ns per zone", state.GetElapsedMs() * 1000000.0 / ((double)state.GetIterations() * ZONES_PER_FRAME));
+}
+ASTRO_BENCH(BM_ProfilerZones, 200)
@@ -0,0 +1,198 @@
+#include "bench.h"
+#include "../include/astrocore/nodes/shapenode.h"
+#include <cmath>
+
+using namespace Astrocore;
+using namespace AstrocoreBench;
+
+static const int QUERY_NODE_COUNT = 20000;
+static const float QUERY_MAP_SIZE = 20000.0f;
+static const int RAYS_PER_FRAME = 512;
+static const float RAY_LENGTH = 600.0f;
+
+// Lots of small boxes scattered over a big map
+static Node* BuildQueryScene(SceneTree& tree, std::vector<ShapeNode*>* nodes)
+{
+    Node* root = new Node("map");
+    root->EnterTree(&tree);
+    for (int i = 0; i < QUERY_NODE_COUNT; i++)
+    {
+        ShapeNode* node = new ShapeNode(Shape().AsRect(12, 12).SetFilled(true));
+        float x = (float)(((int64_t)i * 7919) % 10007) / 10007.0f * QUERY_MAP_SIZE;
+        float y = (float)(((int64_t)i * 104729) % 10009) / 10009.0f * QUERY_MAP_SIZE;
+        node->GetTransform()->SetPosition({x, y});
+        root->AddChild(node);
+        nodes->push_back(node);
+    }
+    tree.PropagateTransforms();
+    tree.UpdateSpatialIndex();
+    return root;
+}
+
+// AI agents looking around: rays fanning out from points spread across the map
+static void BuildRays(std::vector<RayQuery>* rays, int frame)
+{
+    rays->clear();
+    for (int i = 0; i < RAYS_PER_FRAME; i++)
+    {
+        float angle = (i * 0.618f + frame * 0.05f) * 2.0f * PI;
+        float x = (float)(((int64_t)(i + frame) * 4253) % 10007) / 10007.0f * QUERY_MAP_SIZE;
+        float y = (float)(((int64_t)(i + frame) * 6113) % 10009) / 10009.0f * QUERY_MAP_SIZE;
+        rays->push_back({{x, y}, {cosf(angle), sinf(angle)}, RAY_LENGTH});
+    }
+}
+
+// A batch of rays a frame, while 1% of the scene moves (so the tree is being refit too)
+static void BM_QueryRaycastBatch(BenchState& state)
+{
+    SceneTree tree;
+    std::vector<ShapeNode*> nodes;
+    Node* root = BuildQueryScene(tree, &nodes);
+    const SceneQuery& query = tree.GetQuery();
+    std::vector<ShapeNode*> movers;
+    for (size_t i = 0; i < nodes.size(); i += 100)
+    {
+        movers.push_back(nodes[i]);
+    }
+
+    std::vector<RayQuery> rays;
+    std::vector<QueryHit> hits(RAYS_PER_FRAME);
+    size_t hitCount = 0;
+    int frame = 0;
+    while (state.KeepRunning())
+    {
+        for (ShapeNode* mover : movers)
+        {
+            mover->GetTransform()->Translate({2, 1});
+        }
+        tree.PropagateTransforms();
+        tree.UpdateSpatialIndex();
+
+        BuildRays(&rays, frame++);
+        query.RaycastBatch(rays.data(), rays.size(), hits.data());
+        for (const QueryHit& hit : hits)
+        {
+            hitCount += hit.node != nullptr;
+        }
+    }
+
+    state.SetCounter("rays per ms", RAYS_PER_FRAME * (double)state.GetIterations() / state.GetElapsedMs());
+    state.SetCounter("hit rate", hitCount / (double)(RAYS_PER_FRAME * state.GetIterations()));
+    state.SetCounter("tree height", query.GetTreeHeight());
+    state.SetCounter("reinserts", query.GetReinsertCount());
+    delete root;
+}
+ASTRO_BENCH(BM_QueryRaycastBatch, 200)
+
+// The same rays tested against every node, for comparison
+static void BM_QueryRaycastBruteForce(BenchState& state)
+{
+    SceneTree tree;
+    std::vector<ShapeNode*> nodes;
+    Node* root = BuildQueryScene(tree, &nodes);
+
+    std::vector<RayQuery> rays;
+    size_t hitCount = 0;
+    int frame = 0;
+    while (state.KeepRunning())
+    {
+        BuildRays(&rays, frame++);
+        for (const RayQuery& ray : rays)
+        {
+            // Slab test against every node's bounds, then keep the closest
+            float closest = ray.maxDistance;
+            bool isHit = false;
+            for (ShapeNode* node : nodes)
+            {
+                Rectangle bounds;
+                node->GetWorldBounds(&bounds);
+                float entry = AabbTree::RayEntry(AabbTree::FromRectangle(bounds), ray.origin,
+                    1.0f / ray.direction.x, 1.0f / ray.direction.y, closest);
+                if (entry <= closest)
+                {
+                    closest = entry;
+                    isHit = true;
+                }
+            }
+            hitCount += isHit;
+        }
+    }
+
+    state.SetCounter("rays per ms", RAYS_PER_FRAME * (double)state.GetIterations() / state.GetElapsedMs());
+    state.SetCounter("hit rate", hitCount / (double)(RAYS_PER_FRAME * state.GetIterations()));
+    delete root;
+}
+ASTRO_BENCH(BM_QueryRaycastBruteForce, 3)
+
+// Rays straight along an axis (bullets, line of sight along a corridor), which only have to look at
+// the boxes in their band, then making sure a box just past the ray's band isn't counted as hit
+static void BM_QueryAxisAlignedRays(BenchState& state)
+{
+    SceneTree tree;
+    std::vector<ShapeNode*> nodes;
+    Node* root = BuildQueryScene(tree, &nodes);
+    const SceneQuery& query = tree.GetQuery();
+
+    std::vector<RayQuery> rays;
+    std::vector<QueryHit> hits(RAYS_PER_FRAME);
+    size_t hitCount = 0;
+    int frame = 0;
+    while (state.KeepRunning())
+    {
+        rays.clear();
+        for (int i = 0; i < RAYS_PER_FRAME; i++)
+        {
+            float x = (float)(((int64_t)(i + frame) * 4253) % 10007) / 10007.0f * QUERY_MAP_SIZE;
+            float y = (float)(((int64_t)(i + frame) * 6113) % 10009) / 10009.0f * QUERY_MAP_SIZE;
+            rays.push_back({{x, y}, i % 2 == 0 ? Vector2{1, 0} : Vector2{0, -1}, RAY_LENGTH});
+        }
+        frame++;
+        query.RaycastBatch(rays.data(), rays.size(), hits.data());
+        for (const QueryHit& hit : hits)
+        {
+            hitCount += hit.node != nullptr;
+        }
+    }
+    state.SetCounter("rays per ms", RAYS_PER_FRAME * (double)state.GetIterations() / state.GetElapsedMs());
+    state.SetCounter("hit rate", hitCount / (double)(RAYS_PER_FRAME * state.GetIterations()));
+
+    // A zero direction component used to leave that axis' slab open, so anything in the other axis' range was hit
+    AabbTree::Aabb above = {100, 50, 110, 60};
+    state.Check("horizontal ray misses box above", AabbTree::RayEntry(above, {0, 0}, 1.0f, INFINITY, 1000.0f) == INFINITY);
+    state.Check("vertical ray misses box beside", AabbTree::RayEntry(above, {0, 0}, INFINITY, 1.0f, 1000.0f) == INFINITY);
+    state.Check("horizontal ray hits box in line", AabbTree::RayEntry(above, {0, 55}, 1.0f, INFINITY, 1000.0f) == 100.0f);
+    delete root;
+}
+ASTRO_BENCH(BM_QueryAxisAlignedRays, 200)
+
+// Overlap and nearest queries, e.g. area of effect checks and target picking
+static void BM_QueryOverlapAndNearest(BenchState& state)
+{
+    SceneTree tree;
+    std::vector<ShapeNode*> nodes;
+    Node* root = BuildQueryScene(tree, &nodes);
+    const SceneQuery& query = tree.GetQuery();
+
+    std::vector<TreeNode*> overlaps;
+    std::vector<QueryHit> nearest;
+    size_t found = 0;
+    int frame = 0;
+    while (state.KeepRunning())
+    {
+        for (int i = 0; i < 256; i++)
+        {
+            float x = (float)(((int64_t)(i + frame) * 4253) % 10007) / 10007.0f * QUERY_MAP_SIZE;
+            float y = (float)(((int64_t)(i + frame) * 6113) % 10009) / 10009.0f * QUERY_MAP_SIZE;
+            overlaps.clear();
+            query.QueryRectangle({x, y, 300, 300}, &overlaps);
+            query.QueryNearest({x, y}, 8, &nearest);
+            found += overlaps.size() + nearest.size();
+        }
+        frame++;
+    }
+
+    state.SetCounter("queries per ms", 512.0 * state.GetIterations() / state.GetElapsedMs());
+    state.SetCounter("results per query", found / (512.0 * state.GetIterations()));
+    delete root;
+}
+ASTRO_BENCH(BM_QueryOverlapAndNearest, 200)
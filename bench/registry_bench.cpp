@@ -0,0 +1,87 @@
+#include "bench.h"
+#include "../include/astrocore/nodes/node.h"
+#include <memory>
+
+using namespace Astrocore;
+using namespace AstrocoreBench;
+
+static const int REGISTRY_NODE_COUNT = 50000;
+static const int CHURN_PER_FRAME = 1000;
+
+// The old registry: a vector of weak_ptrs, locked every time it's walked
+static void BM_RegistryIterateWeakPtr(BenchState& state)
+{
+    std::vector<std::shared_ptr<TreeNode>> owners;
+    std::vector<std::weak_ptr<TreeNode>> registry;
+    for (int i = 0; i < REGISTRY_NODE_COUNT; i++)
+    {
+        owners.push_back(std::make_shared<Node>());
+        registry.push_back(owners.back());
+    }
+
+    size_t visited = 0;
+    while (state.KeepRunning())
+    {
+        for (std::weak_ptr<TreeNode>& entry : registry)
+        {
+            if (std::shared_ptr<TreeNode> node = entry.lock())
+            {
+                DoNotOptimize(node->IsDrawn());
+                visited++;
+            }
+        }
+    }
+    state.SetCounter("nodes visited per frame", visited / state.GetIterations());
+}
+ASTRO_BENCH(BM_RegistryIterateWeakPtr, 200)
+
+static void BM_RegistryIterateNodeTable(BenchState& state)
+{
+    SceneTree tree;
+    Node* root = new Node("root");
+    for (int i = 1; i < REGISTRY_NODE_COUNT; i++)
+    {
+        root->AddChild(new Node());
+    }
+    tree.RegisterToTree(root);
+
+    size_t visited = 0;
+    while (state.KeepRunning())
+    {
+        for (TreeNode* node : tree.GetNodes())
+        {
+            DoNotOptimize(node->IsDrawn());
+            visited++;
+        }
+    }
+    state.SetCounter("nodes visited per frame", visited / state.GetIterations());
+    delete root;
+}
+ASTRO_BENCH(BM_RegistryIterateNodeTable, 200)
+
+// Nodes leaving and re-entering the table every frame
+static void BM_RegistryChurnNodeTable(BenchState& state)
+{
+    std::vector<TreeNode> nodes(REGISTRY_NODE_COUNT);
+    NodeTable table;
+    std::vector<NodeHandle> handles;
+    for (TreeNode& node : nodes)
+    {
+        handles.push_back(table.Add(&node));
+    }
+
+    int frame = 0;
+    while (state.KeepRunning())
+    {
+        for (int i = 0; i < CHURN_PER_FRAME; i++)
+        {
+            int index = ((int64_t)(frame * CHURN_PER_FRAME + i) * 104729) % REGISTRY_NODE_COUNT;
+            table.Remove(handles[index]);
+            handles[index] = table.Add(&nodes[index]);
+        }
+        frame++;
+    }
+    state.SetCounter("removes + adds per frame", CHURN_PER_FRAME * 2);
+    state.SetCounter("nodes in table", table.GetCount());
+}
+ASTRO_BENCH(BM_RegistryChurnNodeTable, 200)
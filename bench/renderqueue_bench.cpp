@@ -0,0 +1,73 @@
+#include "bench.h"
+#include "../include/astrocore/systems/rendering/renderqueue.h"
+#include "../include/astrocore/systems/scenetree.h"
+
+using namespace Astrocore;
+using namespace AstrocoreBench;
+
+static const int QUEUE_NODE_COUNT = 50000;
+
+// Queues remember the last order by tree handle, so the nodes are tracked by a tree
+static void BuildNodes(std::vector<TreeNode>& nodes, SceneTree& tree)
+{
+    nodes.resize(QUEUE_NODE_COUNT);
+    for (int i = 0; i < QUEUE_NODE_COUNT; i++)
+    {
+        tree.TrackNode(&nodes[i]);
+        // Deterministic spread over a handful of layers and z indices
+        nodes[i].SetZIndex((int)(((int64_t)i * 7919) % 64) - 32);
+        nodes[i].SetRenderLayer((uint8_t)(i % 3));
+    }
+}
+
+// Most frames only change the z index of a few nodes, the rest keep last frame's order
+static void RunQueueFrames(BenchState& state, int changesPerFrame)
+{
+    SceneTree tree;
+    std::vector<TreeNode> nodes;
+    BuildNodes(nodes, tree);
+    RenderQueue queue;
+
+    size_t resorted = 0;
+    int frame = 0;
+    while (state.KeepRunning())
+    {
+        for (int i = 0; i < changesPerFrame; i++)
+        {
+            TreeNode& node = nodes[((int64_t)(frame * changesPerFrame + i) * 104729) % QUEUE_NODE_COUNT];
+            node.SetZIndex(node.GetZIndex() + 1);
+        }
+
+        queue.Begin();
+        for (TreeNode& node : nodes)
+        {
+            queue.Add(&node);
+        }
+        queue.Sort();
+        DoNotOptimize(queue.GetItems().data());
+        resorted += queue.GetResortedCount();
+        frame++;
+    }
+
+    state.SetCounter("items per frame", QUEUE_NODE_COUNT);
+    state.SetCounter("resorted per frame", resorted / state.GetIterations());
+}
+
+static void BM_RenderQueueStable(BenchState& state)
+{
+    RunQueueFrames(state, 0);
+}
+ASTRO_BENCH(BM_RenderQueueStable, 200)
+
+static void BM_RenderQueueFewChanges(BenchState& state)
+{
+    RunQueueFrames(state, 100);
+}
+ASTRO_BENCH(BM_RenderQueueFewChanges, 200)
+
+// Every item's key changes each frame, so everything goes through the radix sort
+static void BM_RenderQueueFullRadix(BenchState& state)
+{
+    RunQueueFrames(state, QUEUE_NODE_COUNT);
+}
+ASTRO_BENCH(BM_RenderQueueFullRadix, 200)
@@ -0,0 +1,84 @@
+#include "bench.h"
+#include "../include/astrocore/systems/game.h"
+#include <sstream>
+
+using namespace Astrocore;
+using namespace AstrocoreBench;
+
+static const int SESSION_FRAMES = 10 * 60 * 60;    // 10 minutes at 60 FPS
+static const int MOVER_COUNT = 2000;
+
+// Moves by the input every frame, like a player (or things following one)
+class InputMover : public Node
+{
+public:
+    static inline ActionID moveAction = NULL_ACTION;
+    static inline ActionID dashAction = NULL_ACTION;
+
+    void Update(float deltaTime) override
+    {
+        float speed = Input::IsActionHeld(dashAction) ? 400.0f : 100.0f;
+        GetTransform()->Translate({Input::GetActionStrength(moveAction) * speed * deltaTime, 0});
+        Node::Update(deltaTime);
+    }
+};
+
+// Fake 10 minute session: the stick swings around and dash gets tapped now and then
+static void RecordSession(std::stringstream& stream)
+{
+    SimulatedInputBackend backend;
+    InputBackend* previousBackend = Input::GetBackend();
+    Input::SetBackend(&backend);
+
+    InputRecorder recorder;
+    recorder.Begin(&stream);
+    for (int frame = 0; frame < SESSION_FRAMES; frame++)
+    {
+        backend.SetGamepadAxis(0, 0, (float)((frame / 7) % 21 - 10) / 10.0f);
+        backend.SetKeyDown(KEY_SPACE, frame % 97 < 10);
+        Input::Update();
+        recorder.RecordFrame(1.0f / 60.0f);
+    }
+    recorder.End();
+    Input::SetBackend(previousBackend);
+}
+
+static void BM_InputReplayTenMinutes(BenchState& state)
+{
+    Input::AddBinding("replay_move", InputAction(JOY_AXIS, 0, 0));
+    Input::AddBinding("replay_dash", InputAction(KEYBOARD, KEY_SPACE));
+    Input::AddBinding("replay_dash", InputAction(JOY_BUTTON, 0, 0));
+    InputMover::moveAction = Input::GetActionID("replay_move");
+    InputMover::dashAction = Input::GetActionID("replay_dash");
+
+    std::stringstream stream(std::ios::in | std::ios::out | std::ios::binary);
+    RecordSession(stream);
+    size_t recordingBytes = stream.str().size();
+
+    InputReplay replay;
+    replay.Load(stream);
+
+    std::shared_ptr<TreeNode> scene(new Node("scene"));
+    for (int i = 0; i < MOVER_COUNT; i++)
+    {
+        static_cast<Node*>(scene.get())->AddChild(new InputMover());
+    }
+    Game::GetSceneTree()->SetCurrentScene(scene);
+
+    FrameTimeHistogram frameTimes;
+    size_t frames = 0;
+    while (state.KeepRunning())
+    {
+        replay.Rewind();
+        frameTimes.Clear();
+        frames = Game::RunReplay(&replay, &frameTimes);
+    }
+    Game::GetSceneTree()->SetCurrentScene(std::weak_ptr<TreeNode>());
+
+    state.SetCounter("frames", frames);
+    state.SetCounter("recording bytes", recordingBytes);
+    state.SetCounter("frame time p50 (us)", frameTimes.GetPercentile(0.5) * 1000.0);
+    state.SetCounter("frame time p99 (us)", frameTimes.GetPercentile(0.99) * 1000.0);
+    state.SetCounter("x faster than real time", replay.GetRecordedDuration() * 1000.0 / frameTimes.GetTotalMs());
+}
+ASTRO_BENCH(BM_InputReplayTenMinutes, 1)
@@ -0,0 +1,108 @@
+#include "bench.h"
+#include "../include/astrocore/nodes/shapenode.h"
+
+using namespace Astrocore;
+using namespace AstrocoreBench;
+
+static const int SCENE_DEEP_DEPTH = 2000;
+static const int SCENE_WIDE_WIDTH = 20000;
+static const int SCENE_GROUPS = 100;
+static const int SCENE_NODES_PER_GROUP = 100;
+
+// Spins a little every frame, like most gameplay nodes do something in Update()
+class SpinningNode : public Node
+{
+public:
+    void Update(float deltaTime) override
+    {
+        GetTransform()->Rotate(deltaTime);
+        Node::Update(deltaTime);
+    }
+};
+
+// A full frame of the game loop's CPU side: Update() down the whole tree, propagate,
+// then read every node's decomposed world transform
+static void RunSceneFrames(BenchState& state, Node* root, std::vector<Node*>& nodes)
+{
+    SceneTree tree;
+    root->EnterTree(&tree);
+
+    float checksum = 0;
+    while (state.KeepRunning())
+    {
+        root->Update(1.0f / 60.0f);
+        tree.PropagateTransforms();
+        for (Node* node : nodes)
+        {
+            checksum += node->GetWorldTransform().GetRotation();
+        }
+    }
+    DoNotOptimize(checksum);
+    state.SetCounter("nodes", nodes.size());
+    delete root;
+}
+
+static void BM_SceneUpdateDeep(BenchState& state)
+{
+    std::vector<Node*> nodes;
+    Node* root = new SpinningNode();
+    nodes.push_back(root);
+    Node* last = root;
+    for (int i = 1; i < SCENE_DEEP_DEPTH; i++)
+    {
+        Node* next = new SpinningNode();
+        next->GetTransform()->SetPosition({1, 0});
+        last->AddChild(next);
+        nodes.push_back(next);
+        last = next;
+    }
+    RunSceneFrames(state, root, nodes);
+}
+ASTRO_BENCH(BM_SceneUpdateDeep, 200)
+
+static void BM_SceneUpdateWide(BenchState& state)
+{
+    std::vector<Node*> nodes;
+    Node* root = new Node("root");
+    nodes.push_back(root);
+    for (int i = 0; i < SCENE_WIDE_WIDTH; i++)
+    {
+        Node* child = new SpinningNode();
+        child->GetTransform()->SetPosition({(float)i, 0});
+        root->AddChild(child);
+        nodes.push_back(child);
+    }
+    RunSceneFrames(state, root, nodes);
+}
+ASTRO_BENCH(BM_SceneUpdateWide, 200)
+
+// Loading and unloading a level: build it, add it to the tree, get it ready to draw, then delete it
+static void BM_SceneBuildTeardown(BenchState& state)
+{
+    Shape shape = Shape().AsRect(8, 8).SetFilled(true);
+    SceneTree tree;
+
+    while (state.KeepRunning())
+    {
+        Node* root = new Node("level");
+        for (int group = 0; group < SCENE_GROUPS; group++)
+        {
+            Node* groupNode = new Node();
+            groupNode->GetTransform()->SetPosition({(float)(group * 100), 0});
+            for (int i = 0; i < SCENE_NODES_PER_GROUP; i++)
+            {
+                ShapeNode* node = new ShapeNode(shape);
+                node->GetTransform()->SetPosition({0, (float)(i * 10)});
+                groupNode->AddChild(node);
+            }
+            root->AddChild(groupNode);
+        }
+        root->EnterTree(&tree);
+        tree.PropagateTransforms();
+        tree.UpdateSpatialIndex();
+        delete root;
+    }
+    state.SetCounter("nodes per level", 1 + SCENE_GROUPS * (1 + SCENE_NODES_PER_GROUP));
+    state.SetCounter("nodes left in tree", tree.GetNodes().GetCount());
+}
+ASTRO_BENCH(BM_SceneBuildTeardown, 20)
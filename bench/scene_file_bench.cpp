@@ -0,0 +1,102 @@
+#include "bench.h"
+#include "../include/astrocore/systems/scenefile.h"
+#include <cstdio>
+#include <fstream>
+
+using namespace Astrocore;
+using namespace AstrocoreBench;
+
+static const int LEVEL_NODE_COUNT = 100000;
+static const int LEVEL_ROOM_SIZE = 100;
+static const char* LEVEL_PATH = "scene_file_bench.ascn";
+
+// A level as rooms of props, every tenth one drawn
+static void BuildLevel(SceneFileWriter* writer)
+{
+    Transform2D transform;
+    writer->AddNode(-1, "level", SCENE_NODE, transform);
+    int room = -1;
+    for (int i = 1; i < LEVEL_NODE_COUNT; i++)
+    {
+        transform.SetPosition({(float)(i % 997) * 16.0f, (float)(i / 997) * 16.0f});
+        transform.SetRotation((float)(i % 7) * 0.1f);
+        if (i % LEVEL_ROOM_SIZE == 1)
+        {
+            room = writer->AddNode(0, "room", SCENE_NODE, transform);
+        }
+        else if (i % 10 == 0)
+        {
+            int prop = writer->AddNode(room, "prop", SCENE_SHAPE_NODE, transform);
+            writer->AddShape(prop, Shape().AsRect(6, 6).SetFilled(true));
+        }
+        else
+        {
+            writer->AddNode(room, "marker", SCENE_NODE, transform);
+        }
+    }
+}
+
+// The same level built in code, the way it was loaded before
+static Node* BuildLevelNodes()
+{
+    Node* root = new Node("level");
+    Node* room = nullptr;
+    for (int i = 1; i < LEVEL_NODE_COUNT; i++)
+    {
+        Node* node;
+        if (i % LEVEL_ROOM_SIZE == 1)
+        {
+            node = new Node("room");
+            root->AddChild(node);
+            room = node;
+        }
+        else
+        {
+            node = i % 10 == 0 ? new ShapeNode(Shape().AsRect(6, 6).SetFilled(true)) : new Node("marker");
+            node->name = i % 10 == 0 ? "prop" : "marker";
+            room->AddChild(node);
+        }
+        node->GetTransform()->SetPosition({(float)(i % 997) * 16.0f, (float)(i / 997) * 16.0f});
+        node->GetTransform()->SetRotation((float)(i % 7) * 0.1f);
+    }
+    return root;
+}
+
+static void BM_SceneBuildInCode(BenchState& state)
+{
+    while (state.KeepRunning())
+    {
+        Node* root = BuildLevelNodes();
+        Node::Destroy(root);
+    }
+    state.SetCounter("nodes per ms", LEVEL_NODE_COUNT * (double)state.GetIterations() / state.GetElapsedMs());
+}
+ASTRO_BENCH(BM_SceneBuildInCode, 10)
+
+// Open (map and validate) then instantiate in to pools, like a level load
+static void BM_SceneFileLoad(BenchState& state)
+{
+    {
+        SceneFileWriter writer;
+        BuildLevel(&writer);
+        std::ofstream output(LEVEL_PATH, std::ios::binary | std::ios::trunc);
+        state.Check("writes", writer.Write(output) && output.good());
+    }
+
+    NodePool<Node> nodePool;
+    NodePool<ShapeNode> shapePool;
+    size_t nodeCount = 0;
+    bool isOpen = true;
+    while (state.KeepRunning())
+    {
+        SceneFile scene;
+        isOpen = isOpen && scene.Open(LEVEL_PATH);
+        Node* root = scene.Instantiate(&nodePool, &shapePool);
+        nodeCount += scene.GetNodeCount();
+        Node::Destroy(root);
+    }
+    state.Check("opens", isOpen);
+    state.SetCounter("nodes per ms", nodeCount / state.GetElapsedMs());
+    std::remove(LEVEL_PATH);
+}
+ASTRO_BENCH(BM_SceneFileLoad, 10)
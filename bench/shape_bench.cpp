@@ -0,0 +1,60 @@
+#include "bench.h"
+#include "../include/astrocore/nodes/shapenode.h"
+#include "../include/astrocore/systems/rendering/shapebatch.h"
+
+using namespace Astrocore;
+using namespace AstrocoreBench;
+
+static const int SHAPE_NODE_COUNT = 5000;
+
+// A mix of filled circles, thick outlines and hairline rects
+static Node* BuildShapeScene(std::vector<ShapeNode*>& shapeNodes)
+{
+    Node* root = new Node("root");
+    for (int i = 0; i < SHAPE_NODE_COUNT; i++)
+    {
+        ShapeNode* node;
+        switch (i % 3)
+        {
+        case 0:
+            node = new ShapeNode(Shape().AsCircle(8, 24).SetFilled(true));
+            break;
+        case 1:
+            node = new ShapeNode(Shape().AsCircle(8, 16).SetLineThickness(3));
+            break;
+        default:
+            node = new ShapeNode(Shape().AsRect(4, 6));
+            break;
+        }
+        node->GetTransform()->SetPosition({(float)(i % 100) * 20, (float)(i / 100) * 20});
+        node->GetTransform()->SetRotation(i * 0.1f);
+        root->AddChild(node);
+        shapeNodes.push_back(node);
+    }
+    return root;
+}
+
+// CPU tessellation only, no GPU needed
+static void BM_ShapeBatchTessellate(BenchState& state)
+{
+    std::vector<ShapeNode*> shapeNodes;
+    Node* root = BuildShapeScene(shapeNodes);
+    ShapeBatch batch;
+
+    size_t vertices = 0;
+    while (state.KeepRunning())
+    {
+        batch.Clear();
+        for (ShapeNode* node : shapeNodes)
+        {
+            node->AddToBatch(&batch);
+        }
+        vertices += batch.GetTriangleVertexCount() + batch.GetLineVertexCount();
+        DoNotOptimize(batch.GetTriangles().positions.data());
+    }
+
+    state.SetCounter("vertices per frame", vertices / state.GetIterations());
+    state.SetCounter("vertices per ms", vertices / state.GetElapsedMs());
+    delete root;
+}
+ASTRO_BENCH(BM_ShapeBatchTessellate, 100)
@@ -0,0 +1,232 @@
+#include "bench.h"
+#include "../include/astrocore/component/signaler.h"
+#include "../include/astrocore/component/signal.h"
+#include <map>
+
+using namespace Astrocore;
+using namespace AstrocoreBench;
+
+static const int EVENTS_PER_FRAME = 10000;
+static const int OBSERVER_COUNT = 4;
+
+class CountingObserver : public Observer
+{
+public:
+    size_t count = 0;
+    void OnNotify(const Signaler *signaler, EventID eventID) override { count++; }
+};
+
+// Observers the way they used to be, taking the name by value
+class StringObserver
+{
+public:
+    size_t count = 0;
+    void OnNotify(const Signaler *signaler, std::string eventName) { count++; }
+};
+
+// Exposes SendEvent for the benchmark
+class TestSignaler : public Signaler
+{
+public:
+    inline void Fire(EventID eventID) { SendEvent(eventID); }
+    inline void Fire(std::string_view eventName) { SendEvent(eventName); }
+};
+
+// The old dispatch: two map lookups and a string copy per observer
+class MapSignaler
+{
+public:
+    std::map<std::string, std::vector<StringObserver *>> observerMap;
+    void SendEvent(std::string eventName)
+    {
+        if (observerMap.find(eventName) != observerMap.end())
+        {
+            for (StringObserver *observer : observerMap[eventName])
+            {
+                observer->OnNotify(nullptr, eventName);
+            }
+        }
+    }
+};
+
+static void BM_SignalerStringMap(BenchState& state)
+{
+    MapSignaler signaler;
+    StringObserver observers[OBSERVER_COUNT];
+    const char* names[4] = {"damaged_by_projectile", "died", "entered_area", "picked_up_item"};
+    for (const char* name : names)
+    {
+        for (StringObserver& observer : observers)
+        {
+            signaler.observerMap[name].push_back(&observer);
+        }
+    }
+
+    size_t allocationsBefore = GetAllocationCount();
+    while (state.KeepRunning())
+    {
+        for (int i = 0; i < EVENTS_PER_FRAME; i++)
+        {
+            signaler.SendEvent(names[i & 3]);
+        }
+    }
+    state.SetCounter("allocations per event", (double)(GetAllocationCount() - allocationsBefore) / ((size_t)EVENTS_PER_FRAME * state.GetIterations()));
+}
+ASTRO_BENCH(BM_SignalerStringMap, 200)
+
+static void BM_SignalerEventID(BenchState& state)
+{
+    TestSignaler signaler;
+    CountingObserver observers[OBSERVER_COUNT];
+    EventID ids[4] = {ASTRO_EVENT("damaged_by_projectile"), ASTRO_EVENT("died"), ASTRO_EVENT("entered_area"),
+                      ASTRO_EVENT("picked_up_item")};
+    for (EventID id : ids)
+    {
+        for (CountingObserver& observer : observers)
+        {
+            signaler.AddObserver(&observer, id);
+        }
+    }
+
+    size_t allocationsBefore = GetAllocationCount();
+    while (state.KeepRunning())
+    {
+        for (int i = 0; i < EVENTS_PER_FRAME; i++)
+        {
+            signaler.Fire(ids[i & 3]);
+        }
+    }
+    state.SetCounter("allocations per event", (double)(GetAllocationCount() - allocationsBefore) / ((size_t)EVENTS_PER_FRAME * state.GetIterations()));
+    state.SetCounter("notifications", observers[0].count * OBSERVER_COUNT);
+}
+ASTRO_BENCH(BM_SignalerEventID, 200)
+
+// The string wrapper, which still has to hash the name every time
+static void BM_SignalerStringWrapper(BenchState& state)
+{
+    TestSignaler signaler;
+    CountingObserver observers[OBSERVER_COUNT];
+    const char* names[4] = {"damaged_by_projectile", "died", "entered_area", "picked_up_item"};
+    for (const char* name : names)
+    {
+        for (CountingObserver& observer : observers)
+        {
+            signaler.AddObserver(&observer, name);
+        }
+    }
+
+    size_t allocationsBefore = GetAllocationCount();
+    while (state.KeepRunning())
+    {
+        for (int i = 0; i < EVENTS_PER_FRAME; i++)
+        {
+            signaler.Fire(names[i & 3]);
+        }
+    }
+    state.SetCounter("allocations per event", (double)(GetAllocationCount() - allocationsBefore) / ((size_t)EVENTS_PER_FRAME * state.GetIterations()));
+}
+ASTRO_BENCH(BM_SignalerStringWrapper, 200)
+
+// Lots of nodes each getting hit several times a frame, with the "damaged" event deferred and coalesced
+static void BM_SignalerDeferredCoalesced(BenchState& state)
+{
+    const int NODE_COUNT = 2000;
+    const int HITS_PER_NODE = 5;
+    EventID damaged = ASTRO_EVENT("damaged_by_projectile");
+    EventQueue& queue = EventQueue::GetMain();
+    queue.SetCoalesced(damaged, true);
+
+    std::vector<TestSignaler> signalers(NODE_COUNT);
+    CountingObserver observer;
+    for (TestSignaler& signaler : signalers)
+    {
+        signaler.SetDeferred(true);
+        signaler.AddObserver(&observer, damaged);
+    }
+
+    size_t allocationsBefore = GetAllocationCount();
+    while (state.KeepRunning())
+    {
+        for (int hit = 0; hit < HITS_PER_NODE; hit++)
+        {
+            for (TestSignaler& signaler : signalers)
+            {
+                signaler.Fire(damaged);
+            }
+        }
+        queue.Flush();
+    }
+    state.SetCounter("allocations per frame", (double)(GetAllocationCount() - allocationsBefore) / state.GetIterations());
+    state.SetCounter("queued per frame", queue.GetLastQueuedCount());
+    state.SetCounter("dispatched per frame", queue.GetLastDispatchedCount());
+    queue.SetCoalesced(damaged, false);
+}
+ASTRO_BENCH(BM_SignalerDeferredCoalesced, 100)
+
+// Payload-carrying version of the observer pattern: the observer has to call back for the data
+class DamageSignaler : public Signaler
+{
+public:
+    float lastDamage = 0.0f;
+    inline void Damage(float amount)
+    {
+        lastDamage = amount;
+        SendEvent(ASTRO_EVENT("damaged_by_projectile"));
+    }
+    virtual float GetLastDamage() const { return lastDamage; }
+};
+
+class DamageObserver : public Observer
+{
+public:
+    float total = 0.0f;
+    void OnNotify(const Signaler *signaler, EventID eventID) override
+    {
+        total += static_cast<const DamageSignaler *>(signaler)->GetLastDamage();
+    }
+};
+
+static void BM_SignalerPayload(BenchState& state)
+{
+    DamageSignaler signaler;
+    DamageObserver observers[OBSERVER_COUNT];
+    for (DamageObserver& observer : observers)
+    {
+        signaler.AddObserver(&observer, ASTRO_EVENT("damaged_by_projectile"));
+    }
+
+    while (state.KeepRunning())
+    {
+        for (int i = 0; i < EVENTS_PER_FRAME; i++)
+        {
+            signaler.Damage((float)(i & 7));
+        }
+    }
+    state.SetCounter("total damage", observers[0].total);
+}
+ASTRO_BENCH(BM_SignalerPayload, 200)
+
+// The same thing with a typed signal, the payload goes straight to the listeners
+static void BM_SignalTyped(BenchState& state)
+{
+    Signal<Signaler *, float> damaged;
+    float totals[OBSERVER_COUNT] = {};
+    std::vector<Connection> connections;
+    for (int i = 0; i < OBSERVER_COUNT; i++)
+    {
+        float* total = &totals[i];
+        connections.push_back(damaged.Connect([total](Signaler *source, float amount) { *total += amount; }));
+    }
+
+    size_t allocationsBefore = GetAllocationCount();
+    while (state.KeepRunning())
+    {
+        for (int i = 0; i < EVENTS_PER_FRAME; i++)
+        {
+            damaged.Emit(nullptr, (float)(i & 7));
+        }
+    }
+    state.SetCounter("allocations per event", (double)(GetAllocationCount() - allocationsBefore) / ((size_t)EVENTS_PER_FRAME * state.GetIterations()));
+    state.SetCounter("total damage", totals[0]);
+}
+ASTRO_BENCH(BM_SignalTyped, 200)
@@ -0,0 +1,141 @@
+#include "bench.h"
+#include "../include/astrocore/nodes/node.h"
+
+using namespace Astrocore;
+using namespace AstrocoreBench;
+
+static const int DEEP_DEPTH = 2000;
+static const int WIDE_WIDTH = 20000;
+
+// A single chain of nodes, each the child of the last
+static Node* BuildDeep(std::vector<Node*>& nodes)
+{
+    Node* root = new Node("root");
+    nodes.push_back(root);
+    Node* last = root;
+    for (int i = 1; i < DEEP_DEPTH; i++)
+    {
+        Node* next = new Node();
+        next->GetTransform()->SetPosition({1, 0});
+        last->AddChild(next);
+        nodes.push_back(next);
+        last = next;
+    }
+    return root;
+}
+
+// A root with a lot of direct children
+static Node* BuildWide(std::vector<Node*>& nodes)
+{
+    Node* root = new Node("root");
+    nodes.push_back(root);
+    for (int i = 0; i < WIDE_WIDTH; i++)
+    {
+        Node* child = new Node();
+        child->GetTransform()->SetPosition({(float)i, 0});
+        root->AddChild(child);
+        nodes.push_back(child);
+    }
+    return root;
+}
+
+// Each frame moves the given nodes, then reads the world transform of every
+// node the way drawing would. Reports how many recomputes that took versus
+// recomputing on every read.
+static void RunFrames(BenchState& state, Node* root, std::vector<Node*>& nodes, std::vector<Node*>& moving, bool inTree)
+{
+    SceneTree tree;
+    if (inTree)
+    {
+        root->EnterTree(&tree);
+    }
+
+    // Warm up so the first build of the caches isn't counted
+    for (Node* node : nodes)
+    {
+        node->GetWorldAffine();
+    }
+
+    size_t recomputesBefore = inTree ? tree.GetTransformSystem()->GetRecomputeCount() : Node::GetWorldRecomputeCount();
+    size_t queries = 0;
+    while (state.KeepRunning())
+    {
+        for (Node* node : moving)
+        {
+            node->GetTransform()->Rotate(0.01f);
+        }
+        if (inTree)
+        {
+            tree.PropagateTransforms();
+        }
+
+        for (Node* node : nodes)
+        {
+            DoNotOptimize(node->GetWorldAffine());
+            queries++;
+        }
+    }
+    size_t recomputes = (inTree ? tree.GetTransformSystem()->GetRecomputeCount() : Node::GetWorldRecomputeCount()) - recomputesBefore;
+
+    state.SetCounter("world transform reads", queries);
+    state.SetCounter("recomputes", recomputes);
+    state.SetCounter("recomputes avoided", queries - recomputes);
+
+    delete root;
+}
+
+static void BM_TransformDeepStatic(BenchState& state)
+{
+    std::vector<Node*> nodes, moving;
+    Node* root = BuildDeep(nodes);
+    RunFrames(state, root, nodes, moving, true);
+}
+ASTRO_BENCH(BM_TransformDeepStatic, 200)
+
+static void BM_TransformDeepMovingMiddle(BenchState& state)
+{
+    std::vector<Node*> nodes;
+    Node* root = BuildDeep(nodes);
+    std::vector<Node*> moving = {nodes[DEEP_DEPTH / 2]};
+    RunFrames(state, root, nodes, moving, true);
+}
+ASTRO_BENCH(BM_TransformDeepMovingMiddle, 200)
+
+static void BM_TransformDeepMovingMiddleDetached(BenchState& state)
+{
+    std::vector<Node*> nodes;
+    Node* root = BuildDeep(nodes);
+    std::vector<Node*> moving = {nodes[DEEP_DEPTH / 2]};
+    RunFrames(state, root, nodes, moving, false);
+}
+ASTRO_BENCH(BM_TransformDeepMovingMiddleDetached, 200)
+
+static void BM_TransformWideStatic(BenchState& state)
+{
+    std::vector<Node*> nodes, moving;
+    Node* root = BuildWide(nodes);
+    RunFrames(state, root, nodes, moving, true);
+}
+ASTRO_BENCH(BM_TransformWideStatic, 200)
+
+static void BM_TransformWideMovingFew(BenchState& state)
+{
+    std::vector<Node*> nodes;
+    Node* root = BuildWide(nodes);
+    std::vector<Node*> moving;
+    for (int i = 1; i < (int)nodes.size(); i += WIDE_WIDTH / 10)
+    {
+        moving.push_back(nodes[i]);
+    }
+    RunFrames(state, root, nodes, moving, true);
+}
+ASTRO_BENCH(BM_TransformWideMovingFew, 200)
+
+static void BM_TransformWideMovingRootDetached(BenchState& state)
+{
+    std::vector<Node*> nodes;
+    Node* root = BuildWide(nodes);
+    std::vector<Node*> moving = {root};
+    RunFrames(state, root, nodes, moving, false);
+}
+ASTRO_BENCH(BM_TransformWideMovingRootDetached, 200)
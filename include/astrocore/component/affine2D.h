@@ -0,0 +1,94 @@
+#ifndef AFFINE2D_H
+#define AFFINE2D_H
+#include <raylib.h>
+#include <cmath>
+#include <cstddef>
+
+namespace Astrocore
+{
+	// A 2D affine transform stored as a 3x2 matrix:
+	//	| a c tx |
+	//	| b d ty |
+	// Much cheaper to compose than a raylib Matrix, and decomposing it doesn't need quaternions
+	struct Affine2D
+	{
+		float a = 1;
+		float b = 0;
+		float c = 0;
+		float d = 1;
+		float tx = 0;
+		float ty = 0;
+
+		static inline Affine2D Identity()
+		{
+			return Affine2D();
+		}
+
+		// Builds the transform in the order: scale, rotate, translate
+		static inline Affine2D FromTRS(Vector2 position, float rotation, Vector2 scale)
+		{
+			float cosR = cosf(rotation);
+			float sinR = sinf(rotation);
+			Affine2D result;
+			result.a = cosR * scale.x;
+			result.b = sinR * scale.x;
+			result.c = -sinR * scale.y;
+			result.d = cosR * scale.y;
+			result.tx = position.x;
+			result.ty = position.y;
+			return result;
+		}
+
+		// Returns the transform that applies 'local' first, then 'parent'
+		static inline Affine2D Multiply(const Affine2D& parent, const Affine2D& local)
+		{
+			Affine2D result;
+			result.a = parent.a * local.a + parent.c * local.b;
+			result.b = parent.b * local.a + parent.d * local.b;
+			result.c = parent.a * local.c + parent.c * local.d;
+			result.d = parent.b * local.c + parent.d * local.d;
+			result.tx = parent.a * local.tx + parent.c * local.ty + parent.tx;
+			result.ty = parent.b * local.tx + parent.d * local.ty + parent.ty;
+			return result;
+		}
+
+		inline Vector2 Apply(Vector2 point) const
+		{
+			return {a * point.x + c * point.y + tx, b * point.x + d * point.y + ty};
+		}
+
+		// Transforms a whole array of points at once. Works on the raw floats so the
+		// compiler can vectorize it (in and out must not overlap)
+		inline void ApplyToPoints(const Vector2* in, Vector2* out, size_t count) const
+		{
+			const float* __restrict src = reinterpret_cast<const float*>(in);
+			float* __restrict dst = reinterpret_cast<float*>(out);
+			for (size_t i = 0; i < count * 2; i += 2)
+			{
+				float x = src[i];
+				float y = src[i + 1];
+				dst[i] = a * x + c * y + tx;
+				dst[i + 1] = b * x + d * y + ty;
+			}
+		}
+
+		inline Vector2 GetPosition() const { return {tx, ty}; }
+		inline float GetRotation() const { return atan2f(b, a); }
+		inline Vector2 GetScale() const
+		{
+			float scaleX = sqrtf(a * a + b * b);
+			float scaleY = scaleX != 0 ? (a * d - b * c) / scaleX : 0;
+			return {scaleX, scaleY};
+		}
+
+		// Converts to a raylib matrix (for use with rlgl/raymath)
+		inline Matrix ToMatrix() const
+		{
+			return {a, c, 0, tx,
+					b, d, 0, ty,
+					0, 0, 1, 0,
+					0, 0, 0, 1};
+		}
+	};
+}
+#endif // !AFFINE2D
@@ -0,0 +1,91 @@
+#ifndef EVENTID_H
+#define EVENTID_H
+#include <string>
+#include <string_view>
+#include <deque>
+#include <unordered_map>
+#include <mutex>
+#include <cstdint>
+
+namespace Astrocore
+{
+    // A small integer standing in for an event name. IDs are handed out in order, starting
+    // at 0, so they can index flat tables directly.
+    typedef uint32_t EventID;
+    const EventID NULL_EVENT = UINT32_MAX;
+
+    // FNV-1a, usable at compile time
+    constexpr uint64_t HashEventName(std::string_view name)
+    {
+        uint64_t hash = 14695981039346656037ull;
+        for (char c : name)
+        {
+            hash ^= (uint8_t)c;
+            hash *= 1099511628211ull;
+        }
+        return hash;
+    }
+
+    // Maps event names to IDs. Interning is the slow path (it locks, and allocates the
+    // first time a name is seen), so look an ID up once and keep it around.
+    class EventRegistry
+    {
+    private:
+        struct NameHash
+        {
+            size_t operator()(std::string_view name) const { return (size_t)HashEventName(name); }
+        };
+
+        std::mutex mutex;
+        std::deque<std::string> names;  // Indexed by ID. A deque so the views below stay valid
+        std::unordered_map<std::string_view, EventID, NameHash> ids;
+
+        static EventRegistry& Get()
+        {
+            static EventRegistry registry;
+            return registry;
+        }
+
+    public:
+        /// @brief Get the ID of an event name, assigning it one if it doesn't have one yet
+        static EventID Intern(std::string_view name)
+        {
+            EventRegistry& registry = Get();
+            std::lock_guard<std::mutex> lock(registry.mutex);
+            auto it = registry.ids.find(name);
+            if (it != registry.ids.end())
+            {
+                return it->second;
+            }
+
+            EventID id = registry.names.size();
+            registry.names.emplace_back(name);
+            registry.ids.emplace(registry.names.back(), id);
+            return id;
+        }
+
+        /// @brief Get the ID of an event name without assigning one
+        /// @return The ID, or NULL_EVENT if the name has never been interned
+        static EventID Find(std::string_view name)
+        {
+            EventRegistry& registry = Get();
+            std::lock_guard<std::mutex> lock(registry.mutex);
+            auto it = registry.ids.find(name);
+            return it != registry.ids.end() ? it->second : NULL_EVENT;
+        }
+
+        // The name an ID was interned from (empty if the ID is unknown)
+        static std::string_view GetName(EventID id)
+        {
+            EventRegistry& registry = Get();
+            std::lock_guard<std::mutex> lock(registry.mutex);
+            return id < registry.names.size() ? std::string_view(registry.names[id]) : std::string_view();
+        }
+    };
+}
+
+// Interns an event name the first time this line runs, then just returns the cached ID
+// e.g. SendEvent(ASTRO_EVENT("died"));
+#define ASTRO_EVENT(name) ([]() { static const ::Astrocore::EventID id = ::Astrocore::EventRegistry::Intern(name); return id; }())
+
+#endif // !EVENTID
@@ -0,0 +1,366 @@
+#ifndef SIGNAL_H
+#define SIGNAL_H
+#include <vector>
+#include <cstddef>
+#include <cstdint>
+#include <new>
+#include <utility>
+#include <type_traits>
+
+namespace Astrocore
+{
+    // A callable stored inline, without the heap allocation std::function can make.
+    // Anything up to DELEGATE_STORAGE_SIZE bytes fits (e.g. a lambda capturing a couple of pointers).
+    const size_t DELEGATE_STORAGE_SIZE = 4 * sizeof(void *);
+
+    template <typename... Args>
+    class Delegate
+    {
+    private:
+        alignas(std::max_align_t) unsigned char storage[DELEGATE_STORAGE_SIZE];
+        void (*invoke)(void *, Args...) = nullptr;
+        // Moves the callable from source into destination, or destroys source if destination is null
+        void (*manage)(void *destination, void *source) = nullptr;
+
+        template <typename F>
+        static void Invoke(void *callable, Args... args)
+        {
+            (*static_cast<F *>(callable))(std::forward<Args>(args)...);
+        }
+
+        template <typename F>
+        static void Manage(void *destination, void *source)
+        {
+            if (destination != nullptr)
+            {
+                new (destination) F(std::move(*static_cast<F *>(source)));
+            }
+            static_cast<F *>(source)->~F();
+        }
+
+    public:
+        Delegate(){};
+
+        template <typename F, typename = typename std::enable_if<!std::is_same<typename std::decay<F>::type, Delegate>::value>::type>
+        Delegate(F &&callable)
+        {
+            typedef typename std::decay<F>::type Callable;
+            static_assert(sizeof(Callable) <= DELEGATE_STORAGE_SIZE, "Callable is too big to store inline, capture less (or capture a pointer to it)");
+            static_assert(alignof(Callable) <= alignof(std::max_align_t), "Callable is over-aligned");
+            new (storage) Callable(std::forward<F>(callable));
+            invoke = &Invoke<Callable>;
+            manage = &Manage<Callable>;
+        }
+
+        Delegate(Delegate &&other)
+        {
+            *this = std::move(other);
+        }
+
+        Delegate &operator=(Delegate &&other)
+        {
+            if (this != &other)
+            {
+                Reset();
+                if (other.invoke != nullptr)
+                {
+                    other.manage(storage, other.storage);
+                    invoke = other.invoke;
+                    manage = other.manage;
+                    other.invoke = nullptr;
+                    other.manage = nullptr;
+                }
+            }
+            return *this;
+        }
+
+        Delegate(const Delegate &) = delete;
+        Delegate &operator=(const Delegate &) = delete;
+        ~Delegate() { Reset(); }
+
+        void Reset()
+        {
+            if (invoke != nullptr)
+            {
+                manage(nullptr, storage);
+                invoke = nullptr;
+                manage = nullptr;
+            }
+        }
+
+        inline explicit operator bool() const { return invoke != nullptr; }
+        inline void operator()(Args... args) { invoke(storage, std::forward<Args>(args)...); }
+    };
+
+    class Connection;
+
+    // The part of a signal that connections talk to
+    class SignalBase
+    {
+        friend class Connection;
+
+    protected:
+        virtual ~SignalBase(){};
+        virtual void Disconnect(uint32_t index) = 0;
+        // A connection handle moved, so the slot needs to know where it went
+        virtual void MoveConnection(uint32_t index, Connection *connection) = 0;
+
+        static inline void Detach(Connection *connection);
+        static inline void SetIndex(Connection *connection, uint32_t index);
+    };
+
+    // Keeps a listener connected to a signal. The listener is disconnected when the
+    // connection is destroyed (or Disconnect() is called), so it can't outlive whatever it captured.
+    class Connection
+    {
+        friend class SignalBase;
+
+    private:
+        SignalBase *signal = nullptr;
+        uint32_t index = 0;
+
+    public:
+        Connection(){};
+        Connection(SignalBase *signal, uint32_t index) : signal(signal), index(index){};
+        ~Connection() { Disconnect(); }
+
+        Connection(Connection &&other)
+        {
+            *this = std::move(other);
+        }
+
+        Connection &operator=(Connection &&other)
+        {
+            if (this != &other)
+            {
+                Disconnect();
+                signal = other.signal;
+                index = other.index;
+                other.signal = nullptr;
+                if (signal != nullptr)
+                {
+                    signal->MoveConnection(index, this);
+                }
+            }
+            return *this;
+        }
+
+        Connection(const Connection &) = delete;
+        Connection &operator=(const Connection &) = delete;
+
+        void Disconnect()
+        {
+            if (signal != nullptr)
+            {
+                SignalBase *connectedSignal = signal;
+                signal = nullptr;
+                connectedSignal->Disconnect(index);
+            }
+        }
+
+        // Gives up the handle, leaving the listener connected for as long as the signal exists
+        void Release()
+        {
+            if (signal != nullptr)
+            {
+                signal->MoveConnection(index, nullptr);
+                signal = nullptr;
+            }
+        }
+
+        inline bool IsConnected() const { return signal != nullptr; }
+    };
+
+    inline void SignalBase::Detach(Connection *connection) { connection->signal = nullptr; }
+    inline void SignalBase::SetIndex(Connection *connection, uint32_t index) { connection->index = index; }
+
+    // A typed event with its payload passed straight to the listeners, e.g.
+    //     Signal<TreeNode *, float> damaged;
+    //     Connection connection = damaged.Connect([this](TreeNode *source, float amount) { ... });
+    //     damaged.Emit(this, 10.0f);
+    // Pass big payloads by reference (Signal<const Hit &>), arguments are handed to every listener as they are.
+    template <typename... Args>
+    class Signal : public SignalBase
+    {
+    private:
+        struct Slot
+        {
+            Delegate<Args...> delegate;
+            Connection *connection;     // Null if the handle was released
+            bool isConnected;
+        };
+
+        std::vector<Slot> slots;
+        // Listeners connected mid-emit wait here, adding to the slots could move the one being called
+        std::vector<Slot> pendingSlots;
+        int emitDepth = 0;
+        size_t disconnectedCount = 0;   // Disconnected slots still in the list
+
+        void Disconnect(uint32_t index) override
+        {
+            Slot &slot = index < slots.size() ? slots[index] : pendingSlots[index - slots.size()];
+            slot.isConnected = false;
+            slot.connection = nullptr;
+            disconnectedCount++;
+
+            // Mid-emit the delegate could be the one running right now, so it's freed afterwards.
+            // Otherwise the list is only compacted once it's mostly gaps, so disconnecting lots of listeners stays linear
+            if (emitDepth == 0)
+            {
+                slot.delegate.Reset();
+                if (disconnectedCount * 2 > slots.size())
+                {
+                    Compact();
+                }
+            }
+        }
+
+        void MoveConnection(uint32_t index, Connection *connection) override
+        {
+            Slot &slot = index < slots.size() ? slots[index] : pendingSlots[index - slots.size()];
+            slot.connection = connection;
+        }
+
+        // Drops disconnected slots and brings in the pending ones, keeping connection order
+        void Compact()
+        {
+            if (disconnectedCount > 0)
+            {
+                size_t kept = 0;
+                for (size_t i = 0; i < slots.size(); i++)
+                {
+                    if (slots[i].isConnected)
+                    {
+                        if (kept != i)
+                        {
+                            slots[kept] = std::move(slots[i]);
+                        }
+                        kept++;
+                    }
+                }
+                slots.erase(slots.begin() + kept, slots.end());
+                disconnectedCount = 0;
+            }
+            for (Slot &slot : pendingSlots)
+            {
+                if (slot.isConnected)
+                {
+                    slots.push_back(std::move(slot));
+                }
+            }
+            pendingSlots.clear();
+
+            for (size_t i = 0; i < slots.size(); i++)
+            {
+                if (slots[i].connection != nullptr)
+                {
+                    SetIndex(slots[i].connection, i);
+                }
+            }
+        }
+
+    public:
+        Signal(){};
+        ~Signal()
+        {
+            for (Slot &slot : slots)
+            {
+                if (slot.connection != nullptr)
+                {
+                    Detach(slot.connection);
+                }
+            }
+            for (Slot &slot : pendingSlots)
+            {
+                if (slot.connection != nullptr)
+                {
+                    Detach(slot.connection);
+                }
+            }
+        }
+
+        // Connections point back at the signal, so it stays where it is
+        Signal(const Signal &) = delete;
+        Signal &operator=(const Signal &) = delete;
+
+        /// @brief Connect a listener
+        /// @param callable Anything callable with the signal's arguments, that fits in a Delegate
+        /// @return The connection, the listener is disconnected when it's destroyed
+        /// Listeners connected while the signal is emitting are first called on the next emit
+        template <typename F>
+        [[nodiscard]] Connection Connect(F &&callable)
+        {
+            uint32_t index = slots.size() + pendingSlots.size();
+            Connection connection(this, index);
+            std::vector<Slot> &destination = emitDepth > 0 ? pendingSlots : slots;
+            destination.push_back({Delegate<Args...>(std::forward<F>(callable)), nullptr, true});
+            // The returned handle is moved out of here, which updates this pointer
+            destination.back().connection = &connection;
+            return connection;
+        }
+
+        // Connects a member function, e.g. signal.Connect<&Player::OnHit>(this)
+        template <auto Method, typename T>
+        [[nodiscard]] Connection Connect(T *object)
+        {
+            return Connect([object](Args... args) { (object->*Method)(std::forward<Args>(args)...); });
+        }
+
+        /// @brief Call every connected listener, in the order they were connected
+        void Emit(Args... args)
+        {
+            emitDepth++;
+            size_t count = slots.size();
+            for (size_t i = 0; i < count; i++)
+            {
+                Slot &slot = slots[i];
+                if (slot.isConnected)
+                {
+                    slot.delegate(args...);
+                }
+            }
+            emitDepth--;
+
+            if (emitDepth == 0 && (disconnectedCount > 0 || !pendingSlots.empty()))
+            {
+                Compact();
+            }
+        }
+
+        inline void operator()(Args... args) { Emit(args...); }
+
+        // The number of connected listeners
+        inline size_t GetConnectionCount() { return slots.size() + pendingSlots.size() - disconnectedCount; }
+
+        // Disconnects every listener
+        void Clear()
+        {
+            for (Slot &slot : slots)
+            {
+                if (slot.connection != nullptr)
+                {
+                    Detach(slot.connection);
+                    slot.connection = nullptr;
+                }
+                disconnectedCount += slot.isConnected ? 1 : 0;
+                slot.isConnected = false;
+            }
+            for (Slot &slot : pendingSlots)
+            {
+                if (slot.connection != nullptr)
+                {
+                    Detach(slot.connection);
+                    slot.connection = nullptr;
+                }
+                disconnectedCount += slot.isConnected ? 1 : 0;
+                slot.isConnected = false;
+            }
+            if (emitDepth == 0)
+            {
+                Compact();
+            }
+        }
+    };
+};
+
+#endif // !SIGNAL
@@ -1,9 +1,12 @@
 #ifndef SIGNALER_H
 #define SIGNALER_H
 #include <string>
-#include <map>
+#include <string_view>
 #include <vector>
+#include <utility>
 #include <algorithm>
+#include "eventid.h"
+#include "../systems/eventqueue.h"
 
 namespace Astrocore
 {
@@ -12,83 +15,248 @@ namespace Astrocore
     {
     public:
         virtual ~Observer(){};
-        virtual void OnNotify(const Signaler *signaler, std::string eventName) {};
+        // Called for every event the observer is watching
+        virtual void OnNotify(const Signaler *signaler, EventID eventID) {};
+    };
+
+    // For observers that would rather match on event names. Every notification looks the name up in
+    // the event registry (it doesn't allocate, but it does lock), so keep it off hot paths
+    class NamedObserver : public Observer
+    {
+    public:
+        using Observer::OnNotify;
+        void OnNotify(const Signaler *signaler, EventID eventID) override
+        {
+            OnNotify(signaler, EventRegistry::GetName(eventID));
+        };
+        virtual void OnNotify(const Signaler *signaler, std::string_view eventName) {};
     };
 
     class Signaler
     {
-    protected:
-        std::map<std::string, std::vector<Observer *>> observerMap;
+        friend class EventQueue;
+    private:
+        // Observers of each event, indexed by event ID
+        // Removed observers are nulled out while dispatching, and compacted afterwards
+        std::vector<std::vector<Observer *>> observersByEvent;
+
+        // Subscription changes can't touch the lists while they're being walked, so during a
+        // dispatch (or an event queue flush) they're held here until it's finished
+        std::vector<std::pair<EventID, Observer *>> pendingAdds;
+        bool hasRemovedObservers = false;
+        bool isPendingInQueue = false;
+        int dispatchDepth = 0;
+
+        bool isDeferred = false;
+        uint32_t queuedEventCount = 0;  // Events waiting in the event queue
+        uint64_t coalesceStamp = 0;     // The last coalesced event group the event queue kept an event from us for
+
+        inline bool IsHoldingChanges() { return dispatchDepth > 0 || EventQueue::GetMain().IsFlushing(); }
+
+        void HoldChanges()
+        {
+            // Mid-flush the queue applies the changes once the whole flush is done,
+            // otherwise the outermost DispatchEvent() does
+            if (EventQueue::GetMain().IsFlushing() && !isPendingInQueue)
+            {
+                isPendingInQueue = true;
+                EventQueue::GetMain().AddPendingSignaler(this);
+            }
+        }
+
+        void ApplyPendingChanges()
+        {
+            isPendingInQueue = false;
+            if (hasRemovedObservers)
+            {
+                for (std::vector<Observer *> &observers : observersByEvent)
+                {
+                    observers.erase(std::remove(observers.begin(), observers.end(), nullptr), observers.end());
+                }
+                hasRemovedObservers = false;
+            }
+            for (std::pair<EventID, Observer *> &add : pendingAdds)
+            {
+                AddObserver(add.second, add.first);
+            }
+            pendingAdds.clear();
+        }
 
-        void SendEvent(std::string eventName)
+        // Notifies every observer of the event right now
+        void DispatchEvent(EventID eventID)
         {
-            if (observerMap.find(eventName) != observerMap.end())
+            if (eventID >= observersByEvent.size())
             {
-                for (Observer *observer : observerMap[eventName])
+                return;
+            }
+
+            dispatchDepth++;
+            // Indexed every time, observers removed along the way are skipped
+            for (size_t i = 0; i < observersByEvent[eventID].size(); i++)
+            {
+                Observer *observer = observersByEvent[eventID][i];
+                if (observer != nullptr)
                 {
-                    observer->OnNotify(this, eventName);
+                    observer->OnNotify(this, eventID);
                 }
             }
+            dispatchDepth--;
+
+            if (dispatchDepth == 0 && !EventQueue::GetMain().IsFlushing())
+            {
+                ApplyPendingChanges();
+            }
+        }
+
+    protected:
+        // Dispatching doesn't allocate or look anything up by name
+        // (in deferred mode the event is queued instead, see SetDeferred())
+        void SendEvent(EventID eventID)
+        {
+            if (isDeferred)
+            {
+                QueueEvent(eventID);
+                return;
+            }
+            DispatchEvent(eventID);
         }
+
+        void SendEvent(std::string_view eventName)
+        {
+            EventID eventID = EventRegistry::Find(eventName);
+            if (eventID != NULL_EVENT)
+            {
+                SendEvent(eventID);
+            }
+        }
+
+        // Adds the event to the main event queue, to be dispatched when the game loop flushes it
+        void QueueEvent(EventID eventID)
+        {
+            queuedEventCount++;
+            EventQueue::GetMain().Push(this, eventID);
+        }
+
     public:
         // Constructor
-        Signaler()
+        Signaler(){};
+        ~Signaler()
         {
-            observerMap = std::map<std::string, std::vector<Observer *>>();
+            if (queuedEventCount > 0 || EventQueue::GetMain().IsFlushing())
+            {
+                EventQueue::GetMain().Cancel(this);
+            }
+            if (isPendingInQueue)
+            {
+                EventQueue::GetMain().RemovePendingSignaler(this);
+            }
         }
 
+        // In deferred mode, SendEvent() queues events instead of dispatching them right away
+        inline void SetDeferred(bool shouldDefer) { isDeferred = shouldDefer; }
+        inline bool IsDeferred() { return isDeferred; }
+
         /// @brief Get the amount of observers for a given event
-        /// @param eventName The name of the event
+        /// @param eventID The ID of the event
         /// @return The number of observers of the event, or 0
-        int GetObserverCount(std::string eventName)
+        int GetObserverCount(EventID eventID)
+        {
+            if (eventID >= observersByEvent.size())
+            {
+                return 0;
+            }
+            const std::vector<Observer *> &observers = observersByEvent[eventID];
+            return observers.size() - std::count(observers.begin(), observers.end(), nullptr);
+        };
+        int GetObserverCount(std::string_view eventName)
         {
-            return (observerMap.find(eventName) != observerMap.end() ? observerMap[eventName].size() : 0);
+            return GetObserverCount(EventRegistry::Find(eventName));
         };
 
-        void AddObserver(Observer *observer, std::string eventName)
+        // Note: Observers added while the event is being dispatched aren't notified until the next one
+        void AddObserver(Observer *observer, EventID eventID)
         {
-            if (observerMap.find(eventName) != observerMap.end())
+            if (eventID == NULL_EVENT)
+            {
+                return;
+            }
+            if (IsHoldingChanges())
             {
-                observerMap[eventName].push_back(observer);
+                pendingAdds.push_back({eventID, observer});
+                HoldChanges();
+                return;
             }
-            else
+            if (eventID >= observersByEvent.size())
             {
-                observerMap.insert(std::pair{eventName, std::vector<Observer *>()});
-                observerMap[eventName].push_back(observer);
+                observersByEvent.resize(eventID + 1);
             }
+            observersByEvent[eventID].push_back(observer);
+        }
+        void AddObserver(Observer *observer, std::string_view eventName)
+        {
+            AddObserver(observer, EventRegistry::Intern(eventName));
         }
 
         /// @brief Remove an observer of this signaler
         /// @param observer The observer to remove
-        /// @param eventName The name of the event to remove the observer from
-        void RemoveObserver(Observer *observer, std::string eventName)
+        /// @param eventID The ID of the event to remove the observer from
+        /// Removing an observer mid-dispatch is safe, it won't be notified again
+        void RemoveObserver(Observer *observer, EventID eventID)
         {
-            if (observerMap.find(eventName) != observerMap.end())
+            // Could still be waiting to be added
+            for (size_t i = 0; i < pendingAdds.size(); i++)
             {
-                std::vector<Observer *>::iterator index = std::find(observerMap[eventName].begin(), observerMap[eventName].end(), observer);
+                if (pendingAdds[i].first == eventID && pendingAdds[i].second == observer)
+                {
+                    pendingAdds.erase(pendingAdds.begin() + i);
+                    return;
+                }
+            }
+
+            if (eventID < observersByEvent.size())
+            {
+                std::vector<Observer *> &observers = observersByEvent[eventID];
+                std::vector<Observer *>::iterator index = std::find(observers.begin(), observers.end(), observer);
 
                 // Note: Index is *not* and int, but an iterator
-                if (index != observerMap[eventName].end())
+                if (index != observers.end())
                 {
-                    observerMap[eventName].erase(index);
+                    if (IsHoldingChanges())
+                    {
+                        *index = nullptr;
+                        hasRemovedObservers = true;
+                        HoldChanges();
+                    }
+                    else
+                    {
+                        observers.erase(index);
+                    }
                 }
             }
         }
+        void RemoveObserver(Observer *observer, std::string_view eventName)
+        {
+            RemoveObserver(observer, EventRegistry::Find(eventName));
+        }
 
         /// @brief Is there an observer listening for this event
         /// @param observer The observer that might be watching the event
-        /// @param eventName The name of the event
+        /// @param eventID The ID of the event
         /// @return TRUE if the observer is watching the event
-        bool IsObservingEvent(Observer *observer, std::string eventName)
+        bool IsObservingEvent(Observer *observer, EventID eventID)
         {
-            if (observerMap.find(eventName) != observerMap.end())
+            if (eventID < observersByEvent.size())
             {
-                std::vector<Observer *>::iterator index = std::find(observerMap[eventName].begin(), observerMap[eventName].end(), observer);
-
-                return index != observerMap[eventName].end();
+                const std::vector<Observer *> &observers = observersByEvent[eventID];
+                return std::find(observers.begin(), observers.end(), observer) != observers.end();
             }
+            return false;
+        }
+        bool IsObservingEvent(Observer *observer, std::string_view eventName)
+        {
+            return IsObservingEvent(observer, EventRegistry::Find(eventName));
         }
     };
 };
 
-#endif
\ No newline at end of file
+#endif
@@ -2,9 +2,14 @@
 #define TRANSFORM2D_H
 #include <raylib.h>
 #include <raymath.h>
+#include <cstdint>
+#include "affine2D.h"
 
 namespace Astrocore
 {
+	// Called whenever a transform is modified
+	typedef void (*TransformChangedCallback)(void* context);
+
 	class Transform2D
 	{
 	private:
@@ -12,6 +17,12 @@ namespace Astrocore
 		float rotation;
 		Vector2 scale;
 
+		// Change tracking (not copied along with the transform)
+		uint32_t version = 0;
+		TransformChangedCallback changedCallback = nullptr;
+		void* changedContext = nullptr;
+
+		void OnChanged();
 		void SetTransform(Vector2 position, float rotation, Vector2 scale);
 		void MatrixDecompose(Matrix matrix, Vector3* translation, Quaternion* rotation, Vector3* scale);
 
@@ -21,6 +32,8 @@ namespace Astrocore
 		Transform2D(Vector2 initialPosition, float rotation);
 		Transform2D(Transform2D* other);
 		Transform2D(Matrix transformMat);
+		Transform2D(const Transform2D& other);
+		Transform2D& operator=(const Transform2D& other);
 		//~Transform2D();
 	
 		// Modifiers
@@ -36,13 +49,21 @@ namespace Astrocore
 		void SetRotation(float rotation);
 		void SetScale(float scaleX, float scaleY);
 		void SetMatrix(Matrix newMat);
+		void SetAffine(const Affine2D& newAffine);
 
 		// Getters
-		Vector2 GetPosition();
-		Vector2 GetScale();
-		float GetRotation();
-		float GetRotationDegrees();
-		Matrix GetMatrix();
+		Vector2 GetPosition() const;
+		Vector2 GetScale() const;
+		float GetRotation() const;
+		float GetRotationDegrees() const;
+		Matrix GetMatrix() const;
+		Affine2D GetAffine() const;
+
+		// Change tracking
+		// Incremented every time the transform actually changes
+		inline uint32_t GetVersion() const { return version; }
+		// Only one listener is supported, setting a new one replaces the old one
+		void SetChangedCallback(TransformChangedCallback callback, void* context);
 	};
 }
 #endif // !TRANSFORM2D
\ No newline at end of file
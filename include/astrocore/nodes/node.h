@@ -7,11 +7,18 @@
 #include <string>
 #include "../systems/scenetree.h"
 #include "treenode.h"
+#include "../systems/physics/physicsworld.h"
 namespace Astrocore
 {
+    class NodeAllocator;
+
     class Node : public TreeNode
     {
+    friend class NodeAllocator;
+    friend class PhysicsWorld;
     static int NODE_INCREMENTOR;
+    static size_t WORLD_RECOMPUTE_COUNT;
+    static int BULK_TEARDOWN_DEPTH;     // Non-zero while a pool is destroying all of its nodes at once
     private:
         
         void SetNodeID(); // Called internally to create a runtime-unique id
@@ -23,21 +30,40 @@ namespace Astrocore
 
         std::vector<Node*> children;
         Node* parent = nullptr;
-        std::unique_ptr<Transform2D> transform;
-        std::unique_ptr<Transform2D> worldTransform;
+        // Stored in place, so creating a node doesn't need any extra allocations
+        Transform2D transform;
+        Transform2D worldTransform;
+        NodeAllocator* allocator = nullptr;     // The pool the node came from, or null if it was made with new
+        Affine2D worldAffine;               // Cached world transform when not in a tree
+        uint32_t worldVersion = 0;          // Bumped when worldAffine is recomputed
+        uint32_t decomposedVersion = 0;     // World version that worldTransform was decomposed from
+        bool isDecomposedValid = false;
+        TransformID transformID = NULL_TRANSFORM;   // Slot in the tree's transform system
         bool isInTree = false;
+        PhysicsWorld* physicsWorld = nullptr;   // The world with the body that moves this node, if there is one
+        BodyID physicsBody = NULL_BODY;
         //SceneTree* registeredTree = nullptr; // TODO: Make this a pointer to the scene tree
 
+        static void OnLocalTransformChanged(void* node);
+        void MarkSubtreeDirty();
+        uint32_t GetWorldVersion();
+
     public:
         std::string name;
         Node();
         Node(std::string name);
         ~Node();
+        // Nodes are referenced by address (children, transform callbacks), so they can't be copied
+        Node(const Node&) = delete;
+        Node& operator=(const Node&) = delete;
+
+        // Frees a node however it was allocated (back to its pool, or delete). Also frees its children
+        static void Destroy(Node* node);
 
         void OnTreeEnter();
         void OnTreeExit();
-        //virtual void EnterTree(SceneTree* tree);
-        //virtual void ExitTree();
+        void EnterTree(SceneTree* tree) override;
+        void ExitTree() override;
         int GetNodeID();
         // Heirarchy access
         Node* GetParent();
@@ -46,18 +72,27 @@ namespace Astrocore
         Node* GetChildAtIndex(int index);
         void AddChild(Node* newChild);
         void RemoveChild(Node* childToRemove);
+        // Makes room for children up front, e.g. when loading a scene that knows how many there will be
+        inline void ReserveChildren(size_t count) { children.reserve(count); }
 
         inline bool GetInheritsParentTransform() {return inheritParentTransform;}
         void SetInheritsParentTransform(bool shouldInheritParentTransform);
-        inline void SetIsWorldMatrixDirty(bool isWorldMatrixDirty){ this->isWorldMatrixDirty = isWorldMatrixDirty; }
+        // Note: Marking dirty also marks every descendant, setting it to false does nothing
+        inline void SetIsWorldMatrixDirty(bool isWorldMatrixDirty){ if(isWorldMatrixDirty) MarkSubtreeDirty(); }
 
         void Update(float deltaTime) override;
-        //void FixedUpdate(float deltaTime) override; // TODO:
+        void FixedUpdate(float deltaTime) override;
         // Transform manipulation
         // TODO: Have the two transforms linked, so updating one also updates the other
         Transform2D* GetTransform(); // Local transform
+        const Transform2D* GetTransformConst() const; // Local transform, read-only
         Transform2D GetWorldTransform();   // Worldspace transform
+        Affine2D GetWorldAffine();         // Worldspace transform, without decomposing it
+
 
+        // The number of world transforms recomputed by nodes outside of a tree (in-tree
+        // nodes are counted by the tree's TransformSystem)
+        static inline size_t GetWorldRecomputeCount() { return WORLD_RECOMPUTE_COUNT; }
 
         // Operator overload
         inline bool operator==(Node& other){return other.GetNodeID() == nodeID; }
@@ -14,11 +14,16 @@
 namespace Astrocore
 {
     struct Shape;
+    class ShapeBatch;
     // A node that draws geometric shapes
     class ShapeNode : public Node
     {
     private:
         std::vector<Shape> shapesToDraw;
+        Rectangle localBounds = {0, 0, 0, 0};  // Bounds of every shape, in local space
+        bool isLocalBoundsDirty = true;
+
+        void RecalculateLocalBounds();
 
     public:
         ShapeNode();
@@ -26,6 +31,11 @@ namespace Astrocore
         //~ShapeNode();
         void AddShape(Shape newShape);
         void Draw() override;
+        // Tessellate every shape into the batch, in world space
+        void AddToBatch(ShapeBatch* batch);
+        bool GetWorldBounds(Rectangle* outBounds) override;
+        bool GetQueryGeometry(QueryGeometry* outGeometry) override;
+        uint32_t GetMaterialKey() override;
 
     };
 
@@ -39,6 +49,16 @@ struct Shape
     float lineWidth = 1.0f;
     float isClosed = true;
 
+    // Local-space tessellation, only rebuilt when the shape changes
+    // Note: Call MarkDirty() after editing the fields above directly
+    mutable std::vector<Vector2> localTriangles;    // Fill (or thick outline quads), 3 points per triangle
+    mutable std::vector<Vector2> localLines;        // Hairline outline, 2 points per line
+    mutable bool isTessellationDirty = true;
+
+    inline void MarkDirty() { isTessellationDirty = true; }
+    // Rebuilds the cached tessellation if needed
+    void UpdateTessellation() const;
+
     Shape()
     {
         points = std::vector<Vector2>();
@@ -57,6 +77,7 @@ struct Shape
         points.push_back({-height, width});
         points.push_back({-height, -width});
         points.push_back({height, -width});
+        isTessellationDirty = true;
         return *this;
     }
 
@@ -70,6 +91,7 @@ struct Shape
             currAngle = i * pointOffset;
             points.push_back({cos(currAngle) * radius, sin(currAngle)* radius});
         }
+        isTessellationDirty = true;
 
         return *this;
     }
@@ -77,11 +99,13 @@ struct Shape
     Shape SetFilled(bool isFilled)
     {
         this->isFilled = isFilled;
+        isTessellationDirty = true;
         return *this;
     }
     Shape SetLineThickness(float newThick)
     {
         lineWidth = newThick;
+        isTessellationDirty = true;
         return *this;
     }
 
@@ -90,6 +114,7 @@ struct Shape
     {
         this->points.clear();
         points = newPoints;
+        isTessellationDirty = true;
         return *this;
     }
 
@@ -1,20 +1,34 @@
 #ifndef TREENODE_H
 #define TREENODE_H
 #include "../component/signaler.h"
+#include "../systems/nodetable.h"
+#include <cstdint>
+
+#ifndef RAYLIB_H
+#include <raylib.h>
+#endif // !RAYLIB_H
 
 namespace Astrocore
 {
     // An object that is able to be registered/interacted with in a tree
     class SceneTree; // Forward declaration
+    struct QueryGeometry;
     class TreeNode : public Signaler, Observer
     {
+        friend class SceneTree;
+        friend class RenderQueue;
     private:
         bool isInTree = false;
+        NodeHandle treeHandle;  // Handle in the tree's node table
+        int spatialProxy = -1;  // ID of the node's entry in the tree's spatial index
         
     protected:
         SceneTree* registeredTree = nullptr; // TODO: Make this a pointer to the scene tree
         bool isDrawn = false;
-        int zIndex = 0;
+        int zIndex = 0;             // Higher values are drawn on top, within the same render layer
+        uint8_t renderLayer = 0;    // Higher layers are always drawn on top of lower ones
+        uint32_t layerMask = 1;     // Which layers the node is visible on (one bit per layer), see RenderTarget::SetCullMask
+        bool isParallelUpdate = false;
     
     public:
         TreeNode(){};
@@ -22,11 +36,32 @@ namespace Astrocore
         virtual void ExitTree(){};
 
         virtual void Draw(){};
-        void GetZIndex();
+        inline int GetZIndex() { return zIndex; }
+        inline void SetZIndex(int newZIndex) { zIndex = newZIndex; }
+        inline uint8_t GetRenderLayer() { return renderLayer; }
+        inline void SetRenderLayer(uint8_t newLayer) { renderLayer = newLayer; }
+        inline uint32_t GetLayerMask() { return layerMask; }
+        void SetLayerMask(uint32_t newMask);
+        // Nodes that draw with the same material key can share draw state, so they get grouped together
+        virtual uint32_t GetMaterialKey() { return 0; }
         bool IsDrawn() {return isDrawn;};
+        // Gets the world-space bounding box of what the node draws
+        // Returns false if the node doesn't have bounds (it will never be culled)
+        virtual bool GetWorldBounds(Rectangle* outBounds) { return false; };
+        // Adds the world-space outlines that scene queries (raycasts, overlaps, ...) are tested against
+        // Returns false if the node can't be hit by them
+        virtual bool GetQueryGeometry(QueryGeometry* outGeometry) { return false; }
 
         virtual void Update(float deltaTime){};
         virtual void FixedUpdate(float deltaTime){};
+
+        // Opts the node's whole subtree in to being updated on a worker thread, alongside other
+        // parallel subtrees and after the rest of the tree (see SceneTree::Update). Its updates may
+        // only change nodes in the subtree: no adding/removing nodes, no events, and world transforms
+        // read during the update are the ones from before it. Layer masks and shapes can change, but
+        // the spatial index and scene queries only see it once every parallel subtree has finished
+        inline void SetParallelUpdate(bool isParallel) { isParallelUpdate = isParallel; }
+        inline bool IsParallelUpdate() { return isParallelUpdate; }
     };
 }
 
@@ -0,0 +1,264 @@
+#ifndef AABBTREE_H
+#define AABBTREE_H
+
+#include <vector>
+#include <algorithm>
+#include <cmath>
+
+#ifndef RAYLIB_H
+#include <raylib.h>
+#endif // !RAYLIB_H
+
+namespace Astrocore
+{
+    const int NULL_TREE_NODE = -1;
+
+    // A bounding volume hierarchy that stays balanced as boxes are added, moved and removed.
+    // Leaves store a slightly enlarged ('fat') copy of their bounds, so something that only moves
+    // a little each frame doesn't have to be re-inserted every time.
+    class AabbTree
+    {
+    public:
+        struct Aabb
+        {
+            float minX, minY, maxX, maxY;
+        };
+
+    private:
+        struct BoxNode
+        {
+            Aabb bounds;
+            int parent;         // Next free node while the node is unused
+            int child1;
+            int child2;
+            int height;         // Leaves are 0, unused nodes are -1
+            int userData;
+
+            inline bool IsLeaf() const { return child1 == NULL_TREE_NODE; }
+        };
+
+        std::vector<BoxNode> nodes;
+        int root = NULL_TREE_NODE;
+        int freeList = NULL_TREE_NODE;
+        int proxyCount = 0;
+        float margin;
+        size_t reinsertCount = 0;
+
+        int AllocateNode();
+        void FreeNode(int node);
+        void InsertLeaf(int leaf);
+        void RemoveLeaf(int leaf);
+        int Balance(int node);
+
+        static inline Aabb Combine(const Aabb& a, const Aabb& b)
+        {
+            return {fminf(a.minX, b.minX), fminf(a.minY, b.minY), fmaxf(a.maxX, b.maxX), fmaxf(a.maxY, b.maxY)};
+        }
+        static inline float Perimeter(const Aabb& box)
+        {
+            return 2.0f * ((box.maxX - box.minX) + (box.maxY - box.minY));
+        }
+        static inline bool Contains(const Aabb& outer, const Aabb& inner)
+        {
+            return outer.minX <= inner.minX && outer.minY <= inner.minY && inner.maxX <= outer.maxX && inner.maxY <= outer.maxY;
+        }
+
+    public:
+        static inline bool Overlaps(const Aabb& a, const Aabb& b)
+        {
+            return a.minX <= b.maxX && b.minX <= a.maxX && a.minY <= b.maxY && b.minY <= a.maxY;
+        }
+        static inline Aabb FromRectangle(const Rectangle& rect)
+        {
+            return {rect.x, rect.y, rect.x + rect.width, rect.y + rect.height};
+        }
+
+        // Balancing keeps the height around 1.44 * log2(proxies), so this is far more than will ever be needed
+        static const int MAX_DEPTH = 64;
+
+        // margin: How far (in world units) leaves are enlarged by, in every direction
+        AabbTree(float margin = 8.0f);
+
+        /// @brief Add a box to the tree
+        /// @param userData Handed back by the queries
+        /// @return The ID of the new proxy
+        int CreateProxy(const Aabb& bounds, int userData);
+        void DestroyProxy(int proxyID);
+        /// @brief Give a proxy new bounds
+        /// @return TRUE if it had to be re-inserted (it moved out of its fat bounds)
+        bool MoveProxy(int proxyID, const Aabb& bounds);
+
+        inline int GetUserData(int proxyID) const { return nodes[proxyID].userData; }
+        inline const Aabb& GetFatBounds(int proxyID) const { return nodes[proxyID].bounds; }
+        inline int GetProxyCount() const { return proxyCount; }
+        inline int GetHeight() const { return root == NULL_TREE_NODE ? 0 : nodes[root].height; }
+        // Times a proxy has moved out of its fat bounds, since the tree was made
+        inline size_t GetReinsertCount() const { return reinsertCount; }
+
+        /// @brief Visit every proxy whose fat bounds overlap an area
+        /// @param visitor Called as visitor(proxyID), return false to stop the query
+        template <typename Visitor>
+        void Query(const Aabb& area, Visitor&& visitor) const
+        {
+            if(root == NULL_TREE_NODE)
+            {
+                return;
+            }
+            int stack[MAX_DEPTH];     // Depth first, never holds more than the height of the tree + 1
+            int stackSize = 0;
+            stack[stackSize++] = root;
+            while(stackSize > 0)
+            {
+                int index = stack[--stackSize];
+                const BoxNode& node = nodes[index];
+                if(!Overlaps(node.bounds, area))
+                {
+                    continue;
+                }
+                if(node.IsLeaf())
+                {
+                    if(!visitor(index))
+                    {
+                        return;
+                    }
+                }
+                else
+                {
+                    stack[stackSize++] = node.child1;
+                    stack[stackSize++] = node.child2;
+                }
+            }
+        }
+
+        /// @brief Visit the proxies whose fat bounds a ray passes through, roughly nearest first
+        /// @param maxFraction How far along the ray to go, as a multiple of direction
+        /// @param visitor Called as visitor(proxyID, maxFraction), returns the new maxFraction
+        /// (e.g. the fraction of a hit to only look for closer ones, or 0 to stop)
+        template <typename Visitor>
+        void RayCast(Vector2 origin, Vector2 direction, float maxFraction, Visitor&& visitor) const
+        {
+            if(root == NULL_TREE_NODE)
+            {
+                return;
+            }
+            float inverseX = direction.x != 0 ? 1.0f / direction.x : INFINITY;
+            float inverseY = direction.y != 0 ? 1.0f / direction.y : INFINITY;
+
+            int stack[MAX_DEPTH];
+            int stackSize = 0;
+            stack[stackSize++] = root;
+            while(stackSize > 0)
+            {
+                int index = stack[--stackSize];
+                const BoxNode& node = nodes[index];
+                if(RayEntry(node.bounds, origin, inverseX, inverseY, maxFraction) > maxFraction)
+                {
+                    continue;
+                }
+                if(node.IsLeaf())
+                {
+                    maxFraction = visitor(index, maxFraction);
+                    if(maxFraction <= 0)
+                    {
+                        return;
+                    }
+                }
+                else
+                {
+                    // Whichever child the ray enters first goes on top, so hits there can cut the search short
+                    float entry1 = RayEntry(nodes[node.child1].bounds, origin, inverseX, inverseY, maxFraction);
+                    float entry2 = RayEntry(nodes[node.child2].bounds, origin, inverseX, inverseY, maxFraction);
+                    stack[stackSize++] = entry1 <= entry2 ? node.child2 : node.child1;
+                    stack[stackSize++] = entry1 <= entry2 ? node.child1 : node.child2;
+                }
+            }
+        }
+
+        /// @brief Visit proxies in order of how close their fat bounds are to a point
+        /// @param maxDistanceSquared Nothing further away than this is visited
+        /// @param visitor Called as visitor(proxyID, maxDistanceSquared), returns the new maxDistanceSquared
+        template <typename Visitor>
+        void QueryNearest(Vector2 point, float maxDistanceSquared, Visitor&& visitor) const
+        {
+            if(root == NULL_TREE_NODE)
+            {
+                return;
+            }
+            // Best first, closest box on top of the heap
+            struct Candidate
+            {
+                float distanceSquared;
+                int node;
+                inline bool operator<(const Candidate& other) const { return distanceSquared > other.distanceSquared; }
+            };
+            std::vector<Candidate> heap;
+            heap.reserve(64);
+            heap.push_back({DistanceSquared(nodes[root].bounds, point), root});
+            while(!heap.empty())
+            {
+                std::pop_heap(heap.begin(), heap.end());
+                Candidate candidate = heap.back();
+                heap.pop_back();
+                if(candidate.distanceSquared > maxDistanceSquared)
+                {
+                    return;
+                }
+                const BoxNode& node = nodes[candidate.node];
+                if(node.IsLeaf())
+                {
+                    maxDistanceSquared = visitor(candidate.node, maxDistanceSquared);
+                    continue;
+                }
+                for(int child : {node.child1, node.child2})
+                {
+                    float distanceSquared = DistanceSquared(nodes[child].bounds, point);
+                    if(distanceSquared <= maxDistanceSquared)
+                    {
+                        heap.push_back({distanceSquared, child});
+                        std::push_heap(heap.begin(), heap.end());
+                    }
+                }
+            }
+        }
+
+        // How far along a ray (as a multiple of its direction) it enters a box, or INFINITY if it misses
+        static inline float RayEntry(const Aabb& box, Vector2 origin, float inverseX, float inverseY, float maxFraction)
+        {
+            float t1 = (box.minX - origin.x) * inverseX;
+            float t2 = (box.maxX - origin.x) * inverseX;
+            float t3 = (box.minY - origin.y) * inverseY;
+            float t4 = (box.maxY - origin.y) * inverseY;
+            // Zero direction on an axis: inside the slab it's all of the ray, outside it none
+            if(inverseX == INFINITY)
+            {
+                if(origin.x < box.minX || origin.x > box.maxX)
+                {
+                    return INFINITY;
+                }
+                t1 = -INFINITY;
+                t2 = INFINITY;
+            }
+            if(inverseY == INFINITY)
+            {
+                if(origin.y < box.minY || origin.y > box.maxY)
+                {
+                    return INFINITY;
+                }
+                t3 = -INFINITY;
+                t4 = INFINITY;
+            }
+            float entry = fmaxf(fmaxf(fminf(t1, t2), fminf(t3, t4)), 0.0f);
+            float exit = fminf(fminf(fmaxf(t1, t2), fmaxf(t3, t4)), maxFraction);
+            return entry <= exit ? entry : INFINITY;
+        }
+
+        static inline float DistanceSquared(const Aabb& box, Vector2 point)
+        {
+            float dx = fmaxf(fmaxf(box.minX - point.x, point.x - box.maxX), 0.0f);
+            float dy = fmaxf(fmaxf(box.minY - point.y, point.y - box.maxY), 0.0f);
+            return dx * dx + dy * dy;
+        }
+    };
+}
+
+#endif // !AABBTREE
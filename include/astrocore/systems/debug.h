@@ -2,62 +2,139 @@
 #define DEBUG_H
 
 #include <spdlog/spdlog.h>
+#include <spdlog/async.h>
 #include <spdlog/sinks/stdout_color_sinks.h>
 #include <spdlog/sinks/basic_file_sink.h>
+#include "profiler.h"
+
+// The lowest level that gets compiled in (one of the SPDLOG_LEVEL_* values). Anything below it
+// compiles to nothing, arguments included. Debug logs are left out of release builds by default
+#ifndef ASTROCORE_LOG_LEVEL
+#ifdef NDEBUG
+#define ASTROCORE_LOG_LEVEL SPDLOG_LEVEL_INFO
+#else
+#define ASTROCORE_LOG_LEVEL SPDLOG_LEVEL_DEBUG
+#endif
+#endif // !ASTROCORE_LOG_LEVEL
 
 namespace Astrocore
 {
     class Debug
     {
+    private:
+        static constexpr const char* LOGGER_NAME = "astrocore";
+        static constexpr size_t QUEUE_SIZE = 8192;   // Messages waiting to be written, the oldest get dropped past this
+
+        // Owned here (instead of by spdlog's registry) so Shutdown() can drain it
+        inline static std::shared_ptr<spdlog::details::thread_pool> threadPool;
 
     public:
+        /// @brief Log to the console and debug_log.txt from a background thread, so logging never
+        /// waits on I/O. Does nothing if it's already set up
         static void init()
         {
+            if(threadPool != nullptr)
+            {
+                return;
+            }
             try
             {
-                //auto logger = spdlog::basic_logger_mt("basic_logger", "basic-log.txt");
-                //spdlog::set_default_logger(logger);
-                //spdlog::info("Initialized logger!");
-
                 auto console_sink = std::make_shared<spdlog::sinks::stdout_color_sink_mt>();
-                console_sink->set_level(spdlog::level::debug);
-
                 auto file_sink = std::make_shared<spdlog::sinks::basic_file_sink_mt>("debug_log.txt", true);
-                file_sink->set_level(spdlog::level::debug);
 
-                spdlog::logger logger("multi_sink", {console_sink, file_sink});
-                logger.set_level(spdlog::level::debug);
-                //logger.warn("this should appear in both console and file");
-                //logger.info("this message should not appear in the console, only in the file");
+                threadPool = std::make_shared<spdlog::details::thread_pool>(QUEUE_SIZE, 1);
+                // Note: A full queue overwrites the oldest message rather than blocking the frame
+                auto logger = std::make_shared<spdlog::async_logger>(LOGGER_NAME, spdlog::sinks_init_list{console_sink, file_sink},
+                                                                     threadPool, spdlog::async_overflow_policy::overrun_oldest);
+                logger->set_level((spdlog::level::level_enum)ASTROCORE_LOG_LEVEL);
+                logger->flush_on(spdlog::level::err);
+                spdlog::set_default_logger(logger);
             }
             catch (const spdlog::spdlog_ex &ex)
             {
-                spdlog::error("Log init failed: " + std::string(ex.what()));
+                threadPool.reset();
+                spdlog::error("Log init failed: {}", ex.what());
             }
             spdlog::set_pattern("[%H:%M:%S] %^%l%$ %v");
         }
-        // Log a line to the console/file log
-        static inline void LogLine(std::string logEntry)
+
+        /// @brief Write out everything still queued, and go back to logging synchronously to the console
+        static void Shutdown()
+        {
+            if(threadPool == nullptr)
+            {
+                return;
+            }
+            auto consoleLogger = std::make_shared<spdlog::logger>("astrocore_console", std::make_shared<spdlog::sinks::stdout_color_sink_mt>());
+            consoleLogger->set_level((spdlog::level::level_enum)ASTROCORE_LOG_LEVEL);
+            consoleLogger->set_pattern("[%H:%M:%S] %^%l%$ %v");
+            spdlog::set_default_logger(consoleLogger);
+
+            // The pool's worker finishes the queue before it's joined
+            threadPool.reset();
+        }
+
+        // Log a line to the console/file log. Takes a message, or an fmt format string and its
+        // arguments (formatted on the calling thread, but only if the level is enabled)
+        template <typename... Args>
+        static inline void LogLine(Args&&... args)
         {
-            spdlog::info(logEntry);
-        };
+            spdlog::default_logger_raw()->info(std::forward<Args>(args)...);
+        }
 
-        static inline void LogWarning(std::string warningEntry)
+        template <typename... Args>
+        static inline void LogDebug(Args&&... args)
         {
-            spdlog::warn(warningEntry);
+            spdlog::default_logger_raw()->debug(std::forward<Args>(args)...);
         }
 
-        static inline void LogError(std::string errorEntry)
+        template <typename... Args>
+        static inline void LogWarning(Args&&... args)
         {
-            spdlog::error(errorEntry);
+            spdlog::default_logger_raw()->warn(std::forward<Args>(args)...);
+        }
+
+        template <typename... Args>
+        static inline void LogError(Args&&... args)
+        {
+            spdlog::default_logger_raw()->error(std::forward<Args>(args)...);
         }
-        // TODO: Add writing to files
         // TODO: Add assert functionality
     };
 }
 
 // Macros
+#if ASTROCORE_LOG_LEVEL <= SPDLOG_LEVEL_DEBUG
+#define DBG_DEBUG(...) ::Astrocore::Debug::LogDebug(__VA_ARGS__)
+#else
+#define DBG_DEBUG(...) ((void)0)
+#endif
+#if ASTROCORE_LOG_LEVEL <= SPDLOG_LEVEL_INFO
 #define DBG_LOG(...) ::Astrocore::Debug::LogLine(__VA_ARGS__)
+#else
+#define DBG_LOG(...) ((void)0)
+#endif
+#if ASTROCORE_LOG_LEVEL <= SPDLOG_LEVEL_WARN
 #define DBG_WARN(...) ::Astrocore::Debug::LogWarning(__VA_ARGS__)
+#else
+#define DBG_WARN(...) ((void)0)
+#endif
+#if ASTROCORE_LOG_LEVEL <= SPDLOG_LEVEL_ERROR
 #define DBG_ERR(...) ::Astrocore::Debug::LogError(__VA_ARGS__)
+#else
+#define DBG_ERR(...) ((void)0)
+#endif
+
+// Profiling (only with ASTROCORE_PROFILING defined, otherwise these compile to nothing)
+#ifdef ASTROCORE_PROFILING
+#define DBG_PROFILE_CONCAT_INNER(a, b) a##b
+#define DBG_PROFILE_CONCAT(a, b) DBG_PROFILE_CONCAT_INNER(a, b)
+// Times the rest of the enclosing scope under this name (a string literal, or from Profiler::InternName())
+#define DBG_PROFILE_ZONE(name) ::Astrocore::ProfileZone DBG_PROFILE_CONCAT(profileZone, __LINE__)(name)
+// Marks the end of a frame, collecting the zones recorded during it
+#define DBG_PROFILE_FRAME() ::Astrocore::Profiler::EndFrame()
+#else
+#define DBG_PROFILE_ZONE(name) ((void)0)
+#define DBG_PROFILE_FRAME() ((void)0)
+#endif
 #endif
\ No newline at end of file
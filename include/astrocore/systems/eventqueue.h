@@ -0,0 +1,69 @@
+#ifndef EVENTQUEUE_H
+#define EVENTQUEUE_H
+
+#include <vector>
+#include <cstdint>
+#include <cstddef>
+#include "../component/eventid.h"
+
+namespace Astrocore
+{
+    class Signaler;
+
+    struct QueuedEvent
+    {
+        Signaler* sender;
+        EventID eventID;
+        uint32_t sequence;  // Position in the queue, keeps the order when the batch is sorted
+    };
+
+    // Holds deferred events until Flush(), which Game::Run calls once a frame.
+    // Flushing dispatches the whole batch grouped by event ID, optionally dropping
+    // duplicates, and any subscription changes made along the way are applied afterwards.
+    class EventQueue
+    {
+    private:
+        std::vector<QueuedEvent> ring;      // Capacity is always a power of 2
+        size_t head = 0;
+        size_t count = 0;
+        std::vector<QueuedEvent> batch;     // The events being flushed, reused every flush
+        std::vector<uint8_t> coalescedEvents;   // Indexed by event ID
+        std::vector<Signaler*> pendingSignalers;    // Have subscription changes to apply after the flush
+        bool isFlushing = false;
+        size_t lastQueuedCount = 0;
+        size_t lastDispatchedCount = 0;
+        inline static uint64_t COALESCE_STAMP = 0;     // Shared by every queue, so stamps never clash
+
+        void Grow();
+
+    public:
+        EventQueue(size_t initialCapacity = 1024);
+
+        // The queue used by signalers and flushed by the game loop
+        static EventQueue& GetMain();
+
+        void Push(Signaler* sender, EventID eventID);
+        // Drops every queued event from a signaler (e.g. because it's being destroyed)
+        void Cancel(Signaler* sender);
+
+        /// @brief Dispatch everything queued so far
+        /// Events queued while flushing are left for the next flush
+        void Flush();
+
+        // Coalesced events are only dispatched once per sender per flush, however many times they were queued
+        void SetCoalesced(EventID eventID, bool shouldCoalesce);
+        bool IsCoalesced(EventID eventID);
+
+        inline bool IsFlushing() { return isFlushing; }
+        inline size_t GetQueuedCount() { return count; }
+        // Events taken from the queue by the last flush, and how many were dispatched after coalescing
+        inline size_t GetLastQueuedCount() { return lastQueuedCount; }
+        inline size_t GetLastDispatchedCount() { return lastDispatchedCount; }
+
+        // Used by signalers to have their subscription changes applied when the flush ends
+        void AddPendingSignaler(Signaler* signaler);
+        void RemovePendingSignaler(Signaler* signaler);
+    };
+}
+
+#endif // !EVENTQUEUE
@@ -0,0 +1,79 @@
+#ifndef FIXEDTIMESTEP_H
+#define FIXEDTIMESTEP_H
+
+namespace Astrocore
+{
+    // Accumulates variable frame times and hands them back out as a whole number
+    // of fixed-size simulation steps
+    class FixedTimestep
+    {
+    private:
+        float stepSize = 1.0f / 60.0f;
+        int maxStepsPerFrame = 5;   // Caps catch-up so a slow frame can't snowball
+        double accumulator = 0;     // Double so long sessions don't drift
+        float alpha = 0;
+
+    public:
+        FixedTimestep(){};
+        FixedTimestep(float stepSize, int maxStepsPerFrame)
+        {
+            SetStepSize(stepSize);
+            SetMaxStepsPerFrame(maxStepsPerFrame);
+        }
+
+        /// @brief Add a frame's worth of time to the accumulator
+        /// @param frameTime The (variable) time the last frame took, in seconds
+        /// @return The number of fixed steps that should be run this frame
+        int Advance(float frameTime)
+        {
+            if (frameTime > 0)
+            {
+                accumulator += frameTime;
+            }
+
+            int steps = 0;
+            while (accumulator >= stepSize && steps < maxStepsPerFrame)
+            {
+                accumulator -= stepSize;
+                steps++;
+            }
+
+            // Still behind after the max amount of steps: drop the backlog instead
+            // of trying to catch up next frame (and falling further behind)
+            if (accumulator >= stepSize)
+            {
+                accumulator = 0;
+            }
+
+            alpha = (float)(accumulator / stepSize);
+            return steps;
+        }
+
+        void Reset()
+        {
+            accumulator = 0;
+            alpha = 0;
+        }
+
+        void SetStepSize(float newStepSize)
+        {
+            if (newStepSize > 0)
+            {
+                stepSize = newStepSize;
+            }
+        }
+
+        void SetMaxStepsPerFrame(int newMaxSteps)
+        {
+            maxStepsPerFrame = newMaxSteps < 1 ? 1 : newMaxSteps;
+        }
+
+        inline float GetStepSize() { return stepSize; }
+        inline int GetMaxStepsPerFrame() { return maxStepsPerFrame; }
+
+        // How far (0-1) we are between the last fixed step and the next one
+        inline float GetAlpha() { return alpha; }
+    };
+}
+
+#endif // !FIXEDTIMESTEP
@@ -0,0 +1,95 @@
+#ifndef FRAMETIMEHISTOGRAM_H
+#define FRAMETIMEHISTOGRAM_H
+
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <ostream>
+#include <vector>
+
+namespace Astrocore
+{
+    // Collects frame times into log-spaced buckets (about 4% wide), so runs can be compared by
+    // their percentiles without keeping every sample around
+    class FrameTimeHistogram
+    {
+    private:
+        static constexpr double MIN_MS = 0.001;     // The first bucket holds everything up to this
+        static const int BUCKETS_PER_DOUBLING = 16;
+        static const int BUCKET_COUNT = 25 * BUCKETS_PER_DOUBLING;  // Up to about 33 seconds
+
+        std::vector<uint32_t> buckets = std::vector<uint32_t>(BUCKET_COUNT, 0);
+        uint64_t sampleCount = 0;
+        double totalMs = 0;
+        double minMs = 0;
+        double maxMs = 0;
+
+        static inline double GetBucketUpperMs(int bucket) { return MIN_MS * std::exp2((double)bucket / BUCKETS_PER_DOUBLING); }
+
+    public:
+        void AddSample(double ms)
+        {
+            int bucket = ms <= MIN_MS ? 0 : (int)std::ceil(std::log2(ms / MIN_MS) * BUCKETS_PER_DOUBLING);
+            buckets[bucket < BUCKET_COUNT ? bucket : BUCKET_COUNT - 1]++;
+
+            minMs = sampleCount == 0 || ms < minMs ? ms : minMs;
+            maxMs = sampleCount == 0 || ms > maxMs ? ms : maxMs;
+            totalMs += ms;
+            sampleCount++;
+        }
+
+        void Clear()
+        {
+            std::fill(buckets.begin(), buckets.end(), 0);
+            sampleCount = 0;
+            totalMs = 0;
+            minMs = 0;
+            maxMs = 0;
+        }
+
+        /// @brief Get the frame time that the given fraction of frames were at or under
+        /// @param fraction 0-1, e.g. 0.99 for the 99th percentile
+        /// @return The upper edge of the bucket it falls in, in milliseconds
+        double GetPercentile(double fraction)
+        {
+            if (sampleCount == 0)
+            {
+                return 0;
+            }
+            uint64_t target = (uint64_t)std::ceil(fraction * sampleCount);
+            uint64_t seen = 0;
+            for (int bucket = 0; bucket < BUCKET_COUNT; bucket++)
+            {
+                seen += buckets[bucket];
+                if (seen >= target && seen > 0)
+                {
+                    double upper = GetBucketUpperMs(bucket);
+                    return upper < maxMs ? upper : maxMs;
+                }
+            }
+            return maxMs;
+        }
+
+        inline uint64_t GetSampleCount() { return sampleCount; }
+        inline double GetMeanMs() { return sampleCount > 0 ? totalMs / sampleCount : 0; }
+        inline double GetMinMs() { return minMs; }
+        inline double GetMaxMs() { return maxMs; }
+        inline double GetTotalMs() { return totalMs; }
+
+        // Writes a summary, then every non-empty bucket as "upper ms,count" lines, for diffing between builds
+        void Write(std::ostream& stream)
+        {
+            stream << "# frames " << sampleCount << " mean_ms " << GetMeanMs() << " p50_ms " << GetPercentile(0.5)
+                   << " p90_ms " << GetPercentile(0.9) << " p99_ms " << GetPercentile(0.99) << " max_ms " << maxMs << "\n";
+            for (int bucket = 0; bucket < BUCKET_COUNT; bucket++)
+            {
+                if (buckets[bucket] > 0)
+                {
+                    stream << GetBucketUpperMs(bucket) << "," << buckets[bucket] << "\n";
+                }
+            }
+        }
+    };
+}
+
+#endif // !FRAMETIMEHISTOGRAM
@@ -3,6 +3,14 @@
 #include <string>
 #include "scenetree.h"
 #include "rendering/renderer.h"
+#include "rendering/nullrenderbackend.h"
+#include "fixedtimestep.h"
+#include "eventqueue.h"
+#include "input/input.h"
+#include "input/inputrecording.h"
+#include "frametimehistogram.h"
+#include "physics/physicsworld.h"
+#include "resourcemanager.h"
 #include "debug.h"
 
 namespace Astrocore
@@ -11,16 +19,47 @@ namespace Astrocore
     {
     private:
         inline static std::unique_ptr<SceneTree> sceneTree = std::unique_ptr<SceneTree>(new SceneTree());
-        static void* physicsSystem; // TODO
+        inline static PhysicsWorld physicsWorld;
         inline static std::unique_ptr<Renderer> renderer = std::unique_ptr<Renderer>(new Renderer()); 
-        
-        
+        inline static FixedTimestep fixedTimestep = FixedTimestep();
+        inline static InputRecorder* inputRecorder = nullptr;
+        inline static JobSystem jobSystem;
+        inline static ResourceManager resourceManager;
+
+        // Everything in a frame except drawing
+        static void Step(float frameTime);
+
     public:
         void Run(); // The main game loop
-        Game(std::string title, int windowWidth, int windowHeight);
+        // Pass a backend to draw with something other than raylib, e.g. a NullRenderBackend to run
+        // without a window (the game takes ownership of it)
+        Game(std::string title, int windowWidth, int windowHeight, RenderBackend* backend = nullptr);
         ~Game();
         static inline SceneTree* GetSceneTree() { return sceneTree.get();};
         static inline Renderer* GetRenderer() { return renderer.get();};
+        // Worker threads for the scene tree's parallel updates, started with the game
+        static inline JobSystem* GetJobSystem() { return &jobSystem; };
+        // Stepped at the start of every fixed update, before the scene's FixedUpdate
+        static inline PhysicsWorld* GetPhysicsWorld() { return &physicsWorld; };
+        // Loads in the background, started with the game and updated at the start of every frame
+        static inline ResourceManager* GetResourceManager() { return &resourceManager; };
+
+        // Record the input of every frame from now on (nullptr to stop)
+        static inline void SetInputRecorder(InputRecorder* recorder) { inputRecorder = recorder; };
+
+        /// @brief Play a recorded session back through the game loop, without a window or drawing, as fast as it'll go
+        /// @param replay The recording, played from its current frame to the end
+        /// @param frameTimes If not null, gets how long each frame took to run
+        /// @param useRecordedFrameTimes Step by the frame times that were recorded, instead of one fixed step per frame
+        /// @return The number of frames played
+        static size_t RunReplay(InputReplay* replay, FrameTimeHistogram* frameTimes = nullptr, bool useRecordedFrameTimes = false);
+
+        // Fixed update timing
+        static inline void SetFixedTimeStep(float stepSize) { fixedTimestep.SetStepSize(stepSize); };
+        static inline float GetFixedTimeStep() { return fixedTimestep.GetStepSize(); };
+        static inline void SetMaxFixedStepsPerFrame(int maxSteps) { fixedTimestep.SetMaxStepsPerFrame(maxSteps); };
+        // Fraction of a fixed step left over this frame, for interpolating between fixed states in Draw
+        static inline float GetInterpolationAlpha() { return fixedTimestep.GetAlpha(); };
     };
 }
 #endif // !GAME
\ No newline at end of file
@@ -2,9 +2,13 @@
 #define INPUT_H
 
 #include <raylib.h>
-#include <map>
+#include <deque>
+#include <unordered_map>
 #include <string>
+#include <string_view>
 #include <vector>
+#include <cstdint>
+#include "inputbackend.h"
 
 
 namespace Astrocore
@@ -28,28 +32,107 @@ namespace Astrocore
         INPUT_TYPE type;
         int id;
         int deviceID = 0; // Only used for joypad inpus
+
+        inline bool operator==(const InputAction& other) const
+        {
+            return type == other.type && id == other.id && deviceID == other.deviceID;
+        }
     };
-    
+
+    // Actions get an ID when they're first bound (or looked up). Query by ID in hot code,
+    // the name versions have to look it up every time.
+    typedef uint32_t ActionID;
+    const ActionID NULL_ACTION = UINT32_MAX;
+
+    // Devices are sampled once a frame (in Update()) into a snapshot, and the queries just read the snapshot.
+    // An action is held if ANY of its bindings is.
+    // Just pressed/released come from the backend's latched presses as well as comparing frames, so a tap
+    // shorter than a frame still counts. During FixedUpdate (between BeginFixedStep() and EndFixedStep())
+    // they're kept until a fixed step has seen them instead: each press shows up in exactly one fixed step,
+    // even when a frame runs several fixed steps or none.
     class Input
     {
+        friend class InputRecorder;
+
         private:
-            static inline std::map<std::string, std::vector<InputAction>> bindings = std::map<std::string, std::vector<InputAction>>();
+            struct ActionBinding
+            {
+                std::string name;
+                std::vector<InputAction> inputs;
+            };
+
+            // Indexed by ActionID. A deque so the names stay put for the lookup below
+            static inline std::deque<ActionBinding> actions = std::deque<ActionBinding>();
+            static inline std::unordered_map<std::string_view, ActionID> actionIDs = std::unordered_map<std::string_view, ActionID>();
+
+            // The bindings compiled down to every distinct input, and which of those each action uses
+            static inline std::vector<InputAction> sources = std::vector<InputAction>();
+            static inline std::vector<uint32_t> actionSourceStarts = std::vector<uint32_t>();   // Action i uses [starts[i], starts[i + 1])
+            static inline std::vector<uint32_t> actionSources = std::vector<uint32_t>();
+            static inline bool isTableDirty = false;
+
+            // The snapshot. Bit i is action i
+            static inline std::vector<float> sourceValues = std::vector<float>();
+            static inline std::vector<uint8_t> sourceEdges = std::vector<uint8_t>();      // SOURCE_PRESSED | SOURCE_RELEASED
+            static inline std::vector<uint64_t> heldBits = std::vector<uint64_t>();
+            static inline std::vector<uint64_t> previousHeldBits = std::vector<uint64_t>();
+            static inline std::vector<uint64_t> pressedBits = std::vector<uint64_t>();
+            static inline std::vector<uint64_t> releasedBits = std::vector<uint64_t>();
+            static inline std::vector<float> strengths = std::vector<float>();
+
+            // Edges since the last fixed step, and whether the queries should read them right now
+            static inline std::vector<uint64_t> fixedPressedBits = std::vector<uint64_t>();
+            static inline std::vector<uint64_t> fixedReleasedBits = std::vector<uint64_t>();
+            static inline bool isInFixedStep = false;
+
+            static inline RaylibInputBackend defaultBackend = RaylibInputBackend();
+            static inline InputBackend* backend = &defaultBackend;
+
+            static void CompileBindings();
+            static float SampleSource(InputBackend* from, const InputAction& source);
+            static uint8_t SampleSourceEdges(InputBackend* from, const InputAction& source);
+            static inline bool TestBit(const std::vector<uint64_t>& bits, ActionID action)
+            {
+                return (action >> 6) < bits.size() && (bits[action >> 6] >> (action & 63)) & 1;
+            }
 
         public:
-            static bool IsActionHeld(std::string actionName);
-            static bool IsActionJustReleased(std::string actionName);
-            static bool IsActionJustPressed(std::string actionName);
+            // Samples every bound input. Called by the game loop at the start of every frame
+            static void Update();
+
+            // Called by the game loop around every fixed step
+            static inline void BeginFixedStep() { isInFixedStep = true; }
+            static void EndFixedStep();
+
+            // Read devices from somewhere else (e.g. a SimulatedInputBackend), or nullptr to go back to raylib
+            static void SetBackend(InputBackend* newBackend);
+            static inline InputBackend* GetBackend() { return backend; }
+
+            /// @brief Get the ID of an action, creating it (with no bindings) if it doesn't exist yet
+            static ActionID GetActionID(std::string_view actionName);
+            // The action's ID, or NULL_ACTION if it doesn't exist
+            static ActionID FindAction(std::string_view actionName);
+
+            static inline bool IsActionHeld(ActionID action) { return TestBit(heldBits, action); }
+            static inline bool IsActionJustPressed(ActionID action) { return TestBit(isInFixedStep ? fixedPressedBits : pressedBits, action); }
+            static inline bool IsActionJustReleased(ActionID action) { return TestBit(isInFixedStep ? fixedReleasedBits : releasedBits, action); }
+            // The strongest of the action's bindings: the axis value furthest from 0, or 1 for a held button
+            static inline float GetActionStrength(ActionID action) { return action < strengths.size() ? strengths[action] : 0.0f; }
+
+            static bool IsActionHeld(std::string_view actionName);
+            static bool IsActionJustReleased(std::string_view actionName);
+            static bool IsActionJustPressed(std::string_view actionName);
 
-            static float GetActionStrength(std::string actionName);
+            static float GetActionStrength(std::string_view actionName);
 
             // Adds a new binding, or a new action if a binding already exists
-            static void AddBinding(std::string name, InputAction newAction);
-            static void RemoveBinding(std::string name, InputAction newAction);
-            static void ClearBinding(std::string name);
-            static std::vector<InputAction> GetAllActions(std::string bindingName);
+            static void AddBinding(std::string_view name, InputAction newAction);
+            static void RemoveBinding(std::string_view name, InputAction newAction);
+            static void ClearBinding(std::string_view name);
+            static std::vector<InputAction> GetAllActions(std::string_view bindingName);
 
             // TODO: Add ability to load from external file
     };
 }
 
-#endif
\ No newline at end of file
+#endif
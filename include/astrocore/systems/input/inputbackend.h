@@ -0,0 +1,75 @@
+#ifndef INPUTBACKEND_H
+#define INPUTBACKEND_H
+
+#include <vector>
+#include <cstdint>
+
+namespace Astrocore
+{
+    // Where Input reads device state from, once a frame
+    class InputBackend
+    {
+    public:
+        virtual ~InputBackend(){};
+        virtual bool IsKeyDown(int key) = 0;
+        virtual bool IsMouseButtonDown(int button) = 0;
+        virtual bool IsGamepadButtonDown(int gamepad, int button) = 0;
+        virtual float GetGamepadAxis(int gamepad, int axis) = 0;
+
+        // Presses and releases since the last frame, even ones that were let go (or pressed again) before it
+        // was sampled. Backends that only know the current state can leave these, Input also compares frames
+        virtual bool IsKeyPressed(int key) { return false; }
+        virtual bool IsKeyReleased(int key) { return false; }
+        virtual bool IsMouseButtonPressed(int button) { return false; }
+        virtual bool IsMouseButtonReleased(int button) { return false; }
+        virtual bool IsGamepadButtonPressed(int gamepad, int button) { return false; }
+        virtual bool IsGamepadButtonReleased(int gamepad, int button) { return false; }
+    };
+
+    // Reads the real devices through raylib (the default)
+    class RaylibInputBackend : public InputBackend
+    {
+    public:
+        bool IsKeyDown(int key) override;
+        bool IsMouseButtonDown(int button) override;
+        bool IsGamepadButtonDown(int gamepad, int button) override;
+        float GetGamepadAxis(int gamepad, int axis) override;
+
+        bool IsKeyPressed(int key) override;
+        bool IsKeyReleased(int key) override;
+        bool IsMouseButtonPressed(int button) override;
+        bool IsMouseButtonReleased(int button) override;
+        bool IsGamepadButtonPressed(int gamepad, int button) override;
+        bool IsGamepadButtonReleased(int gamepad, int button) override;
+    };
+
+    // Device state set by hand, for running without a window (tests, tools, replays)
+    class SimulatedInputBackend : public InputBackend
+    {
+    private:
+        struct GamepadState
+        {
+            std::vector<uint8_t> buttons;
+            std::vector<float> axes;
+        };
+
+        std::vector<uint8_t> keys;
+        std::vector<uint8_t> mouseButtons;
+        std::vector<GamepadState> gamepads;
+
+    public:
+        void SetKeyDown(int key, bool isDown);
+        void SetMouseButtonDown(int button, bool isDown);
+        void SetGamepadButtonDown(int gamepad, int button, bool isDown);
+        void SetGamepadAxis(int gamepad, int axis, float value);
+        // Releases everything
+        void Reset();
+
+        bool IsKeyDown(int key) override;
+        bool IsMouseButtonDown(int button) override;
+        bool IsGamepadButtonDown(int gamepad, int button) override;
+        float GetGamepadAxis(int gamepad, int axis) override;
+    };
+}
+
+#endif // !INPUTBACKEND
@@ -0,0 +1,86 @@
+#ifndef INPUTRECORDING_H
+#define INPUTRECORDING_H
+
+#include <istream>
+#include <ostream>
+#include <vector>
+#include <cstdint>
+#include "input.h"
+#include "inputbackend.h"
+
+namespace Astrocore
+{
+    // Recordings are a header followed by one record per frame:
+    //   float frame time, varint change count, then for each input that changed since the last frame:
+    //   uint8 type (bit 7 set if a button went down), uint8 device, varint id, and a float value for axes.
+    // Only inputs the bindings use are recorded, so replay with the same bindings.
+    // Only each frame's held state is kept, so a tap that didn't last until a frame was sampled won't replay.
+    const char INPUT_RECORDING_MAGIC[4] = {'A', 'S', 'I', 'R'};
+    const uint16_t INPUT_RECORDING_VERSION = 1;
+
+    // Writes the input snapshot of each frame to a stream, as the frame happens
+    class InputRecorder
+    {
+    private:
+        std::ostream* stream = nullptr;
+        SimulatedInputBackend recordedState;    // What a replay's backend will hold after the frames written so far
+        std::vector<InputAction> changedSources;
+        std::vector<float> changedValues;
+        uint32_t frameCount = 0;
+
+    public:
+        InputRecorder(){};
+
+        /// @brief Start a new recording
+        /// @param outputStream Where to write it (opened in binary mode). Must outlive the recording
+        void Begin(std::ostream* outputStream);
+        // Stops recording, and flushes the stream
+        void End();
+        inline bool IsRecording() { return stream != nullptr; }
+
+        // Records the current input snapshot. Called by the game loop after Input::Update()
+        void RecordFrame(float frameTime);
+
+        inline uint32_t GetFrameCount() { return frameCount; }
+    };
+
+    // Plays a recording back through Input, by feeding its backend
+    class InputReplay
+    {
+    private:
+        struct Change
+        {
+            InputAction source;
+            float value;
+        };
+
+        std::vector<float> frameTimes;
+        std::vector<uint32_t> frameChangeStarts;   // Frame i's changes are [starts[i], starts[i + 1])
+        std::vector<Change> changes;
+        SimulatedInputBackend backend;
+        size_t nextFrame = 0;
+
+    public:
+        InputReplay(){};
+
+        /// @brief Read a whole recording into memory
+        /// @return FALSE if the stream isn't a valid recording (nothing is loaded)
+        bool Load(std::istream& inputStream);
+
+        /// @brief Apply the next frame's input to the backend
+        /// @param frameTime Set to the frame time that was recorded, if not null
+        /// @return FALSE once every frame has been played
+        bool NextFrame(float* frameTime);
+        // Back to the start, with every input released
+        void Rewind();
+
+        // Hand this to Input::SetBackend() to replay through Input
+        inline InputBackend* GetBackend() { return &backend; }
+        inline size_t GetFrameCount() { return frameTimes.size(); }
+        inline size_t GetCurrentFrame() { return nextFrame; }
+        // The total time the recorded session took, in seconds
+        double GetRecordedDuration();
+    };
+}
+
+#endif // !INPUTRECORDING
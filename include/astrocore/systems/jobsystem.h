@@ -0,0 +1,122 @@
+#ifndef JOBSYSTEM_H
+#define JOBSYSTEM_H
+
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace Astrocore
+{
+    typedef void (*JobFunction)(void* data);
+
+    // Counts the unfinished jobs of a batch, see JobSystem::Wait()
+    class JobCounter
+    {
+        friend class JobSystem;
+
+    private:
+        std::atomic<int> pending = 0;
+
+    public:
+        inline bool IsDone() { return pending.load(std::memory_order_acquire) == 0; }
+    };
+
+    struct Job
+    {
+        JobFunction function;
+        void* data;
+        JobCounter* counter;
+    };
+
+    // Runs jobs on a fixed set of worker threads. Every thread has its own queue: jobs are
+    // taken from the back of the local queue (newest first, still hot in cache), and an idle
+    // thread steals from the front of someone else's (oldest first, usually the biggest work).
+    // Waiting on a counter runs jobs instead of blocking, so the waiting thread helps finish
+    // its own batch, and with no workers at all everything just runs there.
+    class JobSystem
+    {
+    private:
+        // A ring of jobs, grown when full. The owning thread pushes and pops the back, thieves take the front
+        struct WorkerQueue
+        {
+            std::mutex mutex;
+            std::vector<Job> jobs;  // Capacity is always a power of 2
+            size_t head = 0;        // Oldest job
+            size_t tail = 0;        // One past the newest job
+        };
+
+        std::vector<std::unique_ptr<WorkerQueue>> queues;   // [0] belongs to the thread that called Start()
+        std::vector<std::thread> workers;
+        std::atomic<bool> isRunning = false;
+        std::atomic<int> queuedJobCount = 0;
+        std::mutex sleepMutex;
+        std::condition_variable wakeCondition;
+
+        inline static thread_local JobSystem* currentSystem = nullptr;
+        inline static thread_local size_t currentQueue = 0;
+
+        void WorkerLoop(size_t queueIndex);
+        bool PopJob(size_t queueIndex, Job* outJob);
+        bool StealJob(size_t thiefIndex, Job* outJob);
+        void RunJob(const Job& job);
+
+    public:
+        JobSystem(){};
+        ~JobSystem();
+        JobSystem(const JobSystem&) = delete;
+        JobSystem& operator=(const JobSystem&) = delete;
+
+        /// @brief Start the worker threads
+        /// @param workerCount Threads to start besides the calling one (-1 for one less than the core count)
+        void Start(int workerCount = -1);
+        // Finishes the jobs already queued, then joins the workers
+        void Stop();
+        inline bool IsRunning() { return isRunning.load(std::memory_order_relaxed); }
+        // Threads that run jobs, including the one that called Start()
+        inline size_t GetThreadCount() { return workers.size() + 1; }
+
+        /// @brief Queue a job to run on any thread
+        /// @param counter Incremented now, decremented once the job has run (can be null)
+        void Submit(JobFunction function, void* data, JobCounter* counter);
+        /// @brief Run queued jobs on this thread until every job counted by the counter has finished
+        void Wait(JobCounter* counter);
+
+        /// @brief Call body(begin, end) over [0, count) in batches spread across the threads, and wait for all of them
+        /// Batches are fixed by count and batchSize, not by the thread count, so the split is the same on every machine
+        template <typename F>
+        void ParallelFor(size_t count, size_t batchSize, F&& body)
+        {
+            struct Batch
+            {
+                F* body;
+                size_t begin;
+                size_t end;
+            };
+
+            batchSize = batchSize > 0 ? batchSize : 1;
+            std::vector<Batch> batches;
+            batches.reserve((count + batchSize - 1) / batchSize);
+            for(size_t begin = 0; begin < count; begin += batchSize)
+            {
+                batches.push_back({&body, begin, begin + batchSize < count ? begin + batchSize : count});
+            }
+
+            JobCounter counter;
+            for(Batch& batch : batches)
+            {
+                Submit([](void* data)
+                {
+                    Batch* batch = (Batch*)data;
+                    (*batch->body)(batch->begin, batch->end);
+                }, &batch, &counter);
+            }
+            Wait(&counter);
+        }
+    };
+}
+
+#endif // !JOBSYSTEM
@@ -0,0 +1,37 @@
+#ifndef MAPPEDFILE_H
+#define MAPPEDFILE_H
+
+#include <string>
+#include <vector>
+#include <cstddef>
+
+namespace Astrocore
+{
+    // A whole file, mapped read-only in to memory (on platforms without mmap it's read in instead).
+    // The contents stay valid until Close(), and are safe to read from any thread
+    class MappedFile
+    {
+    private:
+        const unsigned char* data = nullptr;
+        size_t size = 0;
+        bool isMapped = false;
+        std::vector<unsigned char> buffer;     // Holds the file where it can't be mapped
+
+    public:
+        MappedFile(){};
+        ~MappedFile();
+        MappedFile(const MappedFile&) = delete;
+        MappedFile& operator=(const MappedFile&) = delete;
+
+        /// @brief Map a file, closing whatever was mapped before
+        /// @return FALSE if it couldn't be opened or is empty (the error is logged)
+        bool Open(const std::string& path);
+        void Close();
+        inline bool IsOpen() const { return data != nullptr; }
+
+        inline const unsigned char* GetData() const { return data; }
+        inline size_t GetSize() const { return size; }
+    };
+}
+
+#endif // !MAPPEDFILE
@@ -0,0 +1,246 @@
+#ifndef NODEPOOL_H
+#define NODEPOOL_H
+
+#include <vector>
+#include <memory>
+#include <algorithm>
+#include <utility>
+#include <type_traits>
+#include "../nodes/node.h"
+#include "debug.h"
+
+namespace Astrocore
+{
+    // Something nodes can be allocated from. Node::Destroy() hands pooled nodes back
+    // to their allocator instead of deleting them.
+    class NodeAllocator
+    {
+    protected:
+        static inline void SetAllocator(Node* node, NodeAllocator* allocator) { node->allocator = allocator; }
+        static inline NodeAllocator* GetAllocator(Node* node) { return node->allocator; }
+        static inline const std::vector<Node*>& GetChildren(Node* node) { return node->children; }
+        // Takes every child that came from the allocator out of parent, in one pass
+        static void DetachChildren(Node* parent, NodeAllocator* allocator)
+        {
+            std::vector<Node*>& children = parent->children;
+            children.erase(std::remove_if(children.begin(), children.end(), [allocator](Node* child)
+            {
+                if(child->allocator != allocator)
+                {
+                    return false;
+                }
+                child->parent = nullptr;
+                return true;
+            }), children.end());
+        }
+        // While tearing down, node destructors skip unlinking from their parent/children and the tree
+        static inline void BeginBulkTeardown() { Node::BULK_TEARDOWN_DEPTH++; }
+        static inline void EndBulkTeardown() { Node::BULK_TEARDOWN_DEPTH--; }
+
+    public:
+        virtual ~NodeAllocator(){};
+        // Destroys a node that came from this allocator and frees its memory
+        virtual void Release(Node* node) = 0;
+    };
+
+    // A typed pool of nodes. Memory comes from fixed-size blocks that are never freed
+    // until the pool is, and destroyed nodes go on a free list to be reused, so once
+    // the pool has grown to its peak size, creating/destroying nodes doesn't allocate.
+    template <typename T, size_t BLOCK_SIZE = 256>
+    class NodePool : public NodeAllocator
+    {
+        static_assert(std::is_base_of<Node, T>::value, "NodePool can only hold nodes");
+
+    private:
+        // Storage comes first, so a node's address is also its slot's address
+        struct Slot
+        {
+            alignas(T) unsigned char storage[sizeof(T)];
+            Slot* nextFree;
+            bool isAlive;
+        };
+
+        std::vector<std::unique_ptr<Slot[]>> blocks;
+        Slot* freeList = nullptr;
+        size_t bumpBlock = 0;   // Block that fresh slots are taken from, once the free list is empty
+        size_t bumpIndex = 0;   // Next fresh slot in that block
+        size_t liveCount = 0;
+        std::vector<T*> recycled;   // Parked nodes, still constructed (see Recycle())
+
+        Slot* TakeSlot()
+        {
+            if(freeList != nullptr)
+            {
+                Slot* slot = freeList;
+                freeList = slot->nextFree;
+                return slot;
+            }
+
+            if(bumpBlock < blocks.size() && bumpIndex == BLOCK_SIZE)
+            {
+                bumpBlock++;
+                bumpIndex = 0;
+            }
+            if(bumpBlock == blocks.size())
+            {
+                blocks.push_back(std::unique_ptr<Slot[]>(new Slot[BLOCK_SIZE]));
+                bumpIndex = 0;
+            }
+            return &blocks[bumpBlock][bumpIndex++];
+        }
+
+        void ReturnSlot(Slot* slot)
+        {
+            slot->isAlive = false;
+            slot->nextFree = freeList;
+            freeList = slot;
+            liveCount--;
+        }
+
+    public:
+        NodePool(){};
+        ~NodePool() { DestroyAll(); }
+        NodePool(const NodePool&) = delete;
+        NodePool& operator=(const NodePool&) = delete;
+
+        /// @brief Construct a node in the pool
+        /// @param args Passed on to the node's constructor
+        /// @return The new node. Free it with Node::Destroy() (or Destroy()), not delete
+        template <typename... Args>
+        T* Create(Args&&... args)
+        {
+            Slot* slot = TakeSlot();
+            T* node = new (slot->storage) T(std::forward<Args>(args)...);
+            slot->isAlive = true;
+            liveCount++;
+            SetAllocator(node, this);
+            return node;
+        }
+
+        inline void Destroy(T* node) { Node::Destroy(node); }
+
+        void Release(Node* node) override
+        {
+            Slot* slot = reinterpret_cast<Slot*>(static_cast<T*>(node));
+            if(!slot->isAlive)
+            {
+                DBG_ERR("Releasing a pooled node that was already destroyed");
+                return;
+            }
+            static_cast<T*>(node)->~T();
+            ReturnSlot(slot);
+        }
+
+        // Takes a node out of its parent (and so out of the tree), but keeps it constructed so
+        // Reuse() can hand it back later without running any constructors
+        void Recycle(T* node)
+        {
+            if(node->GetParent() != nullptr)
+            {
+                node->GetParent()->RemoveChild(node);
+            }
+            recycled.push_back(node);
+        }
+
+        // Returns a node previously passed to Recycle(), or null if there aren't any
+        T* Reuse()
+        {
+            if(recycled.empty())
+            {
+                return nullptr;
+            }
+            T* node = recycled.back();
+            recycled.pop_back();
+            return node;
+        }
+
+        // Destroys every node in the pool at once, including recycled ones.
+        // Meant for tearing down a whole scene built from pools: nodes leave the tree, but
+        // don't unlink from each other one by one. Only links that leave the pool are undone
+        // properly: pooled nodes are taken out of parents from elsewhere, and children from
+        // elsewhere are destroyed with Node::Destroy(). The memory goes back by resetting the pool.
+        void DestroyAll()
+        {
+            size_t usedBlocks = blocks.empty() ? 0 : bumpBlock + 1;
+
+            // Undo the links that leave the pool first, while every node is still intact.
+            // Destroying an outside child can destroy pooled nodes under it, so slots are checked as they're reached
+            for(size_t block = 0; block < usedBlocks; block++)
+            {
+                size_t used = block == bumpBlock ? bumpIndex : BLOCK_SIZE;
+                for(size_t i = 0; i < used; i++)
+                {
+                    if(!blocks[block][i].isAlive)
+                    {
+                        continue;
+                    }
+                    T* node = reinterpret_cast<T*>(blocks[block][i].storage);
+                    Node* parent = node->GetParent();
+                    if(parent != nullptr && GetAllocator(parent) != this)
+                    {
+                        // Takes the node's pooled siblings out too, so a big parent is only walked once
+                        DetachChildren(parent, this);
+                    }
+                    // Destroyed children take themselves out of the list
+                    const std::vector<Node*>& children = GetChildren(node);
+                    for(size_t child = 0; child < children.size();)
+                    {
+                        if(GetAllocator(children[child]) != this)
+                        {
+                            Node::Destroy(children[child]);
+                        }
+                        else
+                        {
+                            child++;
+                        }
+                    }
+                }
+            }
+
+            // Leave the tree while every node is still intact (exiting also walks children)
+            for(size_t block = 0; block < usedBlocks; block++)
+            {
+                size_t used = block == bumpBlock ? bumpIndex : BLOCK_SIZE;
+                for(size_t i = 0; i < used; i++)
+                {
+                    if(blocks[block][i].isAlive)
+                    {
+                        reinterpret_cast<T*>(blocks[block][i].storage)->ExitTree();
+                    }
+                }
+            }
+
+            if(!std::is_trivially_destructible<T>::value)
+            {
+                BeginBulkTeardown();
+                for(size_t block = 0; block < usedBlocks; block++)
+                {
+                    size_t used = block == bumpBlock ? bumpIndex : BLOCK_SIZE;
+                    for(size_t i = 0; i < used; i++)
+                    {
+                        if(blocks[block][i].isAlive)
+                        {
+                            reinterpret_cast<T*>(blocks[block][i].storage)->~T();
+                            blocks[block][i].isAlive = false;
+                        }
+                    }
+                }
+                EndBulkTeardown();
+            }
+
+            // Every slot is free again, blocks are kept for reuse
+            freeList = nullptr;
+            bumpBlock = 0;
+            bumpIndex = 0;
+            liveCount = 0;
+            recycled.clear();
+        }
+
+        // The number of constructed nodes (including recycled ones)
+        inline size_t GetLiveCount() { return liveCount; }
+        inline size_t GetRecycledCount() { return recycled.size(); }
+        inline size_t GetCapacity() { return blocks.size() * BLOCK_SIZE; }
+    };
+}
+
+#endif // !NODEPOOL
@@ -0,0 +1,60 @@
+#ifndef NODETABLE_H
+#define NODETABLE_H
+
+#include <vector>
+#include <cstdint>
+#include <cstddef>
+
+namespace Astrocore
+{
+    class TreeNode;
+
+    // Refers to a node in a NodeTable. The generation goes up every time a slot is
+    // reused, so a handle to a node that has since been removed is never valid again.
+    struct NodeHandle
+    {
+        uint32_t index = UINT32_MAX;
+        uint32_t generation = 0;
+
+        inline bool operator==(const NodeHandle& other) const { return index == other.index && generation == other.generation; }
+        inline bool operator!=(const NodeHandle& other) const { return !(*this == other); }
+    };
+    const NodeHandle NULL_NODE_HANDLE = NodeHandle();
+
+    // Tracks a set of nodes without owning them.
+    // Nodes are stored densely (removal swaps the last one into the gap), so iterating
+    // is a plain walk over an array, and adding/removing are both O(1).
+    class NodeTable
+    {
+    private:
+        struct Slot
+        {
+            uint32_t denseIndex = UINT32_MAX;   // Where the node is in 'nodes', or UINT32_MAX if the slot is free
+            uint32_t generation = 0;
+        };
+
+        std::vector<Slot> slots;
+        std::vector<uint32_t> freeSlots;
+        std::vector<TreeNode*> nodes;       // Dense
+        std::vector<uint32_t> denseToSlot;  // Parallel to 'nodes'
+
+    public:
+        NodeTable(){};
+
+        NodeHandle Add(TreeNode* node);
+        // Returns false if the handle was already invalid
+        bool Remove(NodeHandle handle);
+        // Returns the node, or null if the handle is no longer valid
+        TreeNode* Get(NodeHandle handle) const;
+        bool IsValid(NodeHandle handle) const;
+        void Clear();
+
+        inline size_t GetCount() const { return nodes.size(); }
+        // Every node in the table, in no particular order (removal changes the order)
+        inline const std::vector<TreeNode*>& GetNodes() const { return nodes; }
+        inline std::vector<TreeNode*>::const_iterator begin() const { return nodes.begin(); }
+        inline std::vector<TreeNode*>::const_iterator end() const { return nodes.end(); }
+    };
+}
+
+#endif // !NODETABLE
@@ -0,0 +1,185 @@
+#ifndef PACKFILE_H
+#define PACKFILE_H
+
+#include <string>
+#include <string_view>
+#include <vector>
+#include <unordered_set>
+#include <cstdint>
+#include <cstddef>
+
+#ifndef RAYLIB_H
+#include <raylib.h>
+#endif // !RAYLIB_H
+
+#include "mappedfile.h"
+
+namespace Astrocore
+{
+    // Pack files are a header, every entry's data, then the index: an array of entries sorted by the
+    // hash of their path, and the paths themselves (not null terminated). Offsets are from the start of the file.
+    // Compressed entries are split in to chunks that each decompress on their own, so they can be streamed:
+    //   a table of uint64 chunk end offsets (relative to the end of the table), then the chunks.
+    // A chunk that didn't get any smaller is stored as is
+    const char PACK_FILE_MAGIC[4] = {'A', 'P', 'A', 'K'};
+    const uint16_t PACK_FILE_VERSION = 1;
+    const uint32_t PACK_CHUNK_SIZE = 256 * 1024;
+    const uint64_t PACK_DATA_ALIGNMENT = 16;
+
+    enum PACK_COMPRESSION {PACK_STORED, PACK_LZ4, PACK_ZSTD};
+
+    struct PackFileHeader
+    {
+        char magic[4];
+        uint16_t version;
+        uint16_t reserved;
+        uint32_t entryCount;
+        uint32_t chunkSize;         // Uncompressed size of every chunk but the last
+        uint64_t entriesOffset;
+        uint64_t namesOffset;
+        uint32_t nameBytes;
+        uint32_t reserved2;
+    };
+
+    struct PackFileEntry
+    {
+        uint64_t pathHash;
+        uint64_t offset;
+        uint64_t size;              // Uncompressed
+        uint64_t storedSize;        // In the pack, including the chunk table
+        uint32_t nameOffset;
+        uint32_t nameLength;
+        uint8_t compression;        // PACK_COMPRESSION
+        uint8_t reserved[7];
+    };
+
+    // Bytes of an entry, read straight from the mapped pack (a stand-in for std::span, we're on C++17)
+    struct PackView
+    {
+        const unsigned char* data = nullptr;
+        size_t size = 0;
+
+        inline const unsigned char* begin() const { return data; }
+        inline const unsigned char* end() const { return data + size; }
+        inline bool empty() const { return size == 0; }
+    };
+
+    // Pack paths use '/', and a leading "./" is ignored
+    uint64_t HashPackPath(std::string_view path);
+
+    class PackFile;
+
+    // Reads an entry a bit at a time, only decompressing the chunks being read. Can be used from any thread,
+    // but each stream only from one at a time
+    class PackStream
+    {
+        friend class PackFile;
+    private:
+        const PackFile* pack = nullptr;
+        const PackFileEntry* entry = nullptr;
+        uint64_t position = 0;
+        std::vector<unsigned char> chunk;
+        uint64_t chunkIndex = UINT64_MAX;   // The chunk that's decompressed in to 'chunk'
+
+        PackStream(const PackFile* pack, const PackFileEntry* entry) : pack(pack), entry(entry) {};
+
+    public:
+        PackStream(){};
+
+        /// @brief Copy the next bytes of the entry in to buffer
+        /// @return How many bytes were read, less than asked for at the end of the entry (or if it's corrupt)
+        size_t Read(void* buffer, size_t bytes);
+        // FALSE if the position is past the end
+        bool Seek(uint64_t newPosition);
+
+        inline bool IsOpen() const { return entry != nullptr; }
+        inline uint64_t GetPosition() const { return position; }
+        inline uint64_t GetSize() const { return entry != nullptr ? entry->size : 0; }
+        inline bool IsEOF() const { return position >= GetSize(); }
+    };
+
+    // Every asset in one file: opening it is one open() and one mmap(), instead of one (or more) system
+    // calls per asset. Lookups, views, reads and streams don't change the pack, so they're safe from any
+    // thread (e.g. the resource manager's loaders) while it's open
+    class PackFile
+    {
+        friend class PackStream;
+    private:
+        MappedFile file;
+        const PackFileHeader* header = nullptr;
+        const PackFileEntry* entries = nullptr;
+        const char* names = nullptr;
+
+        bool Validate();
+        // Fills output with the entry's (or one chunk's) uncompressed bytes, it has to have room for them
+        bool Decompress(const PackFileEntry* entry, unsigned char* output) const;
+        bool DecompressChunk(const PackFileEntry* entry, uint64_t chunk, unsigned char* output) const;
+
+    public:
+        PackFile(){};
+        PackFile(const PackFile&) = delete;
+        PackFile& operator=(const PackFile&) = delete;
+
+        /// @brief Map a pack file and check its index
+        /// @return FALSE if it couldn't be opened or isn't a valid pack (nothing is kept open)
+        bool Open(const std::string& path);
+        void Close();
+        inline bool IsOpen() const { return header != nullptr; }
+
+        // nullptr if the pack doesn't have the path
+        const PackFileEntry* Find(std::string_view path) const;
+        inline bool Contains(std::string_view path) const { return Find(path) != nullptr; }
+        inline uint32_t GetEntryCount() const { return header != nullptr ? header->entryCount : 0; }
+        inline const PackFileEntry* GetEntry(uint32_t index) const { return &entries[index]; }
+        inline std::string_view GetEntryPath(const PackFileEntry* entry) const { return {names + entry->nameOffset, entry->nameLength}; }
+
+        /// @brief The bytes of a stored (uncompressed) entry, without copying them
+        /// @return An empty view if the entry isn't there or is compressed (read those with Read() or a stream)
+        PackView GetView(std::string_view path) const;
+        /// @brief Decompress (or copy) a whole entry
+        /// @return FALSE if the entry isn't there or is corrupt
+        bool Read(std::string_view path, std::vector<unsigned char>* output) const;
+        /// @brief Read a large entry a bit at a time
+        /// @return A stream that isn't open if the entry isn't there
+        PackStream OpenStream(std::string_view path) const;
+
+        // The raylib loaders, but reading from the pack (through their memory buffer versions).
+        // The file type comes from the path's extension
+        // Like raylib's LoadFileData(), free the result with UnloadFileData()
+        unsigned char* LoadFileData(std::string_view path, int* dataSize) const;
+        Image LoadImage(std::string_view path) const;
+        Wave LoadWave(std::string_view path) const;
+    };
+
+    // Builds a pack file, e.g. from the pack builder tool
+    class PackWriter
+    {
+    private:
+        struct PendingEntry
+        {
+            std::string path;
+            std::string diskPath;       // Read when the pack is written, if there's no data
+            std::vector<unsigned char> data;
+            PACK_COMPRESSION compression;
+        };
+        std::vector<PendingEntry> pending;
+        std::unordered_set<std::string> paths;
+
+        bool AddPending(PendingEntry&& entry);
+
+    public:
+        PackWriter(){};
+
+        /// @brief Add a file from disk (it's read when the pack is written)
+        /// @param compression Entries that don't get smaller are stored instead
+        /// @return FALSE if the pack already has the path
+        bool AddFile(const std::string& path, const std::string& diskPath, PACK_COMPRESSION compression);
+        bool AddData(const std::string& path, const void* data, size_t size, PACK_COMPRESSION compression);
+        inline size_t GetEntryCount() { return pending.size(); }
+
+        /// @return FALSE if a file couldn't be read or the pack couldn't be written
+        bool Write(const std::string& outputPath);
+    };
+}
+
+#endif // !PACKFILE
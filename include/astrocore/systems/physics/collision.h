@@ -0,0 +1,59 @@
+#ifndef COLLISION_H
+#define COLLISION_H
+
+#include <vector>
+
+#ifndef RAYLIB_H
+#include <raylib.h>
+#endif // !RAYLIB_H
+
+namespace Astrocore
+{
+    // A convex polygon in its own local space, centered on its centroid
+    struct ConvexPolygon
+    {
+        std::vector<Vector2> vertices;  // Counter clockwise (with y up), so the normals point out
+        std::vector<Vector2> normals;   // normals[i] belongs to the edge vertices[i] -> vertices[i + 1]
+        Vector2 centroid = {0, 0};      // Where the centroid was in the points it was built from
+        float area = 0;
+        float inertia = 0;              // Rotational inertia about the centroid, at a density of 1
+        float radius = 0;               // Distance to the furthest vertex
+
+        /// @brief Build the convex hull of a set of points (e.g. Shape::points)
+        /// @return FALSE if the points don't enclose any area
+        bool Build(const std::vector<Vector2>& points);
+    };
+
+    // A polygon placed in the world
+    struct PolygonTransform
+    {
+        Vector2 position;
+        float sin;
+        float cos;
+
+        inline Vector2 Apply(Vector2 point) const
+        {
+            return {cos * point.x - sin * point.y + position.x, sin * point.x + cos * point.y + position.y};
+        }
+        inline Vector2 Rotate(Vector2 direction) const
+        {
+            return {cos * direction.x - sin * direction.y, sin * direction.x + cos * direction.y};
+        }
+    };
+
+    struct ContactManifold
+    {
+        Vector2 normal;         // From the first polygon to the second
+        int pointCount = 0;
+        Vector2 points[2];      // World space, on the surface of the second polygon
+        float depths[2];
+    };
+
+    /// @brief Separating axis test between two placed polygons, with up to two contact points
+    /// (the incident edge clipped against the reference face)
+    /// @return FALSE if they don't overlap
+    bool CollidePolygons(const ConvexPolygon& polygonA, const PolygonTransform& transformA,
+                         const ConvexPolygon& polygonB, const PolygonTransform& transformB, ContactManifold* outManifold);
+}
+
+#endif // !COLLISION
@@ -0,0 +1,204 @@
+#ifndef PHYSICSWORLD_H
+#define PHYSICSWORLD_H
+
+#include <vector>
+#include <cstdint>
+#include <cstddef>
+#include <utility>
+#include <unordered_map>
+#include "collision.h"
+
+namespace Astrocore
+{
+    class Node;
+    struct Shape;
+
+    typedef int BodyID;
+    const BodyID NULL_BODY = -1;
+    typedef int PolygonID;
+    const PolygonID NULL_POLYGON = -1;
+
+    enum BODY_TYPE {BODY_STATIC, BODY_KINEMATIC, BODY_DYNAMIC};
+
+    struct BodyDef
+    {
+        BODY_TYPE type = BODY_DYNAMIC;
+        PolygonID polygon = NULL_POLYGON;
+        Vector2 position = {0, 0};      // Where the polygon's origin goes (not its centroid)
+        float angle = 0;
+        Vector2 velocity = {0, 0};
+        float angularVelocity = 0;
+        float density = 1;
+        float friction = 0.5f;
+        float restitution = 0;
+        Node* node = nullptr;           // Gets the body's position and angle after every step (optional, its
+                                        // transform is treated as world space, so keep it at the top of the scene).
+                                        // Destroying the node removes the body, a node can only drive one body
+    };
+
+    // Rigid bodies made of convex polygons, stepped from the game loop's fixed update.
+    // Bodies are stored as parallel arrays (swap-removed, so they stay dense), the broadphase
+    // is a sweep and prune kept sorted between steps, and contacts come from a separating axis
+    // test. Groups of touching bodies that have all been still for a while fall asleep, and cost
+    // nothing until something awake touches them.
+    class PhysicsWorld
+    {
+    private:
+        struct Aabb
+        {
+            float minX, minY, maxX, maxY;
+        };
+
+        struct ContactPoint
+        {
+            Vector2 offsetA;    // From each body's center of mass
+            Vector2 offsetB;
+            Vector2 localAnchorA;   // The touching point on each surface, in body space
+            Vector2 localAnchorB;
+            float depth;
+            float normalMass;
+            float tangentMass;
+            float velocityBias;     // Target separating speed from restitution
+            float normalImpulse;
+            float tangentImpulse;
+        };
+
+        struct Contact
+        {
+            int bodyA;      // Dense indices
+            int bodyB;
+            Vector2 normal;
+            Vector2 localNormal;    // In the first body's space
+            int pointCount;
+            ContactPoint points[2];
+            float friction;
+            bool isBlockSolved;
+            float blockK[3];        // Both points' normal responses to each other's impulses (k11, k12, k22)
+            float blockMass[3];     // And its inverse
+        };
+
+        // What a contact ended the last step with, to start the next step's solve from
+        struct CachedContact
+        {
+            int pointCount;
+            Vector2 localAnchors[2];    // Contact points in the first body's local space
+            float normalImpulses[2];
+            float tangentImpulses[2];
+        };
+
+        // Broadphase entry, kept in order along the sweep axis
+        struct SweepEntry
+        {
+            float min;      // Along the sweep axis
+            float max;
+            float crossMin; // Along the other axis
+            float crossMax;
+            BodyID body;
+            int index;      // Dense index, refreshed every step
+            bool isActive;  // Awake and able to move
+        };
+
+        std::vector<ConvexPolygon> polygons;
+
+        // Body arrays (indexed by dense index)
+        std::vector<Vector2> positions;     // Center of mass
+        std::vector<float> angles;
+        std::vector<Vector2> velocities;
+        std::vector<float> angularVelocities;
+        std::vector<float> inverseMasses;
+        std::vector<float> inverseInertias;
+        std::vector<float> frictions;
+        std::vector<float> restitutions;
+        std::vector<float> sleepTimes;
+        std::vector<Vector2> sleepPositions;   // Where each body was when its sleep timer started
+        std::vector<float> sleepAngles;
+        std::vector<uint8_t> types;
+        std::vector<uint8_t> isAwake;
+        std::vector<PolygonID> bodyPolygons;
+        std::vector<Aabb> bounds;
+        std::vector<Node*> nodes;
+        std::vector<BodyID> indexToID;
+
+        // Sparse ID -> dense index lookup, so IDs stay valid when bodies get moved
+        std::vector<int> idToIndex;
+        std::vector<BodyID> freeIDs;
+        std::vector<BodyID> removedIDs;     // Freed once the broadphase has dropped them
+
+        Vector2 gravity = {0, 980};     // Pixels, y down
+        int velocityIterations = 10;
+
+        // Step scratch, kept so steps don't allocate
+        std::vector<SweepEntry> sweepEntries;
+        bool isSweepingY = false;
+        size_t addedSinceSort = 0;
+        std::vector<std::pair<int, int>> pairs;
+        std::vector<Contact> contacts;
+        std::unordered_map<uint64_t, CachedContact> contactCache;  // Keyed by the two body IDs
+        std::unordered_map<uint64_t, CachedContact> nextContactCache;
+        std::vector<int> islandParents;
+        std::vector<float> islandSleepTimes;
+        size_t sortSwapCount = 0;
+        float maxMovingExtent = 0;      // Largest size along the sweep axis of a body that isn't static
+
+        void UpdateBounds(int index);
+        void UpdateBroadphase();
+        void FindContacts();
+        void WarmStart();
+        void SolveVelocities();
+        void SolveNormalBlock(Contact& contact);
+        void CacheContacts();
+        void CorrectPositions();
+        void UpdateSleep(float deltaTime);
+        void WakeIndex(int index);
+        // Sleeping bodies aren't paired with each other or with static ones, so when a body goes away or
+        // jumps, whatever was resting on it has to be woken up or it would be left hanging
+        void WakeTouching(int index);
+        void SyncNodes();
+        int FindIsland(int index);
+
+    public:
+        PhysicsWorld(){};
+        ~PhysicsWorld();
+        // Nodes point back at the world their body is in
+        PhysicsWorld(const PhysicsWorld&) = delete;
+        PhysicsWorld& operator=(const PhysicsWorld&) = delete;
+
+        /// @brief Add a convex polygon that bodies can use. Polygons live as long as the world
+        /// @param points Any points, the polygon is their convex hull (e.g. Shape::points)
+        /// @return NULL_POLYGON if the points don't enclose any area
+        PolygonID CreatePolygon(const std::vector<Vector2>& points);
+        PolygonID CreatePolygon(const Shape& shape);
+        inline const ConvexPolygon& GetPolygon(PolygonID polygon) { return polygons[polygon]; }
+
+        BodyID AddBody(const BodyDef& def);
+        void RemoveBody(BodyID body);
+        bool IsValid(BodyID body);
+        inline size_t GetBodyCount() { return positions.size(); }
+
+        // Body state. Positions are where the polygon's origin is, like in BodyDef
+        Vector2 GetPosition(BodyID body);
+        float GetAngle(BodyID body);
+        Vector2 GetVelocity(BodyID body);
+        void SetTransform(BodyID body, Vector2 position, float angle);
+        void SetVelocity(BodyID body, Vector2 velocity, float angularVelocity);
+        void ApplyImpulse(BodyID body, Vector2 impulse);
+        bool IsAwake(BodyID body);
+        void Wake(BodyID body);
+
+        inline void SetGravity(Vector2 newGravity) { gravity = newGravity; }
+        inline Vector2 GetGravity() { return gravity; }
+        inline void SetVelocityIterations(int iterations) { velocityIterations = iterations; }
+
+        /// @brief Advance the simulation by one fixed step
+        void Step(float deltaTime);
+
+        // Stats from the last step
+        size_t GetAwakeCount();
+        inline size_t GetPairCount() { return pairs.size(); }
+        inline size_t GetContactCount() { return contacts.size(); }
+        // Broadphase entries that had to move to keep it sorted (low when things move a little each step)
+        inline size_t GetSortSwapCount() { return sortSwapCount; }
+    };
+}
+
+#endif // !PHYSICSWORLD
@@ -0,0 +1,146 @@
+#ifndef PROFILER_H
+#define PROFILER_H
+
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <deque>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <vector>
+
+namespace Astrocore
+{
+    // A finished zone. The name has to outlive the profiler (a string literal, or from Profiler::InternName())
+    struct ZoneEvent
+    {
+        const char* name;
+        uint64_t startNs;
+        uint64_t endNs;
+    };
+
+    // Zones finished on one thread. Only that thread writes, and only the thread calling
+    // Profiler::EndFrame() reads, so neither side ever waits on the other.
+    class ProfileRing
+    {
+        friend class Profiler;
+
+    private:
+        static constexpr size_t CAPACITY = 1 << 14;     // Power of 2. New events get dropped if a frame has more
+
+        std::unique_ptr<ZoneEvent[]> events = std::unique_ptr<ZoneEvent[]>(new ZoneEvent[CAPACITY]);
+        std::atomic<uint64_t> writeCount = 0;
+        std::atomic<uint64_t> readCount = 0;    // Only written by the reader, once it's done with the events before it
+        std::atomic<uint64_t> droppedCount = 0;
+        uint32_t threadID;
+
+    public:
+        ProfileRing(uint32_t threadID) : threadID(threadID){};
+
+        inline void Push(const char* name, uint64_t startNs, uint64_t endNs)
+        {
+            uint64_t index = writeCount.load(std::memory_order_relaxed);
+            // Full: overwriting the oldest event could race with the reader still copying it
+            if(index - readCount.load(std::memory_order_acquire) >= CAPACITY)
+            {
+                droppedCount.fetch_add(1, std::memory_order_relaxed);
+                return;
+            }
+            events[index & (CAPACITY - 1)] = {name, startNs, endNs};
+            writeCount.store(index + 1, std::memory_order_release);
+        }
+    };
+
+    // Collects the zones every thread records, once a frame. Keeps a rolling window of per-zone
+    // frame times for the summary, and (while capturing) every event for a Chrome trace.
+    class Profiler
+    {
+    private:
+        struct ZoneStats
+        {
+            std::string name;
+            std::vector<double> frameMs;    // Time spent in the zone each frame, a ring of WINDOW_FRAMES
+            std::vector<uint32_t> frameCalls;
+            uint64_t firstFrame = 0;
+            double currentMs = 0;
+            uint32_t currentCalls = 0;
+        };
+
+        static constexpr size_t WINDOW_FRAMES = 240;
+        static constexpr size_t MAX_CAPTURED_EVENTS = 1 << 22;
+
+        inline static std::mutex ringsMutex;    // Only held while a thread registers its ring
+        inline static std::vector<std::unique_ptr<ProfileRing>> rings;
+        inline static thread_local ProfileRing* threadRing = nullptr;
+
+        inline static std::mutex namesMutex;
+        inline static std::deque<std::string> internedNames;
+
+        inline static std::vector<ZoneStats> zones;
+        inline static std::unordered_map<std::string_view, size_t> zoneIndices;
+        inline static uint64_t frameCount = 0;
+        inline static uint32_t summaryInterval = 0;
+
+        inline static bool isCapturing = false;
+        inline static std::vector<ZoneEvent> capturedEvents;
+        inline static std::vector<uint32_t> capturedThreads;
+        inline static uint64_t captureStartNs = 0;
+
+        static ProfileRing* RegisterThread();
+        static size_t GetZoneIndex(const char* name);
+
+    public:
+        static inline uint64_t GetTimeNs()
+        {
+            return std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now().time_since_epoch()).count();
+        }
+
+        static inline ProfileRing* GetThreadRing()
+        {
+            return threadRing != nullptr ? threadRing : RegisterThread();
+        }
+
+        // A name that stays valid forever, for zones named at runtime
+        static const char* InternName(std::string_view name);
+
+        /// @brief Collect every thread's zones for the frame that just ended
+        /// Called by the game loop. Zones still open on other threads are counted in the frame they finish in
+        static void EndFrame();
+
+        // Log the summary every this many frames (0 to only print it when asked)
+        static inline void SetSummaryInterval(uint32_t frames) { summaryInterval = frames; }
+        /// @brief Log the min/avg/p99 time spent in each zone per frame, over the last few seconds
+        static void PrintSummary();
+        // The same summary as text, one zone per line
+        static std::string GetSummary();
+
+        // Keeps every zone from now on (up to a limit), for EndCapture()
+        static void BeginCapture();
+        /// @brief Stop capturing, and write what was captured in the Chrome trace event format
+        /// (open it in chrome://tracing or Perfetto)
+        /// @return FALSE if the file couldn't be written
+        static bool EndCapture(std::string path);
+        static inline bool IsCapturing() { return isCapturing; }
+
+        static inline uint64_t GetFrameCount() { return frameCount; }
+    };
+
+    // Times the scope it's declared in (see DBG_PROFILE_ZONE)
+    class ProfileZone
+    {
+    private:
+        const char* name;
+        uint64_t startNs;
+
+    public:
+        ProfileZone(const char* name) : name(name), startNs(Profiler::GetTimeNs()){};
+        ~ProfileZone() { Profiler::GetThreadRing()->Push(name, startNs, Profiler::GetTimeNs()); }
+        ProfileZone(const ProfileZone&) = delete;
+        ProfileZone& operator=(const ProfileZone&) = delete;
+    };
+}
+
+#endif // !PROFILER
@@ -0,0 +1,76 @@
+#ifndef NULLRENDERBACKEND_H
+#define NULLRENDERBACKEND_H
+
+#include <vector>
+#include "renderbackend.h"
+
+namespace Astrocore
+{
+    // A draw call the null backend received
+    struct RecordedDraw
+    {
+        enum DRAW_TYPE {DRAW_VERTICES, DRAW_TEXTURE};
+
+        DRAW_TYPE type;
+        RenderTextureID target;     // What was being drawn to (NULL_RENDER_TEXTURE for the screen)
+        RenderTextureID texture;    // The texture drawn, for DRAW_TEXTURE
+        uint32_t triangleVertexCount;
+        uint32_t lineVertexCount;
+    };
+
+    // No window and no GPU: everything up to the draw calls still runs, and the draw calls are just
+    // recorded (the last frame's are kept). For headless tests, soak runs and benchmarks.
+    class NullRenderBackend : public RenderBackend
+    {
+    private:
+        int screenWidth;
+        int screenHeight;
+        float frameTime;
+        uint64_t frameLimit;
+        uint64_t frameCount = 0;
+        bool isClosed = false;
+
+        std::vector<Vector2> textureSizes;  // Indexed by ID - 1, (0, 0) once destroyed
+        std::vector<uint8_t> isTextureAlive;
+        std::vector<RenderTextureID> freeTextures;
+        RenderTextureID currentTarget = NULL_RENDER_TEXTURE;
+
+        std::vector<RecordedDraw> draws;
+        uint64_t totalVertexCount = 0;
+
+    public:
+        /// @param frameLimit ShouldClose() becomes true after this many frames (0 to never close)
+        /// @param frameTime What GetFrameTime() reports every frame, in seconds
+        NullRenderBackend(uint64_t frameLimit = 0, float frameTime = 1.0f / 60.0f, int screenWidth = 1280, int screenHeight = 720);
+
+        inline void SetFrameLimit(uint64_t limit) { frameLimit = limit; }
+        inline void SetFrameTime(float newFrameTime) { frameTime = newFrameTime; }
+        inline uint64_t GetFrameCount() { return frameCount; }
+        // The draw calls of the last (or current) frame
+        inline const std::vector<RecordedDraw>& GetDraws() { return draws; }
+        inline uint64_t GetTotalVertexCount() { return totalVertexCount; }
+        Vector2 GetTextureSize(RenderTextureID texture);
+
+        void OpenWindow(int width, int height, std::string title) override;
+        void CloseWindow() override;
+        bool ShouldClose() override;
+        bool IsWindowResized() override;
+        int GetScreenWidth() override;
+        int GetScreenHeight() override;
+        float GetFrameTime() override;
+
+        void BeginFrame() override;
+        void EndFrame() override;
+
+        RenderTextureID CreateRenderTexture(int width, int height) override;
+        RenderTextureID CreateTextureFromImage(const Image& image) override;
+        void DestroyRenderTexture(RenderTextureID texture) override;
+        void BeginTexture(RenderTextureID texture, const Camera2D* camera, Color clearColor) override;
+        void EndTexture() override;
+        void DrawTexture(RenderTextureID texture, Rectangle sourceRect, Rectangle destRect) override;
+
+        void DrawVertices(const VertexStream& triangles, const VertexStream& lines) override;
+    };
+}
+
+#endif // !NULLRENDERBACKEND
@@ -0,0 +1,46 @@
+#ifndef RAYLIBRENDERBACKEND_H
+#define RAYLIBRENDERBACKEND_H
+
+#include <vector>
+#include "renderbackend.h"
+
+namespace Astrocore
+{
+    // Draws to a real window through raylib/rlgl (the default backend)
+    class RaylibRenderBackend : public RenderBackend
+    {
+    private:
+        std::vector<RenderTexture2D> textures;  // Indexed by ID - 1, loaded images only fill in the color texture
+        std::vector<uint8_t> isTextureAlive;    // Indexed the same way, so destroying an ID twice doesn't free it twice
+        std::vector<RenderTextureID> freeTextures;
+        bool isInCameraMode = false;
+
+        void SubmitVertices(const VertexStream& vertices, int primitiveMode);
+        RenderTextureID AddTexture(const RenderTexture2D& texture);
+
+    public:
+        ~RaylibRenderBackend();
+
+        void OpenWindow(int width, int height, std::string title) override;
+        void CloseWindow() override;
+        bool ShouldClose() override;
+        bool IsWindowResized() override;
+        int GetScreenWidth() override;
+        int GetScreenHeight() override;
+        float GetFrameTime() override;
+
+        void BeginFrame() override;
+        void EndFrame() override;
+
+        RenderTextureID CreateRenderTexture(int width, int height) override;
+        RenderTextureID CreateTextureFromImage(const Image& image) override;
+        void DestroyRenderTexture(RenderTextureID texture) override;
+        void BeginTexture(RenderTextureID texture, const Camera2D* camera, Color clearColor) override;
+        void EndTexture() override;
+        void DrawTexture(RenderTextureID texture, Rectangle sourceRect, Rectangle destRect) override;
+
+        void DrawVertices(const VertexStream& triangles, const VertexStream& lines) override;
+    };
+}
+
+#endif // !RAYLIBRENDERBACKEND
@@ -0,0 +1,67 @@
+#ifndef RENDERBACKEND_H
+#define RENDERBACKEND_H
+
+#include <string>
+#include <cstdint>
+
+#ifndef RAYLIB_H
+#include <raylib.h>
+#endif // !RAYLIB_H
+
+namespace Astrocore
+{
+    struct VertexStream;
+
+    // A texture owned by the backend, drawn to offscreen or loaded from an image (0 is never a valid one)
+    typedef uint32_t RenderTextureID;
+    const RenderTextureID NULL_RENDER_TEXTURE = 0;
+
+    // Everything the engine needs from the window and the GPU. The renderer, render targets and
+    // shape batches only go through the current backend, so swapping it out (see NullRenderBackend)
+    // runs the whole frame without a window or a GPU.
+    class RenderBackend
+    {
+    private:
+        inline static RenderBackend* currentBackend = nullptr;
+
+    public:
+        virtual ~RenderBackend(){};
+
+        // The backend everything draws through (set by the Renderer that owns it)
+        static inline RenderBackend* GetCurrent() { return currentBackend; }
+        static inline void SetCurrent(RenderBackend* backend) { currentBackend = backend; }
+
+        // Window
+        virtual void OpenWindow(int width, int height, std::string title) = 0;
+        virtual void CloseWindow() = 0;
+        virtual bool ShouldClose() = 0;
+        virtual bool IsWindowResized() = 0;
+        virtual int GetScreenWidth() = 0;
+        virtual int GetScreenHeight() = 0;
+        // How long the last frame took, in seconds
+        virtual float GetFrameTime() = 0;
+
+        // Frames. Anything drawn outside of a texture goes to the screen
+        virtual void BeginFrame() = 0;
+        virtual void EndFrame() = 0;
+
+        // Offscreen textures
+        virtual RenderTextureID CreateRenderTexture(int width, int height) = 0;
+        // Uploads an image to the GPU (the image can be freed once this returns)
+        virtual RenderTextureID CreateTextureFromImage(const Image& image) = 0;
+        // Frees either kind of texture
+        virtual void DestroyRenderTexture(RenderTextureID texture) = 0;
+        /// @brief Start drawing into a texture
+        /// @param camera The camera to draw through, or nullptr to draw in texture pixels
+        /// @param clearColor What the texture is cleared to first
+        virtual void BeginTexture(RenderTextureID texture, const Camera2D* camera, Color clearColor) = 0;
+        virtual void EndTexture() = 0;
+        // Draws (part of) a texture into whatever is being drawn to
+        virtual void DrawTexture(RenderTextureID texture, Rectangle sourceRect, Rectangle destRect) = 0;
+
+        // Submits batched shape geometry (3 vertices per triangle, 2 per line)
+        virtual void DrawVertices(const VertexStream& triangles, const VertexStream& lines) = 0;
+    };
+}
+
+#endif // !RENDERBACKEND
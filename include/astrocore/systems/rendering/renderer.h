@@ -6,8 +6,11 @@
 #endif // !RAYLIB_H
 
 #include <memory>
+#include <map>
+#include <string>
 #include "../../nodes/node.h"
 #include "rendertarget.h"
+#include "renderbackend.h"
 
 namespace Astrocore
 {
@@ -15,10 +18,11 @@ namespace Astrocore
     {
         friend class Game;
         private:
+            std::unique_ptr<RenderBackend> backend;
             Vector2 targetRenderResolution = {0,0};
-            RenderTexture2D finalRenderTexture;
+            RenderTextureID finalRenderTexture = NULL_RENDER_TEXTURE;
             float virtualScreenWidth = 1;   // Scaling factor of the finalRenderTarget to fit in the window
-            // TODO: Add render bit flags for layers to use
+            // Each target picks the layers it draws with its cull mask
             std::map<std::string, RenderTarget*> renderTargets;
             Rectangle srcRect;
             Rectangle destRect;
@@ -26,8 +30,12 @@ namespace Astrocore
             Color clearColor = WHITE;
 
         public:
-            Renderer();
+            // Takes ownership of the backend (a RaylibRenderBackend if null), and makes it the current one
+            Renderer(RenderBackend* backend = nullptr);
             ~Renderer();
+            // Swaps the backend, before anything has been drawn (see Game::Game)
+            void SetBackend(RenderBackend* newBackend);
+            inline RenderBackend* GetBackend() { return backend.get(); }
             void SetClearColor(Color newColor);
             void SetFinalTargetDimensions(float width, float height);
 
@@ -36,7 +44,7 @@ namespace Astrocore
 
         // Basic renderer
         // TODO: Add layer sorting, etc
-            void Render(std::vector<std::weak_ptr<TreeNode>>* nodesToDraw);
+            void Render(SceneTree* tree);
     };
 
 }
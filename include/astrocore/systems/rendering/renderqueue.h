@@ -0,0 +1,76 @@
+#ifndef RENDERQUEUE_H
+#define RENDERQUEUE_H
+
+#include <vector>
+#include <cstdint>
+#include "../../nodes/treenode.h"
+
+namespace Astrocore
+{
+    // Sort keys are laid out so that a plain integer compare gives the draw order:
+    //  | render layer (8) | z index (32) | material (24) |
+    struct RenderItem
+    {
+        uint64_t key;
+        TreeNode* node;
+    };
+
+    // Collects the nodes to draw each frame and sorts them into draw order.
+    // Nodes whose key didn't change keep their order from the previous frame, so only
+    // new/changed items get sorted (with a radix sort) and then merged back in.
+    // Each queue remembers its own last order (by the nodes' tree handles), so several render targets
+    // don't get in each other's way. Nodes that aren't tracked by a tree are always resorted
+    class RenderQueue
+    {
+    private:
+        // Where a node ended up in the last sorted frame
+        struct Placement
+        {
+            uint32_t generation = 0;    // Of the node's handle, so a reused slot doesn't match
+            uint32_t frame = 0;
+            uint32_t rank = 0;
+            uint64_t key = 0;
+        };
+
+        std::vector<RenderItem> items;
+        std::vector<Placement> placements;          // Indexed by the node's tree handle index
+        std::vector<RenderItem> byPreviousRank;     // Scratch, indexed by last frame's rank
+        std::vector<RenderItem> retained;           // Scratch, items still in last frame's order
+        std::vector<RenderItem> changed;            // Scratch, new items or items with a new key
+        std::vector<RenderItem> radixScratch;
+        uint32_t frame = 0;
+        size_t previousCount = 0;
+        size_t resortedCount = 0;
+
+    public:
+        // Material keys used by the engine's own nodes
+        static const uint32_t MATERIAL_IMMEDIATE = 0;   // Draws with raylib directly
+        static const uint32_t MATERIAL_SHAPE_BATCH = 1; // Adds to the render target's shape batch
+
+        RenderQueue(){};
+
+        static inline uint64_t MakeKey(uint8_t renderLayer, int zIndex, uint32_t materialKey)
+        {
+            // Flipping the sign bit makes negative z indices sort before positive ones
+            uint32_t biasedZ = (uint32_t)zIndex ^ 0x80000000u;
+            return ((uint64_t)renderLayer << 56) | ((uint64_t)biasedZ << 24) | (materialKey & 0xFFFFFFu);
+        }
+
+        // Start collecting a new frame
+        void Begin();
+        void Add(TreeNode* node);
+        void Add(TreeNode* node, uint64_t key);
+        // Puts the items collected since Begin() in draw order
+        void Sort();
+
+        inline const std::vector<RenderItem>& GetItems() { return items; }
+        inline size_t GetCount() { return items.size(); }
+        // The number of items the last Sort() couldn't take from the previous frame's order
+        inline size_t GetResortedCount() { return resortedCount; }
+
+        // Stable LSD radix sort on the key, skipping any byte that's the same for every item
+        static void RadixSort(std::vector<RenderItem>& items, std::vector<RenderItem>& scratch);
+    };
+}
+
+#endif // !RENDERQUEUE
@@ -4,6 +4,10 @@
 #include "../../component/transform2D.h"
 #include <vector>
 #include "../../nodes/treenode.h"
+#include "../scenetree.h"
+#include "shapebatch.h"
+#include "renderqueue.h"
+#include "renderbackend.h"
 
 #include "../debug.h"
 
@@ -19,10 +23,17 @@ namespace Astrocore
     {
         private:
             std::string name;
-            RenderTexture2D renderTarget;
+            const char* profileZoneName = "RenderTarget";   // "RenderTarget <name>", for the profiler (only named with ASTROCORE_PROFILING)
+            RenderTextureID renderTarget = NULL_RENDER_TEXTURE;
+            float width = 0;
+            float height = 0;
             std::shared_ptr<Camera2D> renderCamera;
             Rectangle sourceRect;
             Rectangle destRect; // TODO: Should this be in screen coordinates
+            ShapeBatch shapeBatch;  // Shape geometry for this target, rebuilt every frame
+            std::vector<TreeNode*> visibleNodes;    // Reused every frame
+            RenderQueue renderQueue;                // Visible nodes, in draw order
+            uint32_t cullMask = 0xFFFFFFFF;         // Layers this target draws (one bit per layer)
 
         public:
             RenderTarget(std::string name);
@@ -35,11 +46,18 @@ namespace Astrocore
             Rectangle GetDestRect();
 
            
-            void DrawToTarget(std::vector<std::weak_ptr<TreeNode>>* nodesToDraw);
+            // Draws every node in the tree that the camera can see
+            void DrawToTarget(SceneTree* tree);
+            // The world-space area the camera can see
+            Rectangle GetCameraViewRect();
+            // Only nodes on one of these layers get drawn (see TreeNode::SetLayerMask)
+            inline void SetCullMask(uint32_t newMask) { cullMask = newMask; }
+            inline uint32_t GetCullMask() { return cullMask; }
             void SetActiveCamera(std::shared_ptr<Camera2D> cam);
             std::shared_ptr<Camera2D> GetActiveCamera();
 
             void DrawToFinal();
+            inline const char* GetProfileZoneName() { return profileZoneName; }
     };
 }
 
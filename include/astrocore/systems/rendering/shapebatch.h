@@ -0,0 +1,81 @@
+#ifndef SHAPEBATCH_H
+#define SHAPEBATCH_H
+
+#include <vector>
+
+#ifndef RAYLIB_H
+#include <raylib.h>
+#endif // !RAYLIB_H
+
+#include "../../component/affine2D.h"
+#include "../../nodes/shapenode.h"
+
+namespace Astrocore
+{
+    // Vertices of a single primitive type, stored as separate position/color arrays
+    // so positions can be transformed in bulk
+    struct VertexStream
+    {
+        std::vector<Vector2> positions;
+        std::vector<Color> colors;
+
+        inline size_t Size() const { return positions.size(); }
+        inline void Clear()
+        {
+            positions.clear();
+            colors.clear();
+        }
+        inline void Push(Vector2 position, Color color)
+        {
+            positions.push_back(position);
+            colors.push_back(color);
+        }
+        // Appends local-space points, transformed into world space
+        void Append(const std::vector<Vector2>& localPoints, const Affine2D& transform, Color color);
+    };
+
+    // Collects the geometry of many shapes into CPU-side vertex streams (one per
+    // primitive type) so they can be submitted in a few large draw calls.
+    // Building the streams doesn't touch the GPU, so it can run headless.
+    class ShapeBatch
+    {
+    private:
+        inline static ShapeBatch* activeBatch = nullptr;
+
+        VertexStream triangles; // 3 vertices per triangle
+        VertexStream lines;     // 2 vertices per (hairline) line
+
+    public:
+        ShapeBatch(){};
+
+        void Clear();
+        void AddTriangle(Vector2 a, Vector2 b, Vector2 c, Color color);
+        // Lines thicker than a pixel are expanded to a quad (2 triangles), thinner ones stay lines
+        void AddLine(Vector2 start, Vector2 end, float thickness, Color color);
+        // Adds a shape's cached local tessellation, transformed into world space
+        void AddShape(const Shape& shape, const Affine2D& transform);
+
+        // Submits everything in the batch through the current render backend, then clears it
+        void Flush();
+
+        inline size_t GetTriangleVertexCount() { return triangles.Size(); }
+        inline size_t GetLineVertexCount() { return lines.Size(); }
+        inline const VertexStream& GetTriangles() { return triangles; }
+        inline const VertexStream& GetLines() { return lines; }
+
+        // The batch shapes get added to while a render target is drawing (null if there isn't one)
+        static inline ShapeBatch* GetActive() { return activeBatch; }
+        static inline void SetActive(ShapeBatch* batch) { activeBatch = batch; }
+
+        // Nodes that draw with raylib directly should call this first so they stay in draw order
+        static void FlushActive();
+
+        // Tessellation helpers (CPU only)
+        // Triangulates a simple polygon (convex or concave, either winding) by ear clipping
+        static void TriangulatePolygon(const std::vector<Vector2>& points, std::vector<Vector2>* outTriangles);
+        // Expands a line into a quad of the given thickness, as 2 triangles
+        static void ExpandLine(Vector2 start, Vector2 end, float thickness, std::vector<Vector2>* outTriangles);
+    };
+}
+
+#endif // !SHAPEBATCH
@@ -0,0 +1,195 @@
+#ifndef RESOURCEMANAGER_H
+#define RESOURCEMANAGER_H
+
+#include <string>
+#include <vector>
+#include <deque>
+#include <unordered_map>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <cstdint>
+#include <cstddef>
+
+#ifndef RAYLIB_H
+#include <raylib.h>
+#endif // !RAYLIB_H
+
+#include "rendering/renderbackend.h"
+#include "packfile.h"
+
+namespace Astrocore
+{
+    enum RESOURCE_TYPE {RESOURCE_TEXTURE, RESOURCE_AUDIO, RESOURCE_DATA};
+    enum RESOURCE_STATE {RESOURCE_LOADING, RESOURCE_UPLOADING, RESOURCE_READY, RESOURCE_FAILED};
+
+    class ResourceManager;
+
+    // A counted reference to a resource: the resource stays loaded while any handle to it exists.
+    // Handles are only for the main thread, like the manager itself
+    class ResourceHandle
+    {
+        friend class ResourceManager;
+    private:
+        ResourceManager* manager = nullptr;
+        uint32_t slot = UINT32_MAX;
+
+        ResourceHandle(ResourceManager* manager, uint32_t slot);
+
+    public:
+        ResourceHandle(){};
+        ResourceHandle(const ResourceHandle& other);
+        ResourceHandle(ResourceHandle&& other);
+        ResourceHandle& operator=(const ResourceHandle& other);
+        ResourceHandle& operator=(ResourceHandle&& other);
+        ~ResourceHandle();
+        // Drop the reference early
+        void Reset();
+
+        inline bool IsValid() const { return manager != nullptr; }
+        RESOURCE_STATE GetState() const;
+        inline bool IsReady() const { return IsValid() && GetState() == RESOURCE_READY; }
+        const std::string& GetPath() const;
+
+        // Textures, once ready (NULL_RENDER_TEXTURE until then)
+        RenderTextureID GetTexture() const;
+        int GetWidth() const;
+        int GetHeight() const;
+        // Decoded audio, once ready (nullptr until then)
+        const Wave* GetWave() const;
+        // Raw file contents, once ready (nullptr until then)
+        const unsigned char* GetData() const;
+        size_t GetDataSize() const;
+    };
+
+    // Loads textures, audio and data files without stalling the frame. Load() returns a handle right away,
+    // the file is read and decoded on the manager's loader threads, and textures are uploaded to the GPU on
+    // the main thread during Update(), a few at a time so no frame goes over the upload budget.
+    // Resources are shared by path, and ones with no handles left are kept cached (least recently used
+    // are freed first) until the memory used goes over the budget
+    class ResourceManager
+    {
+        friend class ResourceHandle;
+    private:
+        static const int NULL_SLOT = -1;
+
+        struct Resource
+        {
+            std::string path;
+            RESOURCE_TYPE type = RESOURCE_DATA;
+            RESOURCE_STATE state = RESOURCE_LOADING;
+            bool isInUse = false;
+            int refCount = 0;
+            size_t memorySize = 0;
+
+            RenderTextureID texture = NULL_RENDER_TEXTURE;
+            int width = 0;
+            int height = 0;
+            Image pendingImage = Image();   // Decoded, waiting to be uploaded
+            Wave wave = Wave();
+            unsigned char* data = nullptr;
+            size_t dataSize = 0;
+
+            // Unreferenced resources, most recently released at the head
+            int previousUnused = NULL_SLOT;
+            int nextUnused = NULL_SLOT;
+        };
+
+        // Only what the loader threads need, they never touch the resources themselves
+        struct LoadRequest
+        {
+            uint32_t slot;
+            RESOURCE_TYPE type;
+            std::string path;
+            const PackFile* pack;
+        };
+        struct LoadResult
+        {
+            uint32_t slot;
+            bool isLoaded;
+            Image image;
+            Wave wave;
+            unsigned char* data;
+            size_t dataSize;
+        };
+
+        std::vector<Resource> resources;
+        std::vector<uint32_t> freeSlots;
+        std::unordered_map<std::string, uint32_t> slotsByPath;
+        int unusedHead = NULL_SLOT;
+        int unusedTail = NULL_SLOT;
+        size_t memoryUsed = 0;
+        size_t memoryBudget = 256 * 1024 * 1024;
+        float uploadBudgetMs = 2.0f;
+        std::deque<uint32_t> pendingUploads;
+        size_t loadingCount = 0;
+        const PackFile* pack = nullptr;
+
+        std::vector<std::thread> loaders;
+        std::mutex requestMutex;
+        std::condition_variable requestCondition;
+        std::deque<LoadRequest> requests;
+        bool isStopping = false;
+        std::mutex resultMutex;
+        std::vector<LoadResult> results;
+        std::vector<LoadResult> completedScratch;
+
+        void LoaderLoop();
+        static LoadResult Decode(const LoadRequest& request);
+        void Complete(LoadResult& result);
+        static void FreeResult(LoadResult& result);
+        void Upload(uint32_t slot);
+        void FreeData(Resource& resource);
+        void AddRef(uint32_t slot);
+        void Release(uint32_t slot);
+        void LinkUnused(uint32_t slot);
+        void UnlinkUnused(uint32_t slot);
+        void EvictToBudget();
+
+    public:
+        // Loader threads started by Start() when no count is given
+        static const int DEFAULT_LOADER_COUNT = 2;
+
+        ResourceManager(){};
+        ~ResourceManager();
+        ResourceManager(const ResourceManager&) = delete;
+        ResourceManager& operator=(const ResourceManager&) = delete;
+
+        /// @brief Start the loader threads
+        /// @param loaderCount With 0, files are loaded on the main thread during Update() instead (within the upload budget)
+        void Start(int loaderCount = DEFAULT_LOADER_COUNT);
+        // Joins the loader threads. Anything they hadn't started on is loaded by Update() from then on
+        void Stop();
+        // Stops the loaders and frees every resource. Handles that are still around just stop being ready
+        void Shutdown();
+
+        /// @brief Get a handle to a file, loading it in the background if it isn't loaded already
+        /// @return An invalid handle if the path was already loaded as a different type
+        ResourceHandle Load(const std::string& path, RESOURCE_TYPE type);
+        inline ResourceHandle LoadTexture(const std::string& path) { return Load(path, RESOURCE_TEXTURE); }
+        inline ResourceHandle LoadAudio(const std::string& path) { return Load(path, RESOURCE_AUDIO); }
+        inline ResourceHandle LoadData(const std::string& path) { return Load(path, RESOURCE_DATA); }
+
+        // Load from this pack (when it has the path) instead of from disk. Only affects loads started after
+        // this, and the pack has to stay open until they're done (or the manager is shut down)
+        inline void MountPack(const PackFile* newPack) { pack = newPack; }
+        inline const PackFile* GetMountedPack() { return pack; }
+
+        // Takes what the loaders finished, uploads textures until the upload budget is used up, and frees
+        // cached resources that are over the memory budget. Called once a frame by the game loop
+        void Update();
+
+        // Memory (CPU and GPU) the cache may use before unreferenced resources are freed, in bytes
+        inline void SetMemoryBudget(size_t bytes) { memoryBudget = bytes; EvictToBudget(); }
+        inline size_t GetMemoryBudget() { return memoryBudget; }
+        inline size_t GetMemoryUsed() { return memoryUsed; }
+        // Time spent uploading textures per Update(), in milliseconds (at least one is always uploaded)
+        inline void SetUploadBudget(float milliseconds) { uploadBudgetMs = milliseconds; }
+        inline float GetUploadBudget() { return uploadBudgetMs; }
+        // Resources still loading or waiting to be uploaded, e.g. for a loading screen
+        inline size_t GetPendingCount() { return loadingCount + pendingUploads.size(); }
+        inline size_t GetResourceCount() { return slotsByPath.size(); }
+    };
+}
+
+#endif // !RESOURCEMANAGER
@@ -0,0 +1,159 @@
+#ifndef SCENEFILE_H
+#define SCENEFILE_H
+
+#include <istream>
+#include <ostream>
+#include <string>
+#include <vector>
+#include <cstdint>
+#include <cstddef>
+#include "../nodes/node.h"
+#include "../nodes/shapenode.h"
+#include "nodepool.h"
+#include "mappedfile.h"
+
+namespace Astrocore
+{
+    // Binary scenes are a header followed by flat arrays, found by their offset from the start of the file:
+    //   nodes (parents always before their children), shapes (each node's are contiguous, in node order),
+    //   points (each shape's are contiguous, in shape order, 2 floats each) and names (not null terminated).
+    // Nothing in the file is a pointer, so it's used straight from the mapped memory (little endian only).
+    const char SCENE_FILE_MAGIC[4] = {'A', 'S', 'C', 'N'};
+    const uint16_t SCENE_FILE_VERSION = 1;
+
+    enum SCENE_NODE_TYPE {SCENE_NODE, SCENE_SHAPE_NODE};
+
+    struct SceneFileHeader
+    {
+        char magic[4];
+        uint16_t version;
+        uint16_t reserved;
+        uint32_t nodeCount;
+        uint32_t shapeCount;
+        uint32_t pointCount;
+        uint32_t nameBytes;
+        uint64_t nodesOffset;
+        uint64_t shapesOffset;
+        uint64_t pointsOffset;
+        uint64_t namesOffset;
+    };
+
+    struct SceneFileNode
+    {
+        int32_t parent;             // Index of the parent node, -1 for the root (always node 0)
+        uint32_t childCount;
+        uint32_t firstShape;
+        uint32_t shapeCount;
+        uint32_t nameOffset;
+        uint32_t nameLength;
+        float position[2];
+        float rotation;             // Radians
+        float scale[2];
+        int32_t zIndex;
+        uint32_t layerMask;
+        uint8_t renderLayer;
+        uint8_t type;               // SCENE_NODE_TYPE
+        uint8_t inheritsParentTransform;
+        uint8_t reserved;
+    };
+
+    struct SceneFileShape
+    {
+        uint32_t firstPoint;
+        uint32_t pointCount;
+        uint8_t color[4];
+        float lineWidth;
+        uint8_t isFilled;
+        uint8_t isClosed;
+        uint8_t reserved[2];
+    };
+
+    // A binary scene, mapped in to memory. Opening only checks that everything in it is in range,
+    // the arrays are read where they are
+    class SceneFile
+    {
+    private:
+        MappedFile file;
+        const unsigned char* data = nullptr;
+        size_t size = 0;
+
+        const SceneFileHeader* header = nullptr;
+        const SceneFileNode* nodes = nullptr;
+        const SceneFileShape* shapes = nullptr;
+        const Vector2* points = nullptr;
+        const char* names = nullptr;
+
+        bool Validate();
+
+    public:
+        SceneFile(){};
+        ~SceneFile();
+        SceneFile(const SceneFile&) = delete;
+        SceneFile& operator=(const SceneFile&) = delete;
+
+        /// @brief Map a binary scene file
+        /// @return FALSE if it couldn't be opened or isn't a valid scene (nothing is kept open)
+        bool Open(const std::string& path);
+        void Close();
+        inline bool IsOpen() { return header != nullptr; }
+
+        /// @brief Build the scene's node tree, every node in one pass
+        /// @param nodePool Plain nodes are created from this pool, if given (otherwise with new)
+        /// @param shapePool Same for shape nodes
+        /// @return The root node (nullptr if no file is open). Free it with Node::Destroy(), or the pools
+        Node* Instantiate(NodePool<Node>* nodePool = nullptr, NodePool<ShapeNode>* shapePool = nullptr);
+
+        inline uint32_t GetNodeCount() { return header != nullptr ? header->nodeCount : 0; }
+        inline uint32_t GetShapeCount() { return header != nullptr ? header->shapeCount : 0; }
+        inline uint32_t GetPointCount() { return header != nullptr ? header->pointCount : 0; }
+        inline const SceneFileNode* GetNodes() { return nodes; }
+    };
+
+    // Builds a binary scene, e.g. from a tool or from a scene made in code
+    class SceneFileWriter
+    {
+    private:
+        struct PendingNode
+        {
+            SceneFileNode node;
+            std::string name;
+            std::vector<Shape> shapes;
+        };
+        std::vector<PendingNode> nodes;
+
+    public:
+        SceneFileWriter(){};
+
+        /// @brief Add a node to the scene
+        /// @param parent The parent's index (it has to be added first), or -1 for the root
+        /// @return The node's index, or -1 if the parent isn't valid
+        int AddNode(int parent, const std::string& name, SCENE_NODE_TYPE type, const Transform2D& transform);
+        void SetTransform(int node, const Transform2D& transform);
+        // Only shape nodes draw their shapes
+        void AddShape(int node, const Shape& shape);
+        void SetZIndex(int node, int zIndex);
+        void SetRenderLayer(int node, uint8_t renderLayer, uint32_t layerMask);
+        void SetInheritsParentTransform(int node, bool inheritsParentTransform);
+        inline size_t GetNodeCount() { return nodes.size(); }
+
+        /// @brief Write out the scene
+        /// @param outputStream Opened in binary mode
+        /// @return FALSE if there's no root or the stream failed
+        bool Write(std::ostream& outputStream);
+    };
+
+    /// @brief Turn a text scene description in to a binary scene.
+    /// One node per line, nested by indentation:
+    ///   node <name> [pos=x,y] [rot=degrees] [scale=x,y] [z=n] [layer=n] [mask=n] [inherit=0|1]
+    ///   shapenode <name> [same options]
+    /// and indented under a shape node, one line per shape:
+    ///   rect <half width> <half height> | circle <radius> <points> | points x,y x,y ...
+    ///   followed by [fill=0|1] [closed=0|1] [width=n] [color=r,g,b,a]
+    /// Blank lines and lines starting with '#' are skipped. There must be exactly one root node
+    /// @param textStream The text description
+    /// @param outputStream Where to write the binary scene (opened in binary mode)
+    /// @return FALSE if the text isn't valid (the line is logged) or the stream failed
+    bool BakeSceneText(std::istream& textStream, std::ostream& outputStream);
+}
+
+#endif // !SCENEFILE
@@ -0,0 +1,121 @@
+#ifndef SCENEQUERY_H
+#define SCENEQUERY_H
+
+#include <vector>
+#include <cstdint>
+#include <cmath>
+
+#ifndef RAYLIB_H
+#include <raylib.h>
+#endif // !RAYLIB_H
+
+#include "../component/affine2D.h"
+#include "../nodes/treenode.h"
+#include "aabbtree.h"
+#include "jobsystem.h"
+
+namespace Astrocore
+{
+    // A run of points in QueryGeometry::points making up one shape's outline
+    struct QueryOutline
+    {
+        uint32_t start;
+        uint32_t count;
+        bool isClosed;      // Closed outlines have an inside, open ones are just lines
+    };
+
+    // A node's world-space outlines, as seen by SceneQuery (see TreeNode::GetQueryGeometry)
+    struct QueryGeometry
+    {
+        std::vector<Vector2> points;
+        std::vector<QueryOutline> outlines;
+
+        // Add a local-space outline, transformed in to world space
+        void AddOutline(const std::vector<Vector2>& localPoints, const Affine2D& transform, bool isClosed);
+        inline void Clear() { points.clear(); outlines.clear(); }
+    };
+
+    struct QueryHit
+    {
+        TreeNode* node = nullptr;   // Null if nothing was hit
+        Vector2 point = {0, 0};     // World-space point of contact (the closest point for nearest queries)
+        Vector2 normal = {0, 0};    // Surface normal at the point, facing back the way the query came
+        float distance = 0;
+    };
+
+    struct RayQuery
+    {
+        Vector2 origin;
+        Vector2 direction;          // Doesn't need to be normalized
+        float maxDistance;
+        uint32_t layerMask = 0xFFFFFFFF;
+    };
+
+    // Raycasts, shape casts, and overlap/nearest queries against the exact outlines of nodes.
+    // Candidates come from a dynamic AABB tree of their world bounds, which the scene tree keeps up to
+    // date as nodes move (see SceneTree::UpdateSpatialIndex), so queries see the scene as of the last update.
+    // Queries only read, so any number of them can run at once (e.g. on the job system), as long as
+    // the scene tree isn't updating the index at the same time
+    class SceneQuery
+    {
+    private:
+        struct QueryProxy
+        {
+            TreeNode* node = nullptr;
+            uint32_t layerMask = 0;
+            QueryGeometry geometry;
+        };
+
+        AabbTree tree;
+        std::vector<QueryProxy> proxies;    // Indexed by tree proxy ID
+        QueryGeometry scratchGeometry;
+
+        // Both only keep hits closer than hit->distance
+        void RaycastProxy(const QueryProxy& proxy, Vector2 origin, Vector2 direction, QueryHit* hit) const;
+        void ShapeCastProxy(const QueryProxy& proxy, const std::vector<Vector2>& points, Vector2 direction, QueryHit* hit) const;
+        bool OverlapsPolygon(const QueryProxy& proxy, const Vector2* polygon, size_t count) const;
+        // Distance from a point to the proxy's outlines (0 if it's inside one)
+        float ClosestPoint(const QueryProxy& proxy, Vector2 point, Vector2* outClosest) const;
+
+    public:
+        // Batches of rays are only split across threads in chunks of this many
+        static const size_t RAY_BATCH_SIZE = 64;
+
+        /// @brief Bring a node's entry up to date (adding or removing it as needed)
+        /// @param proxy The node's current proxy, or NULL_TREE_NODE if it isn't in yet
+        /// @return The node's proxy, or NULL_TREE_NODE if it has no query geometry
+        int SyncNode(TreeNode* node, int proxy);
+        void RemoveNode(int proxy);
+
+        /// @brief Find the first outline a ray crosses
+        /// Note: Rays starting inside a shape hit its outline on the way out
+        /// @param outHit The closest hit (its node is null if nothing was hit)
+        /// @return TRUE if anything was hit
+        bool Raycast(Vector2 origin, Vector2 direction, float maxDistance, QueryHit* outHit, uint32_t layerMask = 0xFFFFFFFF) const;
+        /// @brief Cast a batch of rays, spread across the job system when one is given
+        /// @param outHits One per ray, the hit node is null if the ray missed
+        void RaycastBatch(const RayQuery* rays, size_t count, QueryHit* outHits, JobSystem* jobSystem = nullptr) const;
+        /// @brief Sweep a polygon along a direction and find the first thing it touches
+        /// @param points World-space outline of the polygon being swept (closed)
+        /// @return TRUE if anything was hit. Anything already touching the polygon is hit at distance 0,
+        /// with the normal facing back along the direction
+        bool ShapeCast(const std::vector<Vector2>& points, Vector2 direction, float maxDistance, QueryHit* outHit, uint32_t layerMask = 0xFFFFFFFF) const;
+
+        /// @brief Find the nodes with a closed outline around a point
+        /// @param results Matching nodes are appended here
+        void QueryPoint(Vector2 point, std::vector<TreeNode*>* results, uint32_t layerMask = 0xFFFFFFFF) const;
+        /// @brief Find the nodes whose outlines touch or are inside an area
+        /// @param results Matching nodes are appended here
+        void QueryRectangle(Rectangle area, std::vector<TreeNode*>* results, uint32_t layerMask = 0xFFFFFFFF) const;
+        /// @brief Find the closest nodes to a point, measured to their outlines
+        /// @param count How many to find at most
+        /// @param results Replaced with the nodes found, closest first
+        void QueryNearest(Vector2 point, size_t count, std::vector<QueryHit>* results, float maxDistance = INFINITY, uint32_t layerMask = 0xFFFFFFFF) const;
+
+        inline int GetProxyCount() const { return tree.GetProxyCount(); }
+        inline int GetTreeHeight() const { return tree.GetHeight(); }
+        inline size_t GetReinsertCount() const { return tree.GetReinsertCount(); }
+    };
+}
+
+#endif // !SCENEQUERY
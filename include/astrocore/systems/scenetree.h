@@ -4,6 +4,11 @@
 #include <vector>
 #include <memory>
 #include "../nodes/treenode.h"
+#include "transformsystem.h"
+#include "spatialgrid.h"
+#include "scenequery.h"
+#include "nodetable.h"
+#include "jobsystem.h"
 
 namespace Astrocore
 {
@@ -11,14 +16,16 @@ namespace Astrocore
     {
         friend class Node;
         friend class Game;
+        public:
+        static const int LAYER_COUNT = 32;     // Layers available for layer/cull masks
+
         private:
         // The root of the entire tree
         std::unique_ptr<TreeNode> treeRoot;
         inline static bool created = false;    // Track if we've already created an instance
 
         // Track all nodes currently in the scene
-        std::unique_ptr<std::vector<std::weak_ptr<TreeNode>>> drawnNodesInScene = 
-            std::unique_ptr<std::vector<std::weak_ptr<TreeNode>>>(new std::vector<std::weak_ptr<TreeNode>>());
+        NodeTable nodesInScene;
         
         // The base node of the current scene 
         // NOTE: Using weak ptrs here because we don't want to explicitly own the object
@@ -26,6 +33,52 @@ namespace Astrocore
 
         std::weak_ptr<void> currentCamera;
 
+        // World transforms of every node in the tree
+        TransformSystem transformSystem;
+
+        // World bounds of every drawn node in the tree, bucketed by layer so a render
+        // target only ever visits the layers in its cull mask
+        struct SpatialEntry
+        {
+            TreeNode* node = nullptr;
+            uint32_t layerMask = 0;     // The layers the node is currently placed in
+            std::vector<int> proxies;   // One per set bit in layerMask, lowest bit first
+            uint32_t queryStamp = 0;    // Stops nodes on several layers being returned twice
+            int queryProxy = NULL_TREE_NODE;    // The node's entry in the scene query, if it has query geometry
+            bool isBoundsDirtyQueued = false;   // Already in boundsDirtyEntries
+        };
+        SpatialGrid layerIndices[LAYER_COUNT];
+        std::vector<SpatialEntry> spatialEntries;
+        std::vector<int> freeSpatialEntries;
+        uint32_t currentQueryStamp = 0;
+        std::vector<TreeNode*> spatialNodesByTransform;    // Indexed by TransformID
+        std::vector<int> boundsDirtyEntries;    // Bounds changed for reasons other than moving (entries removed since are skipped)
+        // Exact outlines of the same nodes, for raycasts and other gameplay queries
+        SceneQuery query;
+
+        // Parallel updates
+        struct ParallelUpdate
+        {
+            TreeNode* node;
+            float deltaTime;
+            bool isFixed;
+            // Spatial index changes made by the subtree, applied once every subtree has finished
+            std::vector<TreeNode*> boundsDirty;
+            std::vector<TreeNode*> layerMaskChanged;
+        };
+        JobSystem* jobSystem = nullptr;
+        bool isDeferringParallel = false;       // Only while the serial part of an update is running
+        float parallelDeltaTime = 0;
+        bool isParallelFixed = false;
+        std::vector<ParallelUpdate> parallelUpdates;    // In the order the serial pass reached them
+        inline static thread_local ParallelUpdate* currentParallelUpdate = nullptr;     // The subtree this thread is updating
+
+        void RunParallelUpdates();
+
+        void PlaceInLayers(SpatialEntry& entry, const Rectangle* bounds);
+        void RemoveFromLayers(SpatialEntry& entry);
+        void RefreshBounds(TreeNode* node);
+
     public:
         SceneTree();
         ~SceneTree(); 
@@ -35,10 +88,57 @@ namespace Astrocore
         void SetCurrentScene(std::weak_ptr<TreeNode> newSceneRoot);
         // Set's the current scene, deleting the old scene
         void SwapCurrentScene(std::weak_ptr<TreeNode> newSceneRoot);
+        /// @brief Update the current scene
+        /// Subtrees marked with TreeNode::SetParallelUpdate() are skipped by the main pass, then all
+        /// updated at once on the job system (if there is one). Every one of them has finished
+        /// before this returns, and which thread ran which doesn't change what they see
         void Update(float deltaTime);
         void FixedUpdate(float deltaTime);
+
+        // The jobs that parallel subtrees are updated on (nullptr to update everything on the calling thread)
+        inline void SetJobSystem(JobSystem* newJobSystem) { jobSystem = newJobSystem; }
+        inline JobSystem* GetJobSystem() { return jobSystem; }
+        // Called by nodes during the update, returns false if the subtree has to be updated right away instead
+        bool DeferParallelUpdate(TreeNode* node);
         void RegisterToTree(std::weak_ptr<TreeNode> nodeToRegister);
+        void RegisterToTree(TreeNode* nodeToRegister);
         void DeRegisterToTree(std::weak_ptr<TreeNode> nodeToDeRegister);
+        void DeRegisterToTree(TreeNode* nodeToDeRegister);
+
+        // Node table
+        // Called by nodes as they enter/exit the tree (O(1))
+        void TrackNode(TreeNode* node);
+        void UntrackNode(TreeNode* node);
+        // Every node currently in the tree, safe to iterate without locking anything
+        inline const NodeTable& GetNodes() { return nodesInScene; }
+        // Returns the node, or null if it has left the tree since the handle was taken
+        inline TreeNode* GetNode(NodeHandle handle) { return nodesInScene.Get(handle); }
+        inline NodeHandle GetHandle(TreeNode* node) { return node->treeHandle; }
+
+        inline TransformSystem* GetTransformSystem() { return &transformSystem; };
+        // Bring every world transform in the tree up to date
+        void PropagateTransforms();
+
+        // Spatial index
+        /// @brief Add a drawn node to the spatial index
+        /// @param node The node to add
+        /// @param transformID The node's transform, so its bounds get refreshed when it moves (optional)
+        void AddToSpatialIndex(TreeNode* node, TransformID transformID = NULL_TRANSFORM);
+        void RemoveFromSpatialIndex(TreeNode* node, TransformID transformID = NULL_TRANSFORM);
+        // Flag a node's bounds as changed without it moving (e.g. new geometry)
+        // From a parallel update it's recorded, and only applied after every parallel subtree has finished
+        void MarkBoundsDirty(TreeNode* node);
+        // Moves a node into the buckets for its new layer mask (deferred like MarkBoundsDirty())
+        void OnLayerMaskChanged(TreeNode* node);
+        // Re-bins everything that moved or changed since the last call. Call after PropagateTransforms()
+        void UpdateSpatialIndex();
+        /// @brief Find the drawn nodes that overlap an area
+        /// @param area The world-space area to search
+        /// @param results Overlapping nodes are appended here, each node at most once
+        /// @param cullMask Only layers with their bit set are searched
+        void QueryVisible(Rectangle area, std::vector<TreeNode*>* results, uint32_t cullMask = 0xFFFFFFFF);
+        // Raycasts, shape casts, and point/rectangle/nearest queries, as of the last UpdateSpatialIndex()
+        inline const SceneQuery& GetQuery() { return query; }
     };
 }
 #endif // !SCENETREE
\ No newline at end of file
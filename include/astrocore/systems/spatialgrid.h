@@ -0,0 +1,82 @@
+#ifndef SPATIALGRID_H
+#define SPATIALGRID_H
+
+#include <vector>
+#include <unordered_map>
+#include <cstdint>
+
+#ifndef RAYLIB_H
+#include <raylib.h>
+#endif // !RAYLIB_H
+
+#include "../nodes/treenode.h"
+
+namespace Astrocore
+{
+    const int NULL_PROXY = -1;
+
+    // A uniform grid of world-space AABBs, used to find the nodes that overlap an area
+    // (e.g. a camera's view) without visiting everything in the scene.
+    // Proxies only move between cells when their bounds cross a cell border.
+    class SpatialGrid
+    {
+    private:
+        enum PLACEMENT {UNBOUNDED, LARGE, CELLS};
+
+        struct Proxy
+        {
+            TreeNode* node = nullptr;
+            Rectangle bounds = {0, 0, 0, 0};
+            int minCellX = 0;
+            int minCellY = 0;
+            int maxCellX = -1;
+            int maxCellY = -1;
+            PLACEMENT placement = UNBOUNDED;
+            uint32_t queryStamp = 0;
+            bool inUse = false;
+        };
+
+        float cellSize;
+        std::unordered_map<int64_t, std::vector<int>> cells;
+        size_t emptyCellCount = 0;  // Cells left empty since the last prune
+        std::vector<Proxy> proxies;
+        std::vector<int> freeProxies;
+        std::vector<int> largeProxies;      // Span too many cells to be worth bucketing, always tested
+        std::vector<int> unboundedProxies;  // No bounds, always returned
+        uint32_t currentQueryStamp = 0;
+        std::vector<int> queryScratch;
+
+        static inline int64_t CellKey(int x, int y) { return (int64_t)(((uint64_t)(uint32_t)x << 32) | (uint32_t)y); }
+        void Place(int proxyID, const Rectangle* bounds);
+        void Unplace(int proxyID);
+        void TestProxy(int proxyID, Rectangle area);
+        void PruneEmptyCells();
+
+    public:
+        // Anything covering more cells than this goes in the 'large' list instead
+        static const int MAX_CELLS_PER_PROXY = 64;
+        // Empty cells are only freed once there are more than this many, and they outnumber the occupied ones
+        static const size_t MIN_EMPTY_CELLS_TO_PRUNE = 256;
+
+        SpatialGrid(float cellSize = 256.0f);
+
+        /// @brief Add a node to the grid
+        /// @param node The node the proxy represents
+        /// @param bounds The world-space bounds of the node, or null if it has none (always visible)
+        /// @return The ID of the new proxy
+        int CreateProxy(TreeNode* node, const Rectangle* bounds);
+        void UpdateProxy(int proxyID, const Rectangle* bounds);
+        void DestroyProxy(int proxyID);
+
+        /// @brief Find every node whose bounds overlap an area, in proxy ID order (stable between frames,
+        /// but IDs of destroyed proxies get reused, so it isn't creation order)
+        /// @param area The world-space area to search
+        /// @param results Overlapping nodes are appended here (nodes without bounds are always included)
+        void Query(Rectangle area, std::vector<TreeNode*>* results);
+
+        inline size_t GetProxyCount() { return proxies.size() - freeProxies.size(); }
+        inline float GetCellSize() { return cellSize; }
+    };
+}
+
+#endif // !SPATIALGRID
@@ -0,0 +1,114 @@
+#ifndef TRANSFORMSYSTEM_H
+#define TRANSFORMSYSTEM_H
+
+#include <vector>
+#include <cstdint>
+#include <atomic>
+#include "../component/affine2D.h"
+#include "../component/transform2D.h"
+
+namespace Astrocore
+{
+    typedef int TransformID;
+    const TransformID NULL_TRANSFORM = -1;
+
+    // Stores the local and world transforms of a hierarchy in flat, parallel arrays.
+    // Entries are kept in parent-before-child order, so world transforms can be
+    // brought up to date in a single linear pass over the dirty range.
+    class TransformSystem
+    {
+    private:
+        static const int REMOVED_PARENT = -2;   // Marks a slot that is waiting to be compacted
+
+        // Dense arrays (indexed by slot)
+        std::vector<int> parents;                   // Slot of the parent, or -1 for roots
+        std::vector<Affine2D> localTransforms;
+        std::vector<Affine2D> worldTransforms;
+        std::vector<const Transform2D*> sources;    // Where local transforms are pulled from when dirty (can be null)
+        std::vector<uint32_t> worldVersions;        // Bumped each time the world transform is recomputed
+        std::vector<uint32_t> seenParentVersions;   // Parent world version the world transform was built from
+        std::vector<uint8_t> localDirty;
+        std::vector<TransformID> slotToID;
+
+        // Sparse ID -> slot lookup, so IDs stay valid when slots get reordered
+        std::vector<int> idToSlot;
+        std::vector<TransformID> freeIDs;
+
+        std::atomic<int> firstDirtySlot = 0;    // Every slot before this one is up to date
+        bool isConcurrent = false;
+        int removedCount = 0;
+        bool needsReorder = false;
+        size_t recomputeCount = 0;
+
+        bool trackChanges = false;
+        std::vector<TransformID> changedIDs;    // Entries recomputed since the last ClearChangedIDs(), each only once
+        std::vector<uint8_t> isChangeQueued;    // Indexed by ID, so propagating again without clearing can't grow the list
+
+        // Reorder() builds the new order into these, then swaps them with the arrays above
+        std::vector<int> spareParents;
+        std::vector<Affine2D> spareLocalTransforms;
+        std::vector<Affine2D> spareWorldTransforms;
+        std::vector<const Transform2D*> spareSources;
+        std::vector<uint32_t> spareWorldVersions;
+        std::vector<uint32_t> spareSeenParentVersions;
+        std::vector<uint8_t> spareLocalDirty;
+        std::vector<TransformID> spareSlotToID;
+
+        // Scratch for Reorder(), kept so it doesn't allocate every time
+        std::vector<int> firstChild;
+        std::vector<int> nextSibling;
+        std::vector<int> order;
+        std::vector<uint8_t> visited;
+        std::vector<int> stack;
+
+        void Propagate(int lastSlot);
+        void Reorder();
+        void LowerFirstDirtySlot(int slot);
+
+    public:
+        TransformSystem(){};
+
+        /// @brief Add a transform to the hierarchy
+        /// @param source The transform to read the local transform from when marked dirty (can be null)
+        /// @param parent The parent of the new transform, or NULL_TRANSFORM
+        /// @return The ID of the new transform
+        TransformID Add(const Transform2D* source, TransformID parent = NULL_TRANSFORM);
+
+        // Note: Children should be removed before their parent
+        void Remove(TransformID id);
+        void SetParent(TransformID id, TransformID parent);
+
+        // Flags the local transform as changed, it will be re-read from its source on the next propagate
+        // Note: Safe to call from several threads at once, as long as each entry is only touched by one
+        void MarkDirty(TransformID id);
+        // Sets the local transform directly (for entries without a source)
+        void SetLocal(TransformID id, const Affine2D& local);
+
+        /// @brief Bring every world transform up to date in one pass
+        void Propagate();
+
+        /// @brief Get the world transform of an entry, propagating up to it first if needed
+        /// While concurrent, returns the world transform as of the last propagate instead
+        const Affine2D& GetWorld(TransformID id);
+        const Affine2D& GetLocal(TransformID id);
+        // Changes every time the world transform of the entry is recomputed
+        uint32_t GetWorldVersion(TransformID id);
+
+        bool IsValid(TransformID id);
+        inline size_t GetCount() { return parents.size() - removedCount; }
+
+        // While several threads are updating entries (see SceneTree's parallel updates), reading a
+        // world transform never propagates, so readers don't write to shared state
+        inline void SetConcurrent(bool concurrent) { isConcurrent = concurrent; }
+        inline bool IsConcurrent() { return isConcurrent; }
+
+        // Change tracking, so other systems can react only to what moved
+        inline void SetTrackChanges(bool shouldTrack) { trackChanges = shouldTrack; }
+        inline const std::vector<TransformID>& GetChangedIDs() { return changedIDs; }
+        void ClearChangedIDs();
+
+        // The number of world transforms recomputed since the system was created
+        inline size_t GetRecomputeCount() { return recomputeCount; }
+    };
+}
+#endif // !TRANSFORMSYSTEM
@@ -11,9 +11,8 @@ Transform2D::Transform2D()
 	scale = {1,1};
 }
 
-Transform2D::Transform2D(Vector2 initialPosition, float initialRotationDegrees)
+Transform2D::Transform2D(Vector2 initialPosition, float initialRotationDegrees) : Transform2D()
 {
-	Transform2D();
 	this->position = {initialPosition.x, initialPosition.y, 0};
 	this->rotation = initialRotationDegrees * PI/180.0f;
 }
@@ -26,12 +25,49 @@ Transform2D::Transform2D(Transform2D* other)
 	this->rotation = other->GetRotation();
 }
 
-Transform2D::Transform2D(Matrix transformMat)
+Transform2D::Transform2D(Matrix transformMat) : Transform2D()
 {
-	Transform2D();
 	SetMatrix(transformMat);
 }
 
+// Copies only the transform itself, listeners stay with the original
+Transform2D::Transform2D(const Transform2D& other)
+{
+	this->position = other.position;
+	this->rotation = other.rotation;
+	this->scale = other.scale;
+}
+
+Transform2D& Transform2D::operator=(const Transform2D& other)
+{
+	if(this == &other ||
+	   (position.x == other.position.x && position.y == other.position.y && position.z == other.position.z &&
+	    rotation == other.rotation && scale.x == other.scale.x && scale.y == other.scale.y))
+	{
+		return *this;
+	}
+	this->position = other.position;
+	this->rotation = other.rotation;
+	this->scale = other.scale;
+	OnChanged();
+	return *this;
+}
+
+void Transform2D::SetChangedCallback(TransformChangedCallback callback, void* context)
+{
+	changedCallback = callback;
+	changedContext = context;
+}
+
+void Transform2D::OnChanged()
+{
+	version++;
+	if(changedCallback != nullptr)
+	{
+		changedCallback(changedContext);
+	}
+}
+
 void Transform2D::SetMatrix(Matrix newMat)
 {
 	Quaternion quat = QuaternionIdentity();
@@ -42,17 +78,38 @@ void Transform2D::SetMatrix(Matrix newMat)
     // 'Normalize' the rotation by applying the inverse scale factor to the matrix
     Matrix inverseScale = MatrixScale(1.0f/ scale.x, 1.0f / scale.y, 1.0f);
 	this->rotation = QuaternionToEuler(QuaternionFromMatrix(MatrixMultiply(newMat, inverseScale))).z;
+	OnChanged();
+}
+
+// Cheap 2D decompose, no quaternions needed
+void Transform2D::SetAffine(const Affine2D& newAffine)
+{
+	Vector2 newPosition = newAffine.GetPosition();
+	this->position = {newPosition.x, newPosition.y, 0};
+	this->rotation = newAffine.GetRotation();
+	this->scale = newAffine.GetScale();
+	OnChanged();
 }
 
 void Transform2D::Translate(Vector2 translation)
 {
+	if(translation.x == 0 && translation.y == 0)
+	{
+		return;
+	}
 	this->position = Vector3Add(position, {translation.x, translation.y, 0});
+	OnChanged();
 }
 
 void Transform2D::TranslateLocal(Vector2 translation)
 {
+	if(translation.x == 0 && translation.y == 0)
+	{
+		return;
+	}
 	Vector2 rotated = Vector2Transform(translation, MatrixRotateZ(rotation));
 	position = Vector3Add(position, {rotated.x, rotated.y, 0});
+	OnChanged();
 }
 
 void Transform2D::RotateDegrees(float rotationDelta)
@@ -62,18 +119,33 @@ void Transform2D::RotateDegrees(float rotationDelta)
 
 void Transform2D::Rotate(float rotationDelta)
 {
+	if(rotationDelta == 0)
+	{
+		return;
+	}
 	this->rotation += rotationDelta;
+	OnChanged();
 }
 
 void Transform2D::Scale(Vector2 scaleDelta)
 {
+	if(scaleDelta.x == 1 && scaleDelta.y == 1)
+	{
+		return;
+	}
 	scale = Vector2Multiply(scale, scaleDelta);
+	OnChanged();
 }
 
 // Setters
 void Transform2D::SetPosition(Vector2 newPosition)
 {
+	if(position.x == newPosition.x && position.y == newPosition.y)
+	{
+		return;
+	}
 	position = {newPosition.x, newPosition.y};
+	OnChanged();
 }
 
 void Transform2D::SetRotationDegrees(float rotationDegrees)
@@ -83,12 +155,22 @@ void Transform2D::SetRotationDegrees(float rotationDegrees)
 
 void Transform2D::SetRotation(float rotation)
 {
+	if(this->rotation == rotation)
+	{
+		return;
+	}
 	this->rotation = rotation;
+	OnChanged();
 }
 
 void Transform2D::SetScale(float scaleX, float scaleY)
 {
+	if(scale.x == scaleX && scale.y == scaleY)
+	{
+		return;
+	}
 	scale = {scaleX, scaleY};
+	OnChanged();
 }
 
 
@@ -99,7 +181,7 @@ void Transform2D::SetTransform(Vector2 position, float rotation, Vector2 scale)
 	Translate(position);
 }
 
-Matrix Transform2D::GetMatrix()
+Matrix Transform2D::GetMatrix() const
 {
 	Matrix matToReturn = MatrixIdentity();
     matToReturn = MatrixMultiply(matToReturn, MatrixScale(scale.x, scale.y, 1)); 
@@ -111,22 +193,27 @@ Matrix Transform2D::GetMatrix()
 	return matToReturn;
 }
 
-Vector2 Transform2D::GetPosition()
+Affine2D Transform2D::GetAffine() const
+{
+	return Affine2D::FromTRS({position.x, position.y}, rotation, scale);
+}
+
+Vector2 Transform2D::GetPosition() const
 {
 	return {position.x, position.y};
 }
 
-Vector2 Transform2D::GetScale()
+Vector2 Transform2D::GetScale() const
 {
 	return {scale.x, scale.y};
 }
 
-float Transform2D::GetRotation()
+float Transform2D::GetRotation() const
 {
 	return rotation;
 }
 
-float Transform2D::GetRotationDegrees()
+float Transform2D::GetRotationDegrees() const
 {
 	return GetRotation() * 180.0f/PI;
 }
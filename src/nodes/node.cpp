@@ -1,16 +1,18 @@
 #include "../../include/astrocore/nodes/node.h"
+#include "../../include/astrocore/systems/nodepool.h"
 #include <algorithm>
 #include <memory>
 #include "../../include/astrocore/systems/debug.h"
 using namespace Astrocore;
 
 int Node::NODE_INCREMENTOR = 0;
+size_t Node::WORLD_RECOMPUTE_COUNT = 0;
+int Node::BULK_TEARDOWN_DEPTH = 0;
 
 Node::Node()
 {
     SetNodeID();
-    this->transform = std::unique_ptr<Transform2D>(new Transform2D());
-    this->worldTransform = std::unique_ptr<Transform2D>(new Transform2D());
+    this->transform.SetChangedCallback(&Node::OnLocalTransformChanged, this);
     children = std::vector<Node*>();
 }
 
@@ -21,10 +23,22 @@ Node::Node(std::string name): Node()
 
 Node::~Node()
 {
-    //if(isInTree)
-    //{
-    //    // TODO: De-register from tree (which will call OnTreeExit)
-    //}
+    // The body would keep writing to this node after every step (even in a bulk teardown, the world isn't going)
+    if(physicsWorld != nullptr)
+    {
+        physicsWorld->RemoveBody(physicsBody);
+    }
+
+    // The whole pool is being torn down at once, every other node in it is going too
+    if(BULK_TEARDOWN_DEPTH > 0)
+    {
+        return;
+    }
+
+    if(isInTree)
+    {
+        ExitTree();
+    }
 
     if(parent != nullptr)
     {
@@ -35,11 +49,30 @@ Node::~Node()
     // Delete children
     for(Node* child : children)
     {
-        delete child;
+        // Clear the parent first so the child doesn't modify the list we're iterating
+        child->parent = nullptr;
+        Destroy(child);
         child = nullptr;
     }
 }
 
+void Node::Destroy(Node* node)
+{
+    if(node == nullptr)
+    {
+        return;
+    }
+    // Pooled nodes go back to their pool, anything else was made with new
+    if(node->allocator != nullptr)
+    {
+        node->allocator->Release(node);
+    }
+    else
+    {
+        delete node;
+    }
+}
+
 void Node::SetNodeID()
 {
     int id = NODE_INCREMENTOR;
@@ -52,27 +85,76 @@ int Node::GetNodeID()
     return nodeID;
 }
 
-void EnterTree(SceneTree* tree)
+void Node::EnterTree(SceneTree* tree)
+{
+    if(isInTree)
+    {
+        return;
+    }
+    registeredTree = tree;
+    isInTree = true;
+    tree->TrackNode(this);
+
+    TransformID parentID = (parent != nullptr && inheritParentTransform) ? parent->transformID : NULL_TRANSFORM;
+    transformID = tree->GetTransformSystem()->Add(&transform, parentID);
+    isDecomposedValid = false;
+
+    if(IsDrawn())
+    {
+        tree->AddToSpatialIndex(this, transformID);
+    }
+
+    for(Node* child : children)
+    {
+        child->EnterTree(tree);
+    }
+}
+
+void Node::ExitTree()
 {
-    
+    if(!isInTree)
+    {
+        return;
+    }
+
+    // Children leave first so the transform system never has an orphaned slot
+    for(Node* child : children)
+    {
+        child->ExitTree();
+    }
+
+    registeredTree->RemoveFromSpatialIndex(this, transformID);
+    registeredTree->UntrackNode(this);
+    registeredTree->GetTransformSystem()->Remove(transformID);
+    transformID = NULL_TRANSFORM;
+    registeredTree = nullptr;
+    isInTree = false;
+
+    // The cached world transform is from before we entered the tree
+    isWorldMatrixDirty = true;
+    isDecomposedValid = false;
 }
+
 void Node::AddChild(Node* newChild)
 {
-    std::vector<Node*>::iterator it = std::find(children.begin(), children.end(), newChild);
-
     // Already has the child: don't do anything
-    if(it != children.end())
+    // (a node's parent pointer is only ever set while it's in that parent's child list)
+    if(newChild == nullptr || newChild->parent == this)
     {
         return;
     }
+    if(newChild->parent != nullptr)
+    {
+        newChild->parent->RemoveChild(newChild);
+    }
     children.push_back(newChild);
-    newChild->SetParent(this);
+    newChild->parent = this;
+    newChild->MarkSubtreeDirty();
 
     // Register the child to the tree
     if(isInTree && !newChild->isInTree)
     {
-        std::shared_ptr<Node> n = std::shared_ptr<Node>(newChild);
-        registeredTree->RegisterToTree(n);
+        newChild->EnterTree(registeredTree);
     }
 }
 
@@ -83,26 +165,55 @@ void Node::RemoveChild(Node* childToRemove)
     if(it != children.end())
     {
         children.erase(it);
+        if(childToRemove->parent == this)
+        {
+            childToRemove->parent = nullptr;
+        }
+
+        // Removed nodes leave the tree, they re-enter when they get a new parent
+        childToRemove->ExitTree();
         return; 
     }
 }
 
 void Node::SetInheritsParentTransform(bool shouldInheritParentTransform)
 {
+    if(this->inheritParentTransform == shouldInheritParentTransform)
+    {
+        return;
+    }
     this->inheritParentTransform = shouldInheritParentTransform;
+    MarkSubtreeDirty();
+
+    if(isInTree)
+    {
+        TransformID parentID = (parent != nullptr && inheritParentTransform) ? parent->transformID : NULL_TRANSFORM;
+        registeredTree->GetTransformSystem()->SetParent(transformID, parentID);
+    }
 }
 
 void Node::SetParent(Node* newParent)
 {
-    if(parent != nullptr && parent != newParent)
+    if(newParent == parent)
     {
-        parent->RemoveChild(this);
+        return;
     }
-    if(newParent != parent)
+    if(newParent == nullptr)
     {
-        parent = newParent;
-        parent->AddChild(this);
+        parent->RemoveChild(this);
+        return;
     }
+    newParent->AddChild(this);
+}
+
+Node* Node::GetParent()
+{
+    return parent;
+}
+
+std::vector<Node*> Node::GetAllChildren()
+{
+    return children;
 }
 
 Node* Node::GetChildAtIndex(int index)
@@ -119,36 +230,119 @@ void Node::Update(float deltaTime)
 {
     for(Node* child : children)
     {
+        // Parallel subtrees get handed to the tree, to be updated together once this pass is done
+        if(child->isParallelUpdate && isInTree && registeredTree->DeferParallelUpdate(child))
+        {
+            continue;
+        }
         child->Update(deltaTime);
     }
 }
 
-Transform2D* Node::GetTransform()
+void Node::FixedUpdate(float deltaTime)
 {
-    // TODO: Do this only when the transform changes
     for(Node* child : children)
     {
-        child->SetIsWorldMatrixDirty(true);
+        if(child->isParallelUpdate && isInTree && registeredTree->DeferParallelUpdate(child))
+        {
+            continue;
+        }
+        child->FixedUpdate(deltaTime);
+    }
+}
+
+Transform2D* Node::GetTransform()
+{
+    return &transform;
+}
+
+const Transform2D* Node::GetTransformConst() const
+{
+    return &transform;
+}
+
+void Node::OnLocalTransformChanged(void* node)
+{
+    Node* changedNode = (Node*)node;
+    if(changedNode->isInTree)
+    {
+        // The transform system works out which descendants need updating on its own
+        changedNode->registeredTree->GetTransformSystem()->MarkDirty(changedNode->transformID);
+    }
+    else
+    {
+        changedNode->MarkSubtreeDirty();
+    }
+}
+
+void Node::MarkSubtreeDirty()
+{
+    // A dirty node's descendants are always dirty too (computing a child's world
+    // transform cleans its parent first), so there is nothing left to do
+    if(isWorldMatrixDirty)
+    {
+        return;
     }
 
     isWorldMatrixDirty = true;
-    return transform.get();
+    for(Node* child : children)
+    {
+        child->MarkSubtreeDirty();
+    }
+}
+
+uint32_t Node::GetWorldVersion()
+{
+    if(isInTree)
+    {
+        return registeredTree->GetTransformSystem()->GetWorldVersion(transformID);
+    }
+    return worldVersion;
 }
 
 Transform2D Node::GetWorldTransform()
 {
-    if(parent == nullptr || !inheritParentTransform)
+    // Parallel subtrees can all be reading this node, so the cached decomposition is left alone
+    if(isInTree && registeredTree->GetTransformSystem()->IsConcurrent())
+    {
+        Transform2D result;
+        result.SetAffine(GetWorldAffine());
+        return result;
+    }
+
+    // Only decompose when the world transform has actually changed
+    GetWorldAffine();
+    uint32_t version = GetWorldVersion();
+    if(!isDecomposedValid || decomposedVersion != version)
+    {
+        worldTransform.SetAffine(GetWorldAffine());
+        decomposedVersion = version;
+        isDecomposedValid = true;
+    }
+    return worldTransform;
+}
+
+Affine2D Node::GetWorldAffine()
+{
+    // Nodes in a tree get their world transform from the tree's transform system
+    if(isInTree)
     {
-        Transform2D* t = this->transform.get();
-        return Transform2D(t);
+        return registeredTree->GetTransformSystem()->GetWorld(transformID);
     }
-    
 
-    // TODO: Fix the dirty flag here
     if(isWorldMatrixDirty)
     {
-        this->worldTransform->SetMatrix(MatrixMultiply(transform->GetMatrix(), parent->GetWorldTransform().GetMatrix()));
+        if(parent == nullptr || !inheritParentTransform)
+        {
+            worldAffine = transform.GetAffine();
+        }
+        else
+        {
+            worldAffine = Affine2D::Multiply(parent->GetWorldAffine(), transform.GetAffine());
+        }
         isWorldMatrixDirty = false;
+        worldVersion++;
+        WORLD_RECOMPUTE_COUNT++;
     }
-    return *worldTransform;
+    return worldAffine;
 }
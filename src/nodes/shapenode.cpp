@@ -1,10 +1,15 @@
 #include "../../include/astrocore/nodes/shapenode.h"
+#include "../../include/astrocore/systems/rendering/shapebatch.h"
+#include "../../include/astrocore/systems/rendering/renderqueue.h"
+#include "../../include/astrocore/systems/scenequery.h"
+#include <algorithm>
 
 using namespace Astrocore;
 
 ShapeNode::ShapeNode()
 {
     shapesToDraw = std::vector<Shape>();
+    isDrawn = true;
 }
 
 ShapeNode::ShapeNode(Shape initialShape) : ShapeNode()
@@ -12,43 +17,146 @@ ShapeNode::ShapeNode(Shape initialShape) : ShapeNode()
     this->shapesToDraw.push_back(initialShape);
 }
 
+void ShapeNode::AddShape(Shape newShape)
+{
+    shapesToDraw.push_back(std::move(newShape));
+    isLocalBoundsDirty = true;
+    if(registeredTree != nullptr)
+    {
+        registeredTree->MarkBoundsDirty(this);
+    }
+}
+
 void ShapeNode::Draw()
 {
+    ShapeBatch* batch = ShapeBatch::GetActive();
+    if(batch != nullptr)
+    {
+        AddToBatch(batch);
+        return;
+    }
 
-    Matrix transMat = GetWorldTransform().GetMatrix();
-    for (auto shape : shapesToDraw)
+    // Not part of a render target's batch, so submit right away
+    static ShapeBatch immediateBatch;
+    AddToBatch(&immediateBatch);
+    immediateBatch.Flush();
+}
+
+void ShapeNode::AddToBatch(ShapeBatch* batch)
+{
+    Affine2D worldTransform = GetWorldAffine();
+    for(const Shape& shape : shapesToDraw)
     {
-        if (shape.isFilled)
-        {
-            std::vector<Vector2> newPoints = shape.points;
+        batch->AddShape(shape, worldTransform);
+    }
+}
 
-            // Determine center point
-            Vector2 center = {0, 0};
-            for (int i = 0; i < newPoints.size(); i++)
-            {
-                newPoints.at(i) = Vector2Transform(newPoints.at(i), transMat);
-                center = Vector2Add(center, newPoints.at(i));
-            }
-            center = {center.x / (float)newPoints.size(), center.y / (float)newPoints.size()};
+uint32_t ShapeNode::GetMaterialKey()
+{
+    return RenderQueue::MATERIAL_SHAPE_BATCH;
+}
 
-            // Really cheap triangulation lol
-            for (int i = 0; i < newPoints.size(); i++)
+void ShapeNode::RecalculateLocalBounds()
+{
+    bool hasPoints = false;
+    Vector2 min = {0, 0};
+    Vector2 max = {0, 0};
+    for(const Shape& shape : shapesToDraw)
+    {
+        // Outlines stick out by half their thickness
+        float padding = shape.isFilled ? 0 : shape.lineWidth / 2.0f;
+        for(const Vector2& point : shape.points)
+        {
+            if(!hasPoints)
             {
-                int first = i;
-                int next = (i + 1) % newPoints.size();
-                DrawTriangle(center, newPoints.at(next), newPoints.at(first), shape.color);
+                min = {point.x - padding, point.y - padding};
+                max = {point.x + padding, point.y + padding};
+                hasPoints = true;
+                continue;
             }
+            min = {std::min(min.x, point.x - padding), std::min(min.y, point.y - padding)};
+            max = {std::max(max.x, point.x + padding), std::max(max.y, point.y + padding)};
+        }
+    }
+    localBounds = {min.x, min.y, max.x - min.x, max.y - min.y};
+    isLocalBoundsDirty = false;
+}
+
+bool ShapeNode::GetWorldBounds(Rectangle* outBounds)
+{
+    if(isLocalBoundsDirty)
+    {
+        RecalculateLocalBounds();
+    }
+
+    // Bounds of the transformed local box (a little loose when rotated, but cheap)
+    Affine2D worldTransform = GetWorldAffine();
+    Vector2 corners[4] = {
+        worldTransform.Apply({localBounds.x, localBounds.y}),
+        worldTransform.Apply({localBounds.x + localBounds.width, localBounds.y}),
+        worldTransform.Apply({localBounds.x, localBounds.y + localBounds.height}),
+        worldTransform.Apply({localBounds.x + localBounds.width, localBounds.y + localBounds.height})};
+
+    Vector2 min = corners[0];
+    Vector2 max = corners[0];
+    for(int i = 1; i < 4; i++)
+    {
+        min = {std::min(min.x, corners[i].x), std::min(min.y, corners[i].y)};
+        max = {std::max(max.x, corners[i].x), std::max(max.y, corners[i].y)};
+    }
+    *outBounds = {min.x, min.y, max.x - min.x, max.y - min.y};
+    return true;
+}
+
+bool ShapeNode::GetQueryGeometry(QueryGeometry* outGeometry)
+{
+    // Note: Outlines are tested as thin lines, line width is ignored
+    Affine2D worldTransform = GetWorldAffine();
+    for(const Shape& shape : shapesToDraw)
+    {
+        outGeometry->AddOutline(shape.points, worldTransform, shape.isClosed);
+    }
+    return !shapesToDraw.empty();
+}
+
+void Shape::UpdateTessellation() const
+{
+    if(!isTessellationDirty)
+    {
+        return;
+    }
+
+    localTriangles.clear();
+    localLines.clear();
+
+    size_t pointCount = points.size();
+    if(pointCount >= 2)
+    {
+        if(isFilled)
+        {
+            ShapeBatch::TriangulatePolygon(points, &localTriangles);
         }
         else
         {
-            for (int i = 0; i < shape.points.size() - 1; i++)
-            {
-                DrawLineEx(Vector2Transform(shape.points[i], transMat), Vector2Transform(shape.points[i + 1], transMat), shape.lineWidth, shape.color);
-            }
-            if (shape.isClosed)
+            size_t segmentCount = isClosed ? pointCount : pointCount - 1;
+            for(size_t i = 0; i < segmentCount; i++)
             {
-                DrawLineEx(Vector2Transform(shape.points[shape.points.size() - 1], transMat), Vector2Transform(shape.points[0], transMat), shape.lineWidth, shape.color);
+                Vector2 start = points[i];
+                Vector2 end = points[(i + 1) % pointCount];
+
+                // Note: Thick lines are expanded in local space, so their width scales with the node
+                if(lineWidth <= 1.0f)
+                {
+                    localLines.push_back(start);
+                    localLines.push_back(end);
+                }
+                else
+                {
+                    ShapeBatch::ExpandLine(start, end, lineWidth, &localTriangles);
+                }
             }
         }
     }
-}
\ No newline at end of file
+
+    isTessellationDirty = false;
+}
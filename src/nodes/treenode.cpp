@@ -0,0 +1,19 @@
+#include "../../include/astrocore/nodes/treenode.h"
+#include "../../include/astrocore/systems/scenetree.h"
+
+using namespace Astrocore;
+
+void TreeNode::SetLayerMask(uint32_t newMask)
+{
+    if(newMask == layerMask)
+    {
+        return;
+    }
+    layerMask = newMask;
+
+    // Move it into the right layer buckets
+    if(registeredTree != nullptr)
+    {
+        registeredTree->OnLayerMaskChanged(this);
+    }
+}
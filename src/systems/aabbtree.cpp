@@ -0,0 +1,257 @@
+#include "../../include/astrocore/systems/aabbtree.h"
+#include <algorithm>
+
+using namespace Astrocore;
+
+AabbTree::AabbTree(float margin)
+{
+    this->margin = margin > 0 ? margin : 0;
+}
+
+int AabbTree::AllocateNode()
+{
+    int node;
+    if(freeList != NULL_TREE_NODE)
+    {
+        node = freeList;
+        freeList = nodes[node].parent;
+    }
+    else
+    {
+        node = nodes.size();
+        nodes.push_back(BoxNode());
+    }
+    nodes[node].parent = NULL_TREE_NODE;
+    nodes[node].child1 = NULL_TREE_NODE;
+    nodes[node].child2 = NULL_TREE_NODE;
+    nodes[node].height = 0;
+    nodes[node].userData = -1;
+    return node;
+}
+
+void AabbTree::FreeNode(int node)
+{
+    nodes[node].parent = freeList;
+    nodes[node].height = -1;
+    freeList = node;
+}
+
+int AabbTree::CreateProxy(const Aabb& bounds, int userData)
+{
+    int proxyID = AllocateNode();
+    nodes[proxyID].bounds = {bounds.minX - margin, bounds.minY - margin, bounds.maxX + margin, bounds.maxY + margin};
+    nodes[proxyID].userData = userData;
+    InsertLeaf(proxyID);
+    proxyCount++;
+    return proxyID;
+}
+
+void AabbTree::DestroyProxy(int proxyID)
+{
+    if(proxyID < 0 || proxyID >= (int)nodes.size() || nodes[proxyID].height != 0)
+    {
+        return;
+    }
+    RemoveLeaf(proxyID);
+    FreeNode(proxyID);
+    proxyCount--;
+}
+
+bool AabbTree::MoveProxy(int proxyID, const Aabb& bounds)
+{
+    if(Contains(nodes[proxyID].bounds, bounds))
+    {
+        // Note: Fat bounds that have gotten much bigger than the proxy (e.g. it shrank) are kept,
+        // they only cost a few extra candidates in queries
+        return false;
+    }
+
+    RemoveLeaf(proxyID);
+    nodes[proxyID].bounds = {bounds.minX - margin, bounds.minY - margin, bounds.maxX + margin, bounds.maxY + margin};
+    InsertLeaf(proxyID);
+    reinsertCount++;
+    return true;
+}
+
+void AabbTree::InsertLeaf(int leaf)
+{
+    if(root == NULL_TREE_NODE)
+    {
+        root = leaf;
+        nodes[root].parent = NULL_TREE_NODE;
+        return;
+    }
+
+    // Walk down to the best sibling, going whichever way grows the tree's total perimeter the least
+    // (a cheap stand in for the surface area heuristic)
+    Aabb leafBounds = nodes[leaf].bounds;
+    int index = root;
+    while(!nodes[index].IsLeaf())
+    {
+        int child1 = nodes[index].child1;
+        int child2 = nodes[index].child2;
+
+        float perimeter = Perimeter(nodes[index].bounds);
+        float combinedPerimeter = Perimeter(Combine(nodes[index].bounds, leafBounds));
+        // Cost of making a new parent for this node and the leaf
+        float cost = 2.0f * combinedPerimeter;
+        // Every node below here grows by at least this much, whichever way we go
+        float inheritanceCost = 2.0f * (combinedPerimeter - perimeter);
+
+        float cost1 = Perimeter(Combine(leafBounds, nodes[child1].bounds)) + inheritanceCost;
+        if(!nodes[child1].IsLeaf())
+        {
+            cost1 -= Perimeter(nodes[child1].bounds);
+        }
+        float cost2 = Perimeter(Combine(leafBounds, nodes[child2].bounds)) + inheritanceCost;
+        if(!nodes[child2].IsLeaf())
+        {
+            cost2 -= Perimeter(nodes[child2].bounds);
+        }
+
+        if(cost < cost1 && cost < cost2)
+        {
+            break;
+        }
+        index = cost1 < cost2 ? child1 : child2;
+    }
+
+    // Replace the sibling with a new parent of it and the leaf
+    int sibling = index;
+    int oldParent = nodes[sibling].parent;
+    int newParent = AllocateNode();
+    nodes[newParent].parent = oldParent;
+    nodes[newParent].bounds = Combine(leafBounds, nodes[sibling].bounds);
+    nodes[newParent].height = nodes[sibling].height + 1;
+    nodes[newParent].child1 = sibling;
+    nodes[newParent].child2 = leaf;
+    nodes[sibling].parent = newParent;
+    nodes[leaf].parent = newParent;
+    if(oldParent == NULL_TREE_NODE)
+    {
+        root = newParent;
+    }
+    else if(nodes[oldParent].child1 == sibling)
+    {
+        nodes[oldParent].child1 = newParent;
+    }
+    else
+    {
+        nodes[oldParent].child2 = newParent;
+    }
+
+    // Refit and rebalance back up to the root
+    index = nodes[leaf].parent;
+    while(index != NULL_TREE_NODE)
+    {
+        index = Balance(index);
+        int child1 = nodes[index].child1;
+        int child2 = nodes[index].child2;
+        nodes[index].height = 1 + std::max(nodes[child1].height, nodes[child2].height);
+        nodes[index].bounds = Combine(nodes[child1].bounds, nodes[child2].bounds);
+        index = nodes[index].parent;
+    }
+}
+
+void AabbTree::RemoveLeaf(int leaf)
+{
+    if(leaf == root)
+    {
+        root = NULL_TREE_NODE;
+        return;
+    }
+
+    // The leaf's sibling takes its parent's place
+    int parent = nodes[leaf].parent;
+    int grandParent = nodes[parent].parent;
+    int sibling = nodes[parent].child1 == leaf ? nodes[parent].child2 : nodes[parent].child1;
+    FreeNode(parent);
+    if(grandParent == NULL_TREE_NODE)
+    {
+        root = sibling;
+        nodes[sibling].parent = NULL_TREE_NODE;
+        return;
+    }
+
+    if(nodes[grandParent].child1 == parent)
+    {
+        nodes[grandParent].child1 = sibling;
+    }
+    else
+    {
+        nodes[grandParent].child2 = sibling;
+    }
+    nodes[sibling].parent = grandParent;
+
+    int index = grandParent;
+    while(index != NULL_TREE_NODE)
+    {
+        index = Balance(index);
+        int child1 = nodes[index].child1;
+        int child2 = nodes[index].child2;
+        nodes[index].bounds = Combine(nodes[child1].bounds, nodes[child2].bounds);
+        nodes[index].height = 1 + std::max(nodes[child1].height, nodes[child2].height);
+        index = nodes[index].parent;
+    }
+}
+
+// If one side of a node is more than one level taller than the other, rotate the taller side's
+// bigger child up into the node's place. Returns whichever node is now where 'a' was
+int AabbTree::Balance(int a)
+{
+    BoxNode& nodeA = nodes[a];
+    if(nodeA.IsLeaf() || nodeA.height < 2)
+    {
+        return a;
+    }
+
+    int b = nodeA.child1;
+    int c = nodeA.child2;
+    int balance = nodes[c].height - nodes[b].height;
+    if(balance >= -1 && balance <= 1)
+    {
+        return a;
+    }
+
+    // Rotate the taller child up, keeping its taller grandchild and giving the other one to 'a'
+    int up = balance > 1 ? c : b;
+    int stay = balance > 1 ? b : c;
+    BoxNode& nodeUp = nodes[up];
+    int f = nodeUp.child1;
+    int g = nodeUp.child2;
+
+    nodeUp.child1 = a;
+    nodeUp.parent = nodeA.parent;
+    nodeA.parent = up;
+    if(nodeUp.parent == NULL_TREE_NODE)
+    {
+        root = up;
+    }
+    else if(nodes[nodeUp.parent].child1 == a)
+    {
+        nodes[nodeUp.parent].child1 = up;
+    }
+    else
+    {
+        nodes[nodeUp.parent].child2 = up;
+    }
+
+    int taller = nodes[f].height > nodes[g].height ? f : g;
+    int shorter = taller == f ? g : f;
+    nodeUp.child2 = taller;
+    if(balance > 1)
+    {
+        nodeA.child2 = shorter;
+    }
+    else
+    {
+        nodeA.child1 = shorter;
+    }
+    nodes[shorter].parent = a;
+
+    nodeA.bounds = Combine(nodes[stay].bounds, nodes[shorter].bounds);
+    nodeA.height = 1 + std::max(nodes[stay].height, nodes[shorter].height);
+    nodeUp.bounds = Combine(nodeA.bounds, nodes[taller].bounds);
+    nodeUp.height = 1 + std::max(nodeA.height, nodes[taller].height);
+    return up;
+}
@@ -0,0 +1,175 @@
+#include "../../include/astrocore/systems/eventqueue.h"
+#include "../../include/astrocore/component/signaler.h"
+#include <algorithm>
+
+using namespace Astrocore;
+
+EventQueue::EventQueue(size_t initialCapacity)
+{
+    size_t capacity = 1;
+    while(capacity < initialCapacity)
+    {
+        capacity *= 2;
+    }
+    ring.resize(capacity);
+}
+
+EventQueue& EventQueue::GetMain()
+{
+    static EventQueue mainQueue;
+    return mainQueue;
+}
+
+void EventQueue::Grow()
+{
+    // Unwrap into a buffer twice the size
+    std::vector<QueuedEvent> grown(ring.size() * 2);
+    for(size_t i = 0; i < count; i++)
+    {
+        grown[i] = ring[(head + i) & (ring.size() - 1)];
+    }
+    ring.swap(grown);
+    head = 0;
+}
+
+void EventQueue::Push(Signaler* sender, EventID eventID)
+{
+    if(count == ring.size())
+    {
+        Grow();
+    }
+    ring[(head + count) & (ring.size() - 1)] = {sender, eventID, 0};
+    count++;
+}
+
+void EventQueue::Cancel(Signaler* sender)
+{
+    for(size_t i = 0; i < count; i++)
+    {
+        QueuedEvent& event = ring[(head + i) & (ring.size() - 1)];
+        if(event.sender == sender)
+        {
+            event.sender = nullptr;
+        }
+    }
+    for(QueuedEvent& event : batch)
+    {
+        if(event.sender == sender)
+        {
+            event.sender = nullptr;
+        }
+    }
+}
+
+void EventQueue::Flush()
+{
+    if(isFlushing)
+    {
+        return;
+    }
+
+    // Take everything queued so far, anything queued by observers waits for the next flush
+    batch.clear();
+    for(size_t i = 0; i < count; i++)
+    {
+        QueuedEvent& event = ring[(head + i) & (ring.size() - 1)];
+        if(event.sender != nullptr)
+        {
+            event.sender->queuedEventCount--;
+            event.sequence = batch.size();
+            batch.push_back(event);
+        }
+    }
+    head = (head + count) & (ring.size() - 1);
+    count = 0;
+    lastQueuedCount = batch.size();
+
+    // Group by event, keeping the order events were queued in within each group
+    std::sort(batch.begin(), batch.end(), [](const QueuedEvent& a, const QueuedEvent& b)
+              { return a.eventID != b.eventID ? a.eventID < b.eventID : a.sequence < b.sequence; });
+
+    // Drop duplicates of coalesced events
+    size_t kept = 0;
+    for(size_t start = 0; start < batch.size();)
+    {
+        EventID eventID = batch[start].eventID;
+        size_t end = start;
+        while(end < batch.size() && batch[end].eventID == eventID)
+        {
+            end++;
+        }
+
+        if(IsCoalesced(eventID))
+        {
+            // Each sender keeps its first event, and the group stays in queue order
+            uint64_t stamp = ++COALESCE_STAMP;
+            for(size_t i = start; i < end; i++)
+            {
+                if(batch[i].sender->coalesceStamp != stamp)
+                {
+                    batch[i].sender->coalesceStamp = stamp;
+                    batch[kept++] = batch[i];
+                }
+            }
+        }
+        else
+        {
+            for(size_t i = start; i < end; i++)
+            {
+                batch[kept++] = batch[i];
+            }
+        }
+        start = end;
+    }
+    batch.resize(kept);
+
+    isFlushing = true;
+    lastDispatchedCount = 0;
+    for(size_t i = 0; i < batch.size(); i++)
+    {
+        // Senders destroyed during the flush get cancelled (nulled out)
+        QueuedEvent event = batch[i];
+        if(event.sender != nullptr)
+        {
+            event.sender->DispatchEvent(event.eventID);
+            lastDispatchedCount++;
+        }
+    }
+    isFlushing = false;
+    batch.clear();
+
+    // Subscription changes made during the flush take effect now
+    for(size_t i = 0; i < pendingSignalers.size(); i++)
+    {
+        pendingSignalers[i]->ApplyPendingChanges();
+    }
+    pendingSignalers.clear();
+}
+
+void EventQueue::SetCoalesced(EventID eventID, bool shouldCoalesce)
+{
+    if(eventID == NULL_EVENT)
+    {
+        return;
+    }
+    if(eventID >= coalescedEvents.size())
+    {
+        coalescedEvents.resize(eventID + 1, 0);
+    }
+    coalescedEvents[eventID] = shouldCoalesce ? 1 : 0;
+}
+
+bool EventQueue::IsCoalesced(EventID eventID)
+{
+    return eventID < coalescedEvents.size() && coalescedEvents[eventID] != 0;
+}
+
+void EventQueue::AddPendingSignaler(Signaler* signaler)
+{
+    pendingSignalers.push_back(signaler);
+}
+
+void EventQueue::RemovePendingSignaler(Signaler* signaler)
+{
+    pendingSignalers.erase(std::remove(pendingSignalers.begin(), pendingSignalers.end(), signaler), pendingSignalers.end());
+}
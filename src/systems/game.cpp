@@ -1,33 +1,131 @@
 #include "../../include/astrocore/systems/game.h"
+#include <chrono>
 using namespace Astrocore;
 
-Game::Game(std::string title, int windowWidth, int windowHeight)
+Game::Game(std::string title, int windowWidth, int windowHeight, RenderBackend* backend)
 {
     Debug::init();
-    InitWindow(windowWidth, windowHeight, title.c_str());
+    if(backend != nullptr)
+    {
+        renderer->SetBackend(backend);
+    }
+    renderer->GetBackend()->OpenWindow(windowWidth, windowHeight, title);
     renderer->SetFinalTargetDimensions(windowWidth, windowHeight);
+
+    jobSystem.Start();
+    sceneTree->SetJobSystem(&jobSystem);
+    resourceManager.Start();
+}
+
+void Game::Step(float frameTime)
+{
+    // Pick up whatever finished loading, so this frame's update can use it
+    {
+        DBG_PROFILE_ZONE("Resources");
+        resourceManager.Update();
+    }
+
+    // Snapshot the input devices, so every query this frame sees the same state
+    {
+        DBG_PROFILE_ZONE("Input");
+        Input::Update();
+        if(inputRecorder != nullptr)
+        {
+            inputRecorder->RecordFrame(frameTime);
+        }
+    }
+
+    // Update
+    {
+        DBG_PROFILE_ZONE("Update");
+        sceneTree->Update(frameTime);
+    }
+
+    // Fixed Update (input edges are only seen by the first fixed step after them)
+    int fixedSteps = fixedTimestep.Advance(frameTime);
+    for(int i = 0; i < fixedSteps; i++)
+    {
+        DBG_PROFILE_ZONE("FixedUpdate");
+        {
+            DBG_PROFILE_ZONE("Physics");
+            physicsWorld.Step(fixedTimestep.GetStepSize());
+        }
+        Input::BeginFixedStep();
+        sceneTree->FixedUpdate(fixedTimestep.GetStepSize());
+        Input::EndFixedStep();
+    }
+
+    // Dispatch the events deferred during the updates, in one batch
+    {
+        DBG_PROFILE_ZONE("Events");
+        EventQueue::GetMain().Flush();
+    }
+
+    // Update all the world transforms at once, before they're used for drawing
+    {
+        DBG_PROFILE_ZONE("Transforms");
+        sceneTree->PropagateTransforms();
+        sceneTree->UpdateSpatialIndex();
+    }
 }
 
 void Game::Run()
 {
-    while(!WindowShouldClose())
+    RenderBackend* backend = renderer->GetBackend();
+    while(!backend->ShouldClose())
 	{
-        // Update
-        sceneTree->GetRoot().lock()->Update(GetFrameTime());
-        // Physics Update
-        // TODO:
-        // Render
-       renderer->Render(sceneTree->drawnNodesInScene.get());
+        {
+            DBG_PROFILE_ZONE("Frame");
+            Step(backend->GetFrameTime());
+
+            // Render
+            DBG_PROFILE_ZONE("Render");
+            renderer->Render(sceneTree.get());
+        }
+        DBG_PROFILE_FRAME();
     }
 
 
-    renderer.reset();
     // Cleanup
-    CloseWindow();
+    // Note: Textures have to go before the window does
+    resourceManager.Shutdown();
+    backend->CloseWindow();
+    renderer.reset();
    
 }
 
+size_t Game::RunReplay(InputReplay* replay, FrameTimeHistogram* frameTimes, bool useRecordedFrameTimes)
+{
+    InputBackend* previousBackend = Input::GetBackend();
+    Input::SetBackend(replay->GetBackend());
+    fixedTimestep.Reset();
+
+    size_t frameCount = 0;
+    float recordedFrameTime;
+    while(replay->NextFrame(&recordedFrameTime))
+    {
+        std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+        {
+            DBG_PROFILE_ZONE("Frame");
+            Step(useRecordedFrameTimes ? recordedFrameTime : fixedTimestep.GetStepSize());
+        }
+        DBG_PROFILE_FRAME();
+        if(frameTimes != nullptr)
+        {
+            frameTimes->AddSample(std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count());
+        }
+        frameCount++;
+    }
+
+    Input::SetBackend(previousBackend);
+    return frameCount;
+}
+
 Game::~Game()
 {
+    sceneTree->SetJobSystem(nullptr);
+    jobSystem.Stop();
+    resourceManager.Shutdown();
     sceneTree.release();
+    Debug::Shutdown();
 }
\ No newline at end of file
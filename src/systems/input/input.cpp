@@ -1,110 +1,230 @@
 #include "../../../include/astrocore/systems/input/input.h"
+#include <algorithm>
+#include <cmath>
 
 using namespace Astrocore;
 
-bool Input::IsActionJustPressed(std::string actionName)
+// Values for sourceEdges
+static const uint8_t SOURCE_PRESSED = 1;
+static const uint8_t SOURCE_RELEASED = 2;
+
+void Input::SetBackend(InputBackend* newBackend)
+{
+    backend = newBackend != nullptr ? newBackend : &defaultBackend;
+}
+
+ActionID Input::GetActionID(std::string_view actionName)
 {
-    if(bindings.find(actionName) != bindings.end())
+    std::unordered_map<std::string_view, ActionID>::iterator it = actionIDs.find(actionName);
+    if(it != actionIDs.end())
     {
-        std::vector<InputAction> actions = bindings.at(actionName);
-        for(InputAction action : actions)
-        {
-            switch (action.type)
-            {
-            case KEYBOARD:
-                return IsKeyPressed(action.id);
-            case MOUSE_BUTTON:
-                return IsMouseButtonPressed(action.id);
-            case JOY_BUTTON:
-                return IsGamepadButtonPressed(action.deviceID, action.id);
-            default:
-                break;
-            }
-        }
+        return it->second;
     }
-    return false;
+
+    ActionID id = actions.size();
+    actions.push_back({std::string(actionName), std::vector<InputAction>()});
+    actionIDs.emplace(actions.back().name, id);
+    isTableDirty = true;
+    return id;
+}
+
+ActionID Input::FindAction(std::string_view actionName)
+{
+    std::unordered_map<std::string_view, ActionID>::iterator it = actionIDs.find(actionName);
+    return it != actionIDs.end() ? it->second : NULL_ACTION;
 }
 
-bool Input::IsActionHeld(std::string actionName)
+void Input::CompileBindings()
 {
-    if(bindings.find(actionName) != bindings.end())
+    sources.clear();
+    actionSources.clear();
+    actionSourceStarts.clear();
+    for(const ActionBinding& action : actions)
     {
-        std::vector<InputAction> actions = bindings.at(actionName);
-        for(InputAction action : actions)
+        actionSourceStarts.push_back(actionSources.size());
+        for(const InputAction& input : action.inputs)
         {
-            switch (action.type)
+            // Inputs bound to several actions are only sampled once
+            std::vector<InputAction>::iterator source = std::find(sources.begin(), sources.end(), input);
+            if(source == sources.end())
             {
-            case KEYBOARD:
-                return IsKeyDown(action.id);
-            case MOUSE_BUTTON:
-                return IsMouseButtonDown(action.id);
-            case JOY_BUTTON:
-                return IsGamepadButtonDown(action.deviceID, action.id);
-            default:
-                break;
+                source = sources.insert(sources.end(), input);
             }
+            actionSources.push_back(source - sources.begin());
         }
     }
-    return false;
+    actionSourceStarts.push_back(actionSources.size());
+
+    sourceValues.assign(sources.size(), 0.0f);
+    sourceEdges.assign(sources.size(), 0);
+    size_t wordCount = (actions.size() + 63) / 64;
+    heldBits.resize(wordCount, 0);
+    previousHeldBits.resize(wordCount, 0);
+    pressedBits.resize(wordCount, 0);
+    releasedBits.resize(wordCount, 0);
+    fixedPressedBits.resize(wordCount, 0);
+    fixedReleasedBits.resize(wordCount, 0);
+    strengths.resize(actions.size(), 0.0f);
+    isTableDirty = false;
 }
 
-bool Input::IsActionJustReleased(std::string actionName)
+// Buttons read as 0 or 1
+float Input::SampleSource(InputBackend* from, const InputAction& source)
 {
-    if(bindings.find(actionName) != bindings.end())
+    switch (source.type)
     {
-        std::vector<InputAction> actions = bindings.at(actionName);
-        for(InputAction action : actions)
-        {
-            switch (action.type)
-            {
-            case KEYBOARD:
-                return IsKeyReleased(action.id);
-            case MOUSE_BUTTON:
-                return IsMouseButtonReleased(action.id);
-            case JOY_BUTTON:
-                return IsGamepadButtonReleased(action.deviceID, action.id);
-            default:
-                break;
-            }
-        }
+    case KEYBOARD:
+        return from->IsKeyDown(source.id) ? 1.0f : 0.0f;
+    case MOUSE_BUTTON:
+        return from->IsMouseButtonDown(source.id) ? 1.0f : 0.0f;
+    case JOY_BUTTON:
+        return from->IsGamepadButtonDown(source.deviceID, source.id) ? 1.0f : 0.0f;
+    case JOY_AXIS:
+        return from->GetGamepadAxis(source.deviceID, source.id);
+    }
+    return 0.0f;
+}
+
+// Presses and releases the backend latched since the last frame (axes don't have any)
+uint8_t Input::SampleSourceEdges(InputBackend* from, const InputAction& source)
+{
+    switch (source.type)
+    {
+    case KEYBOARD:
+        return (from->IsKeyPressed(source.id) ? SOURCE_PRESSED : 0) | (from->IsKeyReleased(source.id) ? SOURCE_RELEASED : 0);
+    case MOUSE_BUTTON:
+        return (from->IsMouseButtonPressed(source.id) ? SOURCE_PRESSED : 0) | (from->IsMouseButtonReleased(source.id) ? SOURCE_RELEASED : 0);
+    case JOY_BUTTON:
+        return (from->IsGamepadButtonPressed(source.deviceID, source.id) ? SOURCE_PRESSED : 0) |
+               (from->IsGamepadButtonReleased(source.deviceID, source.id) ? SOURCE_RELEASED : 0);
+    case JOY_AXIS:
+        return 0;
     }
-    return false;
+    return 0;
 }
 
-float Input::GetActionStrength(std::string actionName)
+void Input::Update()
 {
-    if(bindings.find(actionName) != bindings.end())
+    if(isTableDirty)
     {
-        std::vector<InputAction> actions = bindings.at(actionName);
-        for(InputAction action : actions)
+        CompileBindings();
+    }
+
+    for(size_t i = 0; i < sources.size(); i++)
+    {
+        sourceValues[i] = SampleSource(backend, sources[i]);
+        sourceEdges[i] = SampleSourceEdges(backend, sources[i]);
+    }
+
+    previousHeldBits.swap(heldBits);
+    std::fill(heldBits.begin(), heldBits.end(), 0);
+    std::fill(pressedBits.begin(), pressedBits.end(), 0);
+    std::fill(releasedBits.begin(), releasedBits.end(), 0);
+    for(size_t action = 0; action < actions.size(); action++)
+    {
+        bool isHeld = false;
+        uint8_t edges = 0;
+        float strength = 0.0f;
+        for(uint32_t i = actionSourceStarts[action]; i < actionSourceStarts[action + 1]; i++)
         {
-            switch (action.type)
+            uint32_t source = actionSources[i];
+            float value = sourceValues[source];
+            // Axes only count towards the strength
+            if(sources[source].type != JOY_AXIS && value != 0.0f)
+            {
+                isHeld = true;
+            }
+            edges |= sourceEdges[source];
+            if(fabsf(value) > fabsf(strength))
             {
-            case JOY_AXIS:
-                return GetGamepadAxisMovement(action.deviceID, action.id);
+                strength = value;
             }
         }
+
+        uint64_t bit = (uint64_t)1 << (action & 63);
+        bool wasHeld = TestBit(previousHeldBits, action);
+        if(isHeld)
+        {
+            heldBits[action >> 6] |= bit;
+        }
+        if((isHeld && !wasHeld) || (edges & SOURCE_PRESSED))
+        {
+            pressedBits[action >> 6] |= bit;
+        }
+        if((!isHeld && wasHeld) || (edges & SOURCE_RELEASED))
+        {
+            releasedBits[action >> 6] |= bit;
+        }
+        strengths[action] = strength;
     }
 
-    // Couldn't find a gamepad axis input. Just return if the button is down
-    return IsActionHeld(actionName) ? 1.0f : 0.0f;
+    // Kept until a fixed step sees them
+    for(size_t i = 0; i < pressedBits.size(); i++)
+    {
+        fixedPressedBits[i] |= pressedBits[i];
+        fixedReleasedBits[i] |= releasedBits[i];
+    }
+}
+
+void Input::EndFixedStep()
+{
+    isInFixedStep = false;
+    std::fill(fixedPressedBits.begin(), fixedPressedBits.end(), 0);
+    std::fill(fixedReleasedBits.begin(), fixedReleasedBits.end(), 0);
+}
+
+bool Input::IsActionJustPressed(std::string_view actionName)
+{
+    return IsActionJustPressed(FindAction(actionName));
+}
+
+bool Input::IsActionHeld(std::string_view actionName)
+{
+    return IsActionHeld(FindAction(actionName));
+}
+
+bool Input::IsActionJustReleased(std::string_view actionName)
+{
+    return IsActionJustReleased(FindAction(actionName));
 }
 
-void Input::AddBinding(std::string name, InputAction newAction)
+float Input::GetActionStrength(std::string_view actionName)
 {
-    if(bindings.find(name) == bindings.end())
+    return GetActionStrength(FindAction(actionName));
+}
+
+void Input::AddBinding(std::string_view name, InputAction newAction)
+{
+    actions[GetActionID(name)].inputs.push_back(newAction);
+    isTableDirty = true;
+}
+
+void Input::RemoveBinding(std::string_view name, InputAction newAction)
+{
+    ActionID id = FindAction(name);
+    if(id == NULL_ACTION)
     {
-        bindings.emplace(name, std::vector<InputAction>());
+        return;
     }
-    bindings.at(name).push_back(newAction);
+    std::vector<InputAction>& inputs = actions[id].inputs;
+    inputs.erase(std::remove(inputs.begin(), inputs.end(), newAction), inputs.end());
+    isTableDirty = true;
 }
 
-void Input::ClearBinding(std::string name)
+// The action keeps its ID, it just won't be triggered by anything until it's bound again
+void Input::ClearBinding(std::string_view name)
 {
-    bindings.erase(name);
+    ActionID id = FindAction(name);
+    if(id == NULL_ACTION)
+    {
+        return;
+    }
+    actions[id].inputs.clear();
+    isTableDirty = true;
 }
 
-std::vector<InputAction> Input::GetAllActions(std::string bindingName)
+std::vector<InputAction> Input::GetAllActions(std::string_view bindingName)
 {
-    return bindings.at(bindingName);
-}
\ No newline at end of file
+    ActionID id = FindAction(bindingName);
+    return id != NULL_ACTION ? actions[id].inputs : std::vector<InputAction>();
+}
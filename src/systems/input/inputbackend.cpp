@@ -0,0 +1,138 @@
+#include "../../../include/astrocore/systems/input/inputbackend.h"
+#include <raylib.h>
+
+using namespace Astrocore;
+
+bool RaylibInputBackend::IsKeyDown(int key)
+{
+    return ::IsKeyDown(key);
+}
+
+bool RaylibInputBackend::IsMouseButtonDown(int button)
+{
+    return ::IsMouseButtonDown(button);
+}
+
+bool RaylibInputBackend::IsGamepadButtonDown(int gamepad, int button)
+{
+    return ::IsGamepadButtonDown(gamepad, button);
+}
+
+float RaylibInputBackend::GetGamepadAxis(int gamepad, int axis)
+{
+    return ::GetGamepadAxisMovement(gamepad, axis);
+}
+
+bool RaylibInputBackend::IsKeyPressed(int key)
+{
+    return ::IsKeyPressed(key);
+}
+
+bool RaylibInputBackend::IsKeyReleased(int key)
+{
+    return ::IsKeyReleased(key);
+}
+
+bool RaylibInputBackend::IsMouseButtonPressed(int button)
+{
+    return ::IsMouseButtonPressed(button);
+}
+
+bool RaylibInputBackend::IsMouseButtonReleased(int button)
+{
+    return ::IsMouseButtonReleased(button);
+}
+
+bool RaylibInputBackend::IsGamepadButtonPressed(int gamepad, int button)
+{
+    return ::IsGamepadButtonPressed(gamepad, button);
+}
+
+bool RaylibInputBackend::IsGamepadButtonReleased(int gamepad, int button)
+{
+    return ::IsGamepadButtonReleased(gamepad, button);
+}
+
+// Grows the list to fit the index, so anything never set reads as released
+template <typename T>
+static void SetAt(std::vector<T>& list, int index, T value)
+{
+    if(index < 0)
+    {
+        return;
+    }
+    if(index >= (int)list.size())
+    {
+        list.resize(index + 1, T());
+    }
+    list[index] = value;
+}
+
+template <typename T>
+static T GetAt(const std::vector<T>& list, int index)
+{
+    return index >= 0 && index < (int)list.size() ? list[index] : T();
+}
+
+void SimulatedInputBackend::SetKeyDown(int key, bool isDown)
+{
+    SetAt<uint8_t>(keys, key, isDown ? 1 : 0);
+}
+
+void SimulatedInputBackend::SetMouseButtonDown(int button, bool isDown)
+{
+    SetAt<uint8_t>(mouseButtons, button, isDown ? 1 : 0);
+}
+
+void SimulatedInputBackend::SetGamepadButtonDown(int gamepad, int button, bool isDown)
+{
+    if(gamepad < 0)
+    {
+        return;
+    }
+    if(gamepad >= (int)gamepads.size())
+    {
+        gamepads.resize(gamepad + 1);
+    }
+    SetAt<uint8_t>(gamepads[gamepad].buttons, button, isDown ? 1 : 0);
+}
+
+void SimulatedInputBackend::SetGamepadAxis(int gamepad, int axis, float value)
+{
+    if(gamepad < 0)
+    {
+        return;
+    }
+    if(gamepad >= (int)gamepads.size())
+    {
+        gamepads.resize(gamepad + 1);
+    }
+    SetAt<float>(gamepads[gamepad].axes, axis, value);
+}
+
+void SimulatedInputBackend::Reset()
+{
+    keys.clear();
+    mouseButtons.clear();
+    gamepads.clear();
+}
+
+bool SimulatedInputBackend::IsKeyDown(int key)
+{
+    return GetAt(keys, key) != 0;
+}
+
+bool SimulatedInputBackend::IsMouseButtonDown(int button)
+{
+    return GetAt(mouseButtons, button) != 0;
+}
+
+bool SimulatedInputBackend::IsGamepadButtonDown(int gamepad, int button)
+{
+    return gamepad >= 0 && gamepad < (int)gamepads.size() && GetAt(gamepads[gamepad].buttons, button) != 0;
+}
+
+float SimulatedInputBackend::GetGamepadAxis(int gamepad, int axis)
+{
+    return gamepad >= 0 && gamepad < (int)gamepads.size() ? GetAt(gamepads[gamepad].axes, axis) : 0.0f;
+}
@@ -0,0 +1,277 @@
+#include "../../../include/astrocore/systems/input/inputrecording.h"
+#include "../../../include/astrocore/systems/debug.h"
+#include <cstring>
+
+using namespace Astrocore;
+
+static const uint8_t BUTTON_DOWN_FLAG = 0x80;
+
+// Everything is written little-endian, a byte at a time
+static void WriteU16(std::ostream& stream, uint16_t value)
+{
+    char bytes[2] = {(char)(value & 0xFF), (char)(value >> 8)};
+    stream.write(bytes, 2);
+}
+
+static void WriteFloat(std::ostream& stream, float value)
+{
+    uint32_t bits;
+    memcpy(&bits, &value, sizeof(bits));
+    char bytes[4] = {(char)(bits & 0xFF), (char)((bits >> 8) & 0xFF), (char)((bits >> 16) & 0xFF), (char)(bits >> 24)};
+    stream.write(bytes, 4);
+}
+
+// 7 bits at a time, so small numbers (most key codes, change counts) take a single byte
+static void WriteVarint(std::ostream& stream, uint32_t value)
+{
+    while(value >= 0x80)
+    {
+        stream.put((char)((value & 0x7F) | 0x80));
+        value >>= 7;
+    }
+    stream.put((char)value);
+}
+
+static bool ReadByte(std::istream& stream, uint8_t* value)
+{
+    int byte = stream.get();
+    if(byte == std::char_traits<char>::eof())
+    {
+        return false;
+    }
+    *value = (uint8_t)byte;
+    return true;
+}
+
+static bool ReadU16(std::istream& stream, uint16_t* value)
+{
+    uint8_t low, high;
+    if(!ReadByte(stream, &low) || !ReadByte(stream, &high))
+    {
+        return false;
+    }
+    *value = (uint16_t)(low | (high << 8));
+    return true;
+}
+
+static bool ReadFloat(std::istream& stream, float* value)
+{
+    uint32_t bits = 0;
+    for(int i = 0; i < 4; i++)
+    {
+        uint8_t byte;
+        if(!ReadByte(stream, &byte))
+        {
+            return false;
+        }
+        bits |= (uint32_t)byte << (i * 8);
+    }
+    memcpy(value, &bits, sizeof(bits));
+    return true;
+}
+
+static bool ReadVarint(std::istream& stream, uint32_t* value)
+{
+    *value = 0;
+    for(int shift = 0; shift < 35; shift += 7)
+    {
+        uint8_t byte;
+        if(!ReadByte(stream, &byte))
+        {
+            return false;
+        }
+        *value |= (uint32_t)(byte & 0x7F) << shift;
+        if((byte & 0x80) == 0)
+        {
+            return true;
+        }
+    }
+    return false;
+}
+
+static void ApplyToBackend(SimulatedInputBackend& backend, const InputAction& source, float value)
+{
+    switch (source.type)
+    {
+    case KEYBOARD:
+        backend.SetKeyDown(source.id, value != 0.0f);
+        break;
+    case MOUSE_BUTTON:
+        backend.SetMouseButtonDown(source.id, value != 0.0f);
+        break;
+    case JOY_BUTTON:
+        backend.SetGamepadButtonDown(source.deviceID, source.id, value != 0.0f);
+        break;
+    case JOY_AXIS:
+        backend.SetGamepadAxis(source.deviceID, source.id, value);
+        break;
+    }
+}
+
+void InputRecorder::Begin(std::ostream* outputStream)
+{
+    End();
+    stream = outputStream;
+    recordedState.Reset();
+    frameCount = 0;
+
+    stream->write(INPUT_RECORDING_MAGIC, sizeof(INPUT_RECORDING_MAGIC));
+    WriteU16(*stream, INPUT_RECORDING_VERSION);
+    WriteU16(*stream, 0);   // Reserved
+}
+
+void InputRecorder::End()
+{
+    if(stream != nullptr)
+    {
+        stream->flush();
+        stream = nullptr;
+    }
+}
+
+void InputRecorder::RecordFrame(float frameTime)
+{
+    if(stream == nullptr)
+    {
+        return;
+    }
+
+    // Only what changed since last frame is written
+    changedSources.clear();
+    changedValues.clear();
+    for(size_t i = 0; i < Input::sources.size(); i++)
+    {
+        const InputAction& source = Input::sources[i];
+        float value = Input::sourceValues[i];
+        if(Input::SampleSource(&recordedState, source) != value)
+        {
+            changedSources.push_back(source);
+            changedValues.push_back(value);
+            ApplyToBackend(recordedState, source, value);
+        }
+    }
+
+    WriteFloat(*stream, frameTime);
+    WriteVarint(*stream, changedSources.size());
+    for(size_t i = 0; i < changedSources.size(); i++)
+    {
+        const InputAction& source = changedSources[i];
+        uint8_t type = (uint8_t)source.type;
+        if(source.type != JOY_AXIS && changedValues[i] != 0.0f)
+        {
+            type |= BUTTON_DOWN_FLAG;
+        }
+        stream->put((char)type);
+        stream->put((char)source.deviceID);
+        WriteVarint(*stream, (uint32_t)source.id);
+        if(source.type == JOY_AXIS)
+        {
+            WriteFloat(*stream, changedValues[i]);
+        }
+    }
+    frameCount++;
+}
+
+bool InputReplay::Load(std::istream& inputStream)
+{
+    frameTimes.clear();
+    frameChangeStarts.clear();
+    changes.clear();
+    Rewind();
+
+    char magic[sizeof(INPUT_RECORDING_MAGIC)];
+    uint16_t version, reserved;
+    if(!inputStream.read(magic, sizeof(magic)) || memcmp(magic, INPUT_RECORDING_MAGIC, sizeof(magic)) != 0 ||
+       !ReadU16(inputStream, &version) || !ReadU16(inputStream, &reserved))
+    {
+        DBG_ERR("Not an input recording");
+        return false;
+    }
+    if(version != INPUT_RECORDING_VERSION)
+    {
+        DBG_ERR("Unsupported input recording version {}", version);
+        return false;
+    }
+
+    float frameTime;
+    while(ReadFloat(inputStream, &frameTime))
+    {
+        uint32_t changeCount;
+        if(!ReadVarint(inputStream, &changeCount))
+        {
+            break;
+        }
+
+        bool isFrameComplete = true;
+        size_t frameStart = changes.size();
+        for(uint32_t i = 0; i < changeCount && isFrameComplete; i++)
+        {
+            uint8_t type, device;
+            uint32_t id;
+            float value = 0.0f;
+            isFrameComplete = ReadByte(inputStream, &type) && ReadByte(inputStream, &device) && ReadVarint(inputStream, &id);
+            if(!isFrameComplete)
+            {
+                break;
+            }
+
+            INPUT_TYPE inputType = (INPUT_TYPE)(type & ~BUTTON_DOWN_FLAG);
+            if(inputType == JOY_AXIS)
+            {
+                isFrameComplete = ReadFloat(inputStream, &value);
+            }
+            else
+            {
+                value = (type & BUTTON_DOWN_FLAG) != 0 ? 1.0f : 0.0f;
+            }
+            changes.push_back({InputAction(inputType, (int)id, device), value});
+        }
+
+        // A recording cut off mid-frame (e.g. the game crashed) still plays up to there
+        if(!isFrameComplete)
+        {
+            changes.resize(frameStart, {InputAction(KEYBOARD, 0), 0.0f});
+            DBG_WARN("Input recording ends partway through a frame, ignoring it");
+            break;
+        }
+        frameChangeStarts.push_back(frameStart);
+        frameTimes.push_back(frameTime);
+    }
+    frameChangeStarts.push_back(changes.size());
+    return true;
+}
+
+bool InputReplay::NextFrame(float* frameTime)
+{
+    if(nextFrame >= frameTimes.size())
+    {
+        return false;
+    }
+
+    for(uint32_t i = frameChangeStarts[nextFrame]; i < frameChangeStarts[nextFrame + 1]; i++)
+    {
+        ApplyToBackend(backend, changes[i].source, changes[i].value);
+    }
+    if(frameTime != nullptr)
+    {
+        *frameTime = frameTimes[nextFrame];
+    }
+    nextFrame++;
+    return true;
+}
+
+void InputReplay::Rewind()
+{
+    backend.Reset();
+    nextFrame = 0;
+}
+
+double InputReplay::GetRecordedDuration()
+{
+    double duration = 0;
+    for(float frameTime : frameTimes)
+    {
+        duration += frameTime;
+    }
+    return duration;
+}
@@ -0,0 +1,188 @@
+#include "../../include/astrocore/systems/jobsystem.h"
+
+using namespace Astrocore;
+
+static const size_t INITIAL_QUEUE_CAPACITY = 256;
+
+JobSystem::~JobSystem()
+{
+    Stop();
+}
+
+void JobSystem::Start(int workerCount)
+{
+    if(isRunning)
+    {
+        return;
+    }
+    if(workerCount < 0)
+    {
+        unsigned int cores = std::thread::hardware_concurrency();
+        workerCount = cores > 1 ? cores - 1 : 0;
+    }
+
+    queues.clear();
+    for(int i = 0; i < workerCount + 1; i++)
+    {
+        queues.push_back(std::make_unique<WorkerQueue>());
+        queues.back()->jobs.resize(INITIAL_QUEUE_CAPACITY);
+    }
+    currentSystem = this;
+    currentQueue = 0;
+
+    isRunning = true;
+    for(int i = 0; i < workerCount; i++)
+    {
+        workers.emplace_back(&JobSystem::WorkerLoop, this, i + 1);
+    }
+}
+
+void JobSystem::Stop()
+{
+    if(!isRunning)
+    {
+        return;
+    }
+    // Note: Workers only exit once there's nothing left to run
+    {
+        std::lock_guard<std::mutex> lock(sleepMutex);
+        isRunning = false;
+    }
+    wakeCondition.notify_all();
+    for(std::thread& worker : workers)
+    {
+        worker.join();
+    }
+    workers.clear();
+
+    // Anything submitted since (or with no workers) runs here
+    Job job;
+    while(PopJob(0, &job))
+    {
+        RunJob(job);
+    }
+    if(currentSystem == this)
+    {
+        currentSystem = nullptr;
+    }
+}
+
+void JobSystem::Submit(JobFunction function, void* data, JobCounter* counter)
+{
+    if(counter != nullptr)
+    {
+        counter->pending.fetch_add(1, std::memory_order_relaxed);
+    }
+    if(queues.empty())
+    {
+        // Never started, so there's nowhere to queue it
+        RunJob({function, data, counter});
+        return;
+    }
+
+    // Workers push onto their own queue, any other thread shares the first one
+    WorkerQueue& queue = *queues[currentSystem == this ? currentQueue : 0];
+    {
+        std::lock_guard<std::mutex> lock(queue.mutex);
+        if(queue.tail - queue.head == queue.jobs.size())
+        {
+            std::vector<Job> grown(queue.jobs.size() * 2);
+            for(size_t i = queue.head; i < queue.tail; i++)
+            {
+                grown[i - queue.head] = queue.jobs[i & (queue.jobs.size() - 1)];
+            }
+            queue.tail -= queue.head;
+            queue.head = 0;
+            queue.jobs.swap(grown);
+        }
+        queue.jobs[queue.tail++ & (queue.jobs.size() - 1)] = {function, data, counter};
+    }
+
+    queuedJobCount.fetch_add(1, std::memory_order_release);
+    if(!workers.empty())
+    {
+        // Taking the lock makes sure a worker about to sleep sees the new job
+        { std::lock_guard<std::mutex> lock(sleepMutex); }
+        wakeCondition.notify_one();
+    }
+}
+
+void JobSystem::Wait(JobCounter* counter)
+{
+    size_t queueIndex = currentSystem == this ? currentQueue : 0;
+    Job job;
+    while(!counter->IsDone())
+    {
+        if(!queues.empty() && (PopJob(queueIndex, &job) || StealJob(queueIndex, &job)))
+        {
+            RunJob(job);
+        }
+        else
+        {
+            // Everything left is already running on other threads
+            std::this_thread::yield();
+        }
+    }
+}
+
+bool JobSystem::PopJob(size_t queueIndex, Job* outJob)
+{
+    WorkerQueue& queue = *queues[queueIndex];
+    std::lock_guard<std::mutex> lock(queue.mutex);
+    if(queue.tail == queue.head)
+    {
+        return false;
+    }
+    *outJob = queue.jobs[--queue.tail & (queue.jobs.size() - 1)];
+    queuedJobCount.fetch_sub(1, std::memory_order_relaxed);
+    return true;
+}
+
+bool JobSystem::StealJob(size_t thiefIndex, Job* outJob)
+{
+    // Start with the next queue along, so thieves spread out instead of all hitting the first one
+    for(size_t i = 1; i < queues.size(); i++)
+    {
+        WorkerQueue& queue = *queues[(thiefIndex + i) % queues.size()];
+        std::lock_guard<std::mutex> lock(queue.mutex);
+        if(queue.tail != queue.head)
+        {
+            *outJob = queue.jobs[queue.head++ & (queue.jobs.size() - 1)];
+            queuedJobCount.fetch_sub(1, std::memory_order_relaxed);
+            return true;
+        }
+    }
+    return false;
+}
+
+void JobSystem::RunJob(const Job& job)
+{
+    job.function(job.data);
+    if(job.counter != nullptr)
+    {
+        job.counter->pending.fetch_sub(1, std::memory_order_release);
+    }
+}
+
+void JobSystem::WorkerLoop(size_t queueIndex)
+{
+    currentSystem = this;
+    currentQueue = queueIndex;
+
+    Job job;
+    while(true)
+    {
+        if(PopJob(queueIndex, &job) || StealJob(queueIndex, &job))
+        {
+            RunJob(job);
+            continue;
+        }
+
+        std::unique_lock<std::mutex> lock(sleepMutex);
+        wakeCondition.wait(lock, [this]{ return queuedJobCount.load(std::memory_order_acquire) > 0 || !isRunning; });
+        if(!isRunning && queuedJobCount.load(std::memory_order_acquire) == 0)
+        {
+            return;
+        }
+    }
+}
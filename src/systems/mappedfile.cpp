@@ -0,0 +1,84 @@
+#include "../../include/astrocore/systems/mappedfile.h"
+#include "../../include/astrocore/systems/debug.h"
+#include <fstream>
+
+#ifdef _WIN32
+#define ASTROCORE_NO_MMAP
+#else
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <fcntl.h>
+#include <unistd.h>
+#endif
+
+using namespace Astrocore;
+
+MappedFile::~MappedFile()
+{
+    Close();
+}
+
+bool MappedFile::Open(const std::string& path)
+{
+    Close();
+
+#ifndef ASTROCORE_NO_MMAP
+    int file = open(path.c_str(), O_RDONLY);
+    if(file < 0)
+    {
+        DBG_ERR("Couldn't open {}", path);
+        return false;
+    }
+    struct stat fileInfo;
+    if(fstat(file, &fileInfo) != 0 || fileInfo.st_size <= 0)
+    {
+        DBG_ERR("Couldn't read {}", path);
+        close(file);
+        return false;
+    }
+    void* mapping = mmap(nullptr, fileInfo.st_size, PROT_READ, MAP_PRIVATE, file, 0);
+    // The mapping keeps the file open on its own
+    close(file);
+    if(mapping == MAP_FAILED)
+    {
+        DBG_ERR("Couldn't map {}", path);
+        return false;
+    }
+    data = (const unsigned char*)mapping;
+    size = fileInfo.st_size;
+    isMapped = true;
+#else
+    std::ifstream file(path, std::ios::binary | std::ios::ate);
+    if(!file || file.tellg() <= 0)
+    {
+        DBG_ERR("Couldn't open {}", path);
+        return false;
+    }
+    buffer.resize((size_t)file.tellg());
+    file.seekg(0);
+    if(!file.read((char*)buffer.data(), buffer.size()))
+    {
+        DBG_ERR("Couldn't read {}", path);
+        buffer.clear();
+        return false;
+    }
+    data = buffer.data();
+    size = buffer.size();
+#endif
+    return true;
+}
+
+void MappedFile::Close()
+{
+#ifndef ASTROCORE_NO_MMAP
+    if(isMapped)
+    {
+        munmap((void*)data, size);
+    }
+#endif
+    buffer.clear();
+    buffer.shrink_to_fit();
+    data = nullptr;
+    size = 0;
+    isMapped = false;
+}
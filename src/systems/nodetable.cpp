@@ -0,0 +1,83 @@
+#include "../../include/astrocore/systems/nodetable.h"
+
+using namespace Astrocore;
+
+NodeHandle NodeTable::Add(TreeNode* node)
+{
+    uint32_t slotIndex;
+    if(!freeSlots.empty())
+    {
+        slotIndex = freeSlots.back();
+        freeSlots.pop_back();
+    }
+    else
+    {
+        slotIndex = slots.size();
+        slots.push_back(Slot());
+    }
+
+    Slot& slot = slots[slotIndex];
+    slot.denseIndex = nodes.size();
+    nodes.push_back(node);
+    denseToSlot.push_back(slotIndex);
+
+    NodeHandle handle;
+    handle.index = slotIndex;
+    handle.generation = slot.generation;
+    return handle;
+}
+
+bool NodeTable::Remove(NodeHandle handle)
+{
+    if(!IsValid(handle))
+    {
+        return false;
+    }
+
+    Slot& slot = slots[handle.index];
+    uint32_t denseIndex = slot.denseIndex;
+    uint32_t lastIndex = nodes.size() - 1;
+
+    // Move the last node into the gap
+    if(denseIndex != lastIndex)
+    {
+        nodes[denseIndex] = nodes[lastIndex];
+        denseToSlot[denseIndex] = denseToSlot[lastIndex];
+        slots[denseToSlot[denseIndex]].denseIndex = denseIndex;
+    }
+    nodes.pop_back();
+    denseToSlot.pop_back();
+
+    // Invalidate every outstanding handle to this slot
+    slot.denseIndex = UINT32_MAX;
+    slot.generation++;
+    freeSlots.push_back(handle.index);
+    return true;
+}
+
+TreeNode* NodeTable::Get(NodeHandle handle) const
+{
+    if(!IsValid(handle))
+    {
+        return nullptr;
+    }
+    return nodes[slots[handle.index].denseIndex];
+}
+
+bool NodeTable::IsValid(NodeHandle handle) const
+{
+    return handle.index < slots.size() && slots[handle.index].generation == handle.generation &&
+           slots[handle.index].denseIndex != UINT32_MAX;
+}
+
+void NodeTable::Clear()
+{
+    for(uint32_t slotIndex : denseToSlot)
+    {
+        slots[slotIndex].denseIndex = UINT32_MAX;
+        slots[slotIndex].generation++;
+        freeSlots.push_back(slotIndex);
+    }
+    nodes.clear();
+    denseToSlot.clear();
+}
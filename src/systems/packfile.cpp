@@ -0,0 +1,567 @@
+#include "../../include/astrocore/systems/packfile.h"
+#include "../../include/astrocore/systems/debug.h"
+#include <algorithm>
+#include <climits>
+#include <cstring>
+#include <fstream>
+#include <lz4.h>
+#include <lz4hc.h>
+#include <zstd.h>
+
+using namespace Astrocore;
+
+// The file layout is the in-memory layout, so it can't change without bumping the version
+static_assert(sizeof(PackFileHeader) == 40, "Pack file header layout changed");
+static_assert(sizeof(PackFileEntry) == 48, "Pack file entry layout changed");
+
+// Build time matters much less than load time, so packs get the slow, small settings
+static const int PACK_ZSTD_LEVEL = 19;
+
+static inline uint64_t AlignPack(uint64_t offset, uint64_t alignment)
+{
+    return (offset + alignment - 1) & ~(alignment - 1);
+}
+
+// Paths
+
+static inline std::string_view TrimPackPath(std::string_view path)
+{
+    while(path.size() >= 2 && path[0] == '.' && (path[1] == '/' || path[1] == '\\'))
+    {
+        path.remove_prefix(2);
+    }
+    return path;
+}
+
+static inline char NormalizePackChar(char c)
+{
+    return c == '\\' ? '/' : c;
+}
+
+uint64_t Astrocore::HashPackPath(std::string_view path)
+{
+    // FNV-1a
+    uint64_t hash = 14695981039346656037ull;
+    for(char c : TrimPackPath(path))
+    {
+        hash ^= (unsigned char)NormalizePackChar(c);
+        hash *= 1099511628211ull;
+    }
+    return hash;
+}
+
+static bool IsSamePackPath(std::string_view packPath, std::string_view path)
+{
+    path = TrimPackPath(path);
+    if(packPath.size() != path.size())
+    {
+        return false;
+    }
+    for(size_t i = 0; i < path.size(); i++)
+    {
+        if(packPath[i] != NormalizePackChar(path[i]))
+        {
+            return false;
+        }
+    }
+    return true;
+}
+
+// The extension raylib's memory loaders want, e.g. ".png"
+static std::string GetPackFileType(std::string_view path)
+{
+    size_t dot = path.find_last_of("./");
+    if(dot == std::string_view::npos || path[dot] != '.')
+    {
+        return "";
+    }
+    return std::string(path.substr(dot));
+}
+
+// Chunks
+
+static inline uint64_t GetChunkCount(const PackFileEntry* entry, uint32_t chunkSize)
+{
+    // Rounded up without adding to size first, which could wrap around for a corrupt one
+    return entry->size / chunkSize + (entry->size % chunkSize != 0);
+}
+
+static ZSTD_DCtx* GetThreadZstdContext()
+{
+    // zstd contexts are expensive to make, so each thread keeps one (nothing carries over between chunks)
+    struct ContextHolder
+    {
+        ZSTD_DCtx* context = ZSTD_createDCtx();
+        ~ContextHolder() { ZSTD_freeDCtx(context); }
+    };
+    thread_local ContextHolder holder;
+    return holder.context;
+}
+
+// Loading
+
+bool PackFile::Open(const std::string& path)
+{
+    Close();
+    if(!file.Open(path))
+    {
+        return false;
+    }
+    if(!Validate())
+    {
+        DBG_ERR("{} isn't a valid pack", path);
+        Close();
+        return false;
+    }
+    return true;
+}
+
+void PackFile::Close()
+{
+    file.Close();
+    header = nullptr;
+    entries = nullptr;
+    names = nullptr;
+}
+
+bool PackFile::Validate()
+{
+    const unsigned char* data = file.GetData();
+    uint64_t size = file.GetSize();
+    if(size < sizeof(PackFileHeader))
+    {
+        return false;
+    }
+    const PackFileHeader* fileHeader = (const PackFileHeader*)data;
+    if(memcmp(fileHeader->magic, PACK_FILE_MAGIC, sizeof(PACK_FILE_MAGIC)) != 0)
+    {
+        return false;
+    }
+    if(fileHeader->version != PACK_FILE_VERSION)
+    {
+        DBG_ERR("Unsupported pack version {}", fileHeader->version);
+        return false;
+    }
+    // Chunk sizes get handed to LZ4 as ints, so only the size the writer uses is trusted
+    if(fileHeader->chunkSize != PACK_CHUNK_SIZE || fileHeader->entriesOffset % 8 != 0 || fileHeader->entriesOffset > size ||
+       (uint64_t)fileHeader->entryCount * sizeof(PackFileEntry) > size - fileHeader->entriesOffset ||
+       fileHeader->namesOffset > size || fileHeader->nameBytes > size - fileHeader->namesOffset)
+    {
+        return false;
+    }
+    const PackFileEntry* fileEntries = (const PackFileEntry*)(data + fileHeader->entriesOffset);
+    const char* fileNames = (const char*)(data + fileHeader->namesOffset);
+
+    // Lookups binary search the hashes, so they have to be sorted and match the paths
+    for(uint32_t i = 0; i < fileHeader->entryCount; i++)
+    {
+        const PackFileEntry& entry = fileEntries[i];
+        if(entry.offset > size || entry.storedSize > size - entry.offset || entry.compression > PACK_ZSTD ||
+           (uint64_t)entry.nameOffset + entry.nameLength > fileHeader->nameBytes ||
+           (i > 0 && entry.pathHash < fileEntries[i - 1].pathHash) ||
+           entry.pathHash != HashPackPath({fileNames + entry.nameOffset, entry.nameLength}))
+        {
+            return false;
+        }
+        // Compressed entries can't be bigger than their chunk table has room for, since reads trust the size
+        uint64_t maxChunkCount = entry.storedSize / sizeof(uint64_t);
+        bool isSizeValid = entry.compression == PACK_STORED ? entry.storedSize == entry.size
+                           : entry.offset % 8 == 0 && GetChunkCount(&entry, fileHeader->chunkSize) <= maxChunkCount;
+        if(!isSizeValid)
+        {
+            return false;
+        }
+    }
+
+    header = fileHeader;
+    entries = fileEntries;
+    names = fileNames;
+    return true;
+}
+
+const PackFileEntry* PackFile::Find(std::string_view path) const
+{
+    if(header == nullptr)
+    {
+        return nullptr;
+    }
+    uint64_t hash = HashPackPath(path);
+    const PackFileEntry* end = entries + header->entryCount;
+    const PackFileEntry* entry = std::lower_bound(entries, end, hash,
+        [](const PackFileEntry& entry, uint64_t hash) { return entry.pathHash < hash; });
+    for(; entry != end && entry->pathHash == hash; entry++)
+    {
+        if(IsSamePackPath(GetEntryPath(entry), path))
+        {
+            return entry;
+        }
+    }
+    return nullptr;
+}
+
+bool PackFile::DecompressChunk(const PackFileEntry* entry, uint64_t chunk, unsigned char* output) const
+{
+    const unsigned char* base = file.GetData() + entry->offset;
+    uint64_t chunkCount = GetChunkCount(entry, header->chunkSize);
+    uint64_t tableBytes = chunkCount * sizeof(uint64_t);
+    const uint64_t* chunkEnds = (const uint64_t*)base;
+    uint64_t start = chunk == 0 ? 0 : chunkEnds[chunk - 1];
+    uint64_t end = chunkEnds[chunk];
+    uint64_t rawSize = std::min<uint64_t>(header->chunkSize, entry->size - chunk * header->chunkSize);
+    if(start > end || end > entry->storedSize - tableBytes)
+    {
+        DBG_ERR("{} is corrupt", GetEntryPath(entry));
+        return false;
+    }
+
+    const unsigned char* source = base + tableBytes + start;
+    uint64_t sourceSize = end - start;
+    bool isDecompressed;
+    if(sourceSize == rawSize)
+    {
+        memcpy(output, source, rawSize);
+        isDecompressed = true;
+    }
+    else if(entry->compression == PACK_LZ4)
+    {
+        isDecompressed = sourceSize <= INT_MAX &&
+                         LZ4_decompress_safe((const char*)source, (char*)output, sourceSize, rawSize) == (int)rawSize;
+    }
+    else
+    {
+        size_t result = ZSTD_decompressDCtx(GetThreadZstdContext(), output, rawSize, source, sourceSize);
+        isDecompressed = !ZSTD_isError(result) && result == rawSize;
+    }
+    if(!isDecompressed)
+    {
+        DBG_ERR("{} is corrupt", GetEntryPath(entry));
+    }
+    return isDecompressed;
+}
+
+bool PackFile::Decompress(const PackFileEntry* entry, unsigned char* output) const
+{
+    if(entry->compression == PACK_STORED)
+    {
+        memcpy(output, file.GetData() + entry->offset, entry->size);
+        return true;
+    }
+    uint64_t chunkCount = GetChunkCount(entry, header->chunkSize);
+    for(uint64_t chunk = 0; chunk < chunkCount; chunk++)
+    {
+        if(!DecompressChunk(entry, chunk, output + chunk * header->chunkSize))
+        {
+            return false;
+        }
+    }
+    return true;
+}
+
+PackView PackFile::GetView(std::string_view path) const
+{
+    const PackFileEntry* entry = Find(path);
+    if(entry == nullptr || entry->compression != PACK_STORED)
+    {
+        return PackView();
+    }
+    return {file.GetData() + entry->offset, (size_t)entry->size};
+}
+
+bool PackFile::Read(std::string_view path, std::vector<unsigned char>* output) const
+{
+    const PackFileEntry* entry = Find(path);
+    if(entry == nullptr)
+    {
+        return false;
+    }
+    output->resize(entry->size);
+    return Decompress(entry, output->data());
+}
+
+PackStream PackFile::OpenStream(std::string_view path) const
+{
+    const PackFileEntry* entry = Find(path);
+    return entry != nullptr ? PackStream(this, entry) : PackStream();
+}
+
+unsigned char* PackFile::LoadFileData(std::string_view path, int* dataSize) const
+{
+    *dataSize = 0;
+    const PackFileEntry* entry = Find(path);
+    if(entry == nullptr || entry->size > INT_MAX)
+    {
+        DBG_WARN("Couldn't load {} from the pack", path);
+        return nullptr;
+    }
+    // MemAlloc() is what raylib's UnloadFileData() frees
+    unsigned char* data = (unsigned char*)MemAlloc(entry->size > 0 ? entry->size : 1);
+    if(!Decompress(entry, data))
+    {
+        MemFree(data);
+        return nullptr;
+    }
+    *dataSize = entry->size;
+    return data;
+}
+
+Image PackFile::LoadImage(std::string_view path) const
+{
+    const PackFileEntry* entry = Find(path);
+    if(entry == nullptr || entry->size > INT_MAX)
+    {
+        DBG_WARN("Couldn't load {} from the pack", path);
+        return Image();
+    }
+    std::string fileType = GetPackFileType(path);
+    if(entry->compression == PACK_STORED)
+    {
+        return LoadImageFromMemory(fileType.c_str(), file.GetData() + entry->offset, entry->size);
+    }
+    std::vector<unsigned char> data(entry->size);
+    return Decompress(entry, data.data()) ? LoadImageFromMemory(fileType.c_str(), data.data(), data.size()) : Image();
+}
+
+Wave PackFile::LoadWave(std::string_view path) const
+{
+    const PackFileEntry* entry = Find(path);
+    if(entry == nullptr || entry->size > INT_MAX)
+    {
+        DBG_WARN("Couldn't load {} from the pack", path);
+        return Wave();
+    }
+    std::string fileType = GetPackFileType(path);
+    if(entry->compression == PACK_STORED)
+    {
+        return LoadWaveFromMemory(fileType.c_str(), file.GetData() + entry->offset, entry->size);
+    }
+    std::vector<unsigned char> data(entry->size);
+    return Decompress(entry, data.data()) ? LoadWaveFromMemory(fileType.c_str(), data.data(), data.size()) : Wave();
+}
+
+// Streaming
+
+size_t PackStream::Read(void* buffer, size_t bytes)
+{
+    if(entry == nullptr)
+    {
+        return 0;
+    }
+    unsigned char* output = (unsigned char*)buffer;
+    size_t bytesRead = 0;
+    uint32_t chunkSize = pack->header->chunkSize;
+    while(bytesRead < bytes && position < entry->size)
+    {
+        size_t count;
+        if(entry->compression == PACK_STORED)
+        {
+            count = std::min<uint64_t>(bytes - bytesRead, entry->size - position);
+            memcpy(output + bytesRead, pack->file.GetData() + entry->offset + position, count);
+        }
+        else
+        {
+            uint64_t currentChunk = position / chunkSize;
+            uint64_t chunkStart = currentChunk * chunkSize;
+            uint64_t rawSize = std::min<uint64_t>(chunkSize, entry->size - chunkStart);
+            if(chunkIndex != currentChunk)
+            {
+                chunk.resize(rawSize);
+                if(!pack->DecompressChunk(entry, currentChunk, chunk.data()))
+                {
+                    chunkIndex = UINT64_MAX;
+                    break;
+                }
+                chunkIndex = currentChunk;
+            }
+            count = std::min<uint64_t>(bytes - bytesRead, rawSize - (position - chunkStart));
+            memcpy(output + bytesRead, chunk.data() + (position - chunkStart), count);
+        }
+        bytesRead += count;
+        position += count;
+    }
+    return bytesRead;
+}
+
+bool PackStream::Seek(uint64_t newPosition)
+{
+    if(entry == nullptr || newPosition > entry->size)
+    {
+        return false;
+    }
+    position = newPosition;
+    return true;
+}
+
+// Writing
+
+// Splits data in to chunks and compresses each one, in the entry layout
+static void CompressPackEntry(const unsigned char* data, uint64_t size, PACK_COMPRESSION compression, std::vector<unsigned char>* packed)
+{
+    uint64_t chunkCount = (size + PACK_CHUNK_SIZE - 1) / PACK_CHUNK_SIZE;
+    uint64_t tableBytes = chunkCount * sizeof(uint64_t);
+    packed->assign(tableBytes, 0);
+    std::vector<unsigned char> compressed(compression == PACK_LZ4 ? LZ4_compressBound(PACK_CHUNK_SIZE) : ZSTD_compressBound(PACK_CHUNK_SIZE));
+    ZSTD_CCtx* zstdContext = nullptr;
+    if(compression == PACK_ZSTD)
+    {
+        // With a checksum, corrupt chunks fail to decompress instead of quietly giving back garbage
+        zstdContext = ZSTD_createCCtx();
+        ZSTD_CCtx_setParameter(zstdContext, ZSTD_c_compressionLevel, PACK_ZSTD_LEVEL);
+        ZSTD_CCtx_setParameter(zstdContext, ZSTD_c_checksumFlag, 1);
+    }
+    for(uint64_t chunk = 0; chunk < chunkCount; chunk++)
+    {
+        const unsigned char* source = data + chunk * PACK_CHUNK_SIZE;
+        uint64_t rawSize = std::min<uint64_t>(PACK_CHUNK_SIZE, size - chunk * PACK_CHUNK_SIZE);
+        uint64_t compressedSize;
+        if(compression == PACK_LZ4)
+        {
+            compressedSize = LZ4_compress_HC((const char*)source, (char*)compressed.data(), rawSize, compressed.size(), LZ4HC_CLEVEL_DEFAULT);
+        }
+        else
+        {
+            size_t result = ZSTD_compress2(zstdContext, compressed.data(), compressed.size(), source, rawSize);
+            compressedSize = ZSTD_isError(result) ? 0 : result;
+        }
+
+        // Chunks are stored raw when compression doesn't help (which is also how they're told apart)
+        if(compressedSize == 0 || compressedSize >= rawSize)
+        {
+            packed->insert(packed->end(), source, source + rawSize);
+        }
+        else
+        {
+            packed->insert(packed->end(), compressed.data(), compressed.data() + compressedSize);
+        }
+        uint64_t chunkEnd = packed->size() - tableBytes;
+        memcpy(packed->data() + chunk * sizeof(uint64_t), &chunkEnd, sizeof(chunkEnd));
+    }
+    ZSTD_freeCCtx(zstdContext);
+}
+
+static bool ReadDiskFile(const std::string& path, std::vector<unsigned char>* data)
+{
+    std::ifstream file(path, std::ios::binary | std::ios::ate);
+    if(!file)
+    {
+        return false;
+    }
+    data->resize((size_t)file.tellg());
+    file.seekg(0);
+    return (bool)file.read((char*)data->data(), data->size());
+}
+
+bool PackWriter::AddPending(PendingEntry&& entry)
+{
+    std::string& path = entry.path;
+    path = std::string(TrimPackPath(path));
+    std::replace(path.begin(), path.end(), '\\', '/');
+    if(!paths.insert(path).second)
+    {
+        DBG_ERR("The pack already has {}", path);
+        return false;
+    }
+    pending.push_back(std::move(entry));
+    return true;
+}
+
+bool PackWriter::AddFile(const std::string& path, const std::string& diskPath, PACK_COMPRESSION compression)
+{
+    return AddPending({path, diskPath, {}, compression});
+}
+
+bool PackWriter::AddData(const std::string& path, const void* data, size_t size, PACK_COMPRESSION compression)
+{
+    const unsigned char* bytes = (const unsigned char*)data;
+    return AddPending({path, "", std::vector<unsigned char>(bytes, bytes + size), compression});
+}
+
+bool PackWriter::Write(const std::string& outputPath)
+{
+    std::ofstream output(outputPath, std::ios::binary | std::ios::trunc);
+    if(!output)
+    {
+        DBG_ERR("Couldn't open {} for writing", outputPath);
+        return false;
+    }
+
+    // Entry data goes in the order it was added, so related files can be kept together
+    PackFileHeader header = PackFileHeader();
+    output.write((const char*)&header, sizeof(header));
+    uint64_t offset = sizeof(header);
+    static const char zeros[PACK_DATA_ALIGNMENT] = {};
+
+    std::vector<PackFileEntry> fileEntries;
+    std::string fileNames;
+    std::vector<unsigned char> diskData;
+    std::vector<unsigned char> packed;
+    for(const PendingEntry& pendingEntry : pending)
+    {
+        const std::vector<unsigned char>* data = &pendingEntry.data;
+        if(!pendingEntry.diskPath.empty())
+        {
+            if(!ReadDiskFile(pendingEntry.diskPath, &diskData))
+            {
+                DBG_ERR("Couldn't read {}", pendingEntry.diskPath);
+                return false;
+            }
+            data = &diskData;
+        }
+
+        PackFileEntry entry = PackFileEntry();
+        entry.pathHash = HashPackPath(pendingEntry.path);
+        entry.size = data->size();
+        entry.nameOffset = fileNames.size();
+        entry.nameLength = pendingEntry.path.size();
+        fileNames += pendingEntry.path;
+
+        const std::vector<unsigned char>* stored = data;
+        entry.compression = PACK_STORED;
+        if(pendingEntry.compression != PACK_STORED && !data->empty())
+        {
+            CompressPackEntry(data->data(), data->size(), pendingEntry.compression, &packed);
+            if(packed.size() < data->size())
+            {
+                stored = &packed;
+                entry.compression = pendingEntry.compression;
+            }
+        }
+
+        uint64_t aligned = AlignPack(offset, PACK_DATA_ALIGNMENT);
+        output.write(zeros, aligned - offset);
+        entry.offset = aligned;
+        entry.storedSize = stored->size();
+        output.write((const char*)stored->data(), stored->size());
+        offset = aligned + stored->size();
+        fileEntries.push_back(entry);
+    }
+
+    std::sort(fileEntries.begin(), fileEntries.end(), [&fileNames](const PackFileEntry& a, const PackFileEntry& b)
+    {
+        if(a.pathHash != b.pathHash)
+        {
+            return a.pathHash < b.pathHash;
+        }
+        return fileNames.compare(a.nameOffset, a.nameLength, fileNames, b.nameOffset, b.nameLength) < 0;
+    });
+
+    memcpy(header.magic, PACK_FILE_MAGIC, sizeof(PACK_FILE_MAGIC));
+    header.version = PACK_FILE_VERSION;
+    header.entryCount = fileEntries.size();
+    header.chunkSize = PACK_CHUNK_SIZE;
+    header.entriesOffset = AlignPack(offset, 8);
+    header.namesOffset = header.entriesOffset + fileEntries.size() * sizeof(PackFileEntry);
+    header.nameBytes = fileNames.size();
+    output.write(zeros, header.entriesOffset - offset);
+    output.write((const char*)fileEntries.data(), fileEntries.size() * sizeof(PackFileEntry));
+    output.write(fileNames.data(), fileNames.size());
+    output.seekp(0);
+    output.write((const char*)&header, sizeof(header));
+    output.flush();
+
+    if(!output)
+    {
+        DBG_ERR("Couldn't write {}", outputPath);
+        return false;
+    }
+    return true;
+}
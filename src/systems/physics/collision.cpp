@@ -0,0 +1,244 @@
+#include "../../../include/astrocore/systems/physics/collision.h"
+#include <raymath.h>
+#include <algorithm>
+#include <cfloat>
+#include <cmath>
+
+using namespace Astrocore;
+
+// Hulls with more vertices than this (e.g. high resolution circles) get decimated
+static const int MAX_POLYGON_VERTICES = 32;
+// How much better the second polygon's axis has to be before it's used as the reference face,
+// so the choice doesn't flip back and forth between frames
+static const float REFERENCE_FACE_TOLERANCE = 0.05f;
+
+static inline float Cross(Vector2 a, Vector2 b)
+{
+    return a.x * b.y - a.y * b.x;
+}
+
+bool ConvexPolygon::Build(const std::vector<Vector2>& points)
+{
+    vertices.clear();
+    normals.clear();
+    if(points.size() < 3)
+    {
+        return false;
+    }
+
+    // Andrew's monotone chain, which gives the hull counter clockwise without collinear points
+    std::vector<Vector2> sorted = points;
+    std::sort(sorted.begin(), sorted.end(), [](const Vector2& a, const Vector2& b)
+    {
+        return a.x < b.x || (a.x == b.x && a.y < b.y);
+    });
+    std::vector<Vector2> hull(sorted.size() * 2);
+    size_t count = 0;
+    for(size_t i = 0; i < sorted.size(); i++)
+    {
+        while(count >= 2 && Cross(Vector2Subtract(hull[count - 1], hull[count - 2]), Vector2Subtract(sorted[i], hull[count - 2])) <= 0)
+        {
+            count--;
+        }
+        hull[count++] = sorted[i];
+    }
+    size_t lowerCount = count + 1;
+    for(size_t i = sorted.size() - 1; i > 0; i--)
+    {
+        while(count >= lowerCount && Cross(Vector2Subtract(hull[count - 1], hull[count - 2]), Vector2Subtract(sorted[i - 1], hull[count - 2])) <= 0)
+        {
+            count--;
+        }
+        hull[count++] = sorted[i - 1];
+    }
+    count--;    // The last point is the first one again
+    if(count < 3)
+    {
+        return false;
+    }
+
+    if(count > (size_t)MAX_POLYGON_VERTICES)
+    {
+        for(int i = 0; i < MAX_POLYGON_VERTICES; i++)
+        {
+            vertices.push_back(hull[i * count / MAX_POLYGON_VERTICES]);
+        }
+    }
+    else
+    {
+        vertices.assign(hull.begin(), hull.begin() + count);
+    }
+
+    // Area, centroid and inertia, summed over the triangles fanning out from the first vertex
+    Vector2 origin = vertices[0];
+    Vector2 center = {0, 0};
+    float inertiaAboutOrigin = 0;
+    area = 0;
+    for(size_t i = 1; i + 1 < vertices.size(); i++)
+    {
+        Vector2 edge1 = Vector2Subtract(vertices[i], origin);
+        Vector2 edge2 = Vector2Subtract(vertices[i + 1], origin);
+        float doubleArea = Cross(edge1, edge2);
+        area += doubleArea * 0.5f;
+        center = Vector2Add(center, Vector2Scale(Vector2Add(edge1, edge2), doubleArea * 0.5f / 3.0f));
+
+        float xSquared = edge1.x * edge1.x + edge2.x * edge1.x + edge2.x * edge2.x;
+        float ySquared = edge1.y * edge1.y + edge2.y * edge1.y + edge2.y * edge2.y;
+        inertiaAboutOrigin += (0.25f / 3.0f * doubleArea) * (xSquared + ySquared);
+    }
+    if(area <= FLT_EPSILON)
+    {
+        vertices.clear();
+        return false;
+    }
+    center = Vector2Scale(center, 1.0f / area);
+    inertia = inertiaAboutOrigin - area * Vector2DotProduct(center, center);
+    centroid = Vector2Add(origin, center);
+
+    radius = 0;
+    for(Vector2& vertex : vertices)
+    {
+        vertex = Vector2Subtract(vertex, centroid);
+        radius = std::max(radius, Vector2Length(vertex));
+    }
+    for(size_t i = 0; i < vertices.size(); i++)
+    {
+        Vector2 edge = Vector2Subtract(vertices[(i + 1) % vertices.size()], vertices[i]);
+        normals.push_back(Vector2Normalize({edge.y, -edge.x}));
+    }
+    return true;
+}
+
+// The axis of the first polygon that the second polygon sticks out past the most (the
+// deepest point of the second polygon behind each of the first polygon's faces)
+static float FindMaxSeparation(const Vector2* verticesA, const Vector2* normalsA, int countA, const Vector2* verticesB, int countB, int* outEdge)
+{
+    float maxSeparation = -FLT_MAX;
+    for(int i = 0; i < countA; i++)
+    {
+        float minDistance = FLT_MAX;
+        for(int j = 0; j < countB; j++)
+        {
+            minDistance = std::min(minDistance, Vector2DotProduct(normalsA[i], Vector2Subtract(verticesB[j], verticesA[i])));
+        }
+        if(minDistance > maxSeparation)
+        {
+            maxSeparation = minDistance;
+            *outEdge = i;
+        }
+    }
+    return maxSeparation;
+}
+
+// Keeps the part of a segment behind a plane (dot(normal, p) <= offset), returning the points left
+static int ClipSegment(const Vector2 segmentIn[2], Vector2 segmentOut[2], Vector2 normal, float offset)
+{
+    float distance0 = Vector2DotProduct(normal, segmentIn[0]) - offset;
+    float distance1 = Vector2DotProduct(normal, segmentIn[1]) - offset;
+
+    int count = 0;
+    if(distance0 <= 0)
+    {
+        segmentOut[count++] = segmentIn[0];
+    }
+    if(distance1 <= 0)
+    {
+        segmentOut[count++] = segmentIn[1];
+    }
+    if(distance0 * distance1 < 0)
+    {
+        float t = distance0 / (distance0 - distance1);
+        segmentOut[count++] = Vector2Lerp(segmentIn[0], segmentIn[1], t);
+    }
+    return count;
+}
+
+bool Astrocore::CollidePolygons(const ConvexPolygon& polygonA, const PolygonTransform& transformA,
+                                const ConvexPolygon& polygonB, const PolygonTransform& transformB, ContactManifold* outManifold)
+{
+    Vector2 verticesA[MAX_POLYGON_VERTICES], normalsA[MAX_POLYGON_VERTICES];
+    Vector2 verticesB[MAX_POLYGON_VERTICES], normalsB[MAX_POLYGON_VERTICES];
+    int countA = polygonA.vertices.size();
+    int countB = polygonB.vertices.size();
+    for(int i = 0; i < countA; i++)
+    {
+        verticesA[i] = transformA.Apply(polygonA.vertices[i]);
+        normalsA[i] = transformA.Rotate(polygonA.normals[i]);
+    }
+    for(int i = 0; i < countB; i++)
+    {
+        verticesB[i] = transformB.Apply(polygonB.vertices[i]);
+        normalsB[i] = transformB.Rotate(polygonB.normals[i]);
+    }
+
+    int edgeA = 0;
+    float separationA = FindMaxSeparation(verticesA, normalsA, countA, verticesB, countB, &edgeA);
+    if(separationA > 0)
+    {
+        return false;
+    }
+    int edgeB = 0;
+    float separationB = FindMaxSeparation(verticesB, normalsB, countB, verticesA, countA, &edgeB);
+    if(separationB > 0)
+    {
+        return false;
+    }
+
+    // The face closest to being a separating axis is the reference, the other polygon's most
+    // opposed edge gets clipped against it
+    bool isFlipped = separationB > separationA + REFERENCE_FACE_TOLERANCE;
+    const Vector2* referenceVertices = isFlipped ? verticesB : verticesA;
+    const Vector2* referenceNormals = isFlipped ? normalsB : normalsA;
+    int referenceCount = isFlipped ? countB : countA;
+    int referenceEdge = isFlipped ? edgeB : edgeA;
+    const Vector2* incidentVertices = isFlipped ? verticesA : verticesB;
+    const Vector2* incidentNormals = isFlipped ? normalsA : normalsB;
+    int incidentCount = isFlipped ? countA : countB;
+
+    Vector2 normal = referenceNormals[referenceEdge];
+    int incidentEdge = 0;
+    float minDot = FLT_MAX;
+    for(int i = 0; i < incidentCount; i++)
+    {
+        float dot = Vector2DotProduct(normal, incidentNormals[i]);
+        if(dot < minDot)
+        {
+            minDot = dot;
+            incidentEdge = i;
+        }
+    }
+    Vector2 incident[2] = {incidentVertices[incidentEdge], incidentVertices[(incidentEdge + 1) % incidentCount]};
+
+    Vector2 face1 = referenceVertices[referenceEdge];
+    Vector2 face2 = referenceVertices[(referenceEdge + 1) % referenceCount];
+    Vector2 tangent = Vector2Normalize(Vector2Subtract(face2, face1));
+
+    // Clip to the sides of the reference face
+    Vector2 clipped1[2], clipped2[2];
+    if(ClipSegment(incident, clipped1, Vector2Negate(tangent), -Vector2DotProduct(tangent, face1)) < 2)
+    {
+        return false;
+    }
+    if(ClipSegment(clipped1, clipped2, tangent, Vector2DotProduct(tangent, face2)) < 2)
+    {
+        return false;
+    }
+
+    // Whatever is behind the reference face is in contact
+    float faceOffset = Vector2DotProduct(normal, face1);
+    outManifold->pointCount = 0;
+    for(int i = 0; i < 2; i++)
+    {
+        float separation = Vector2DotProduct(normal, clipped2[i]) - faceOffset;
+        if(separation <= 0)
+        {
+            // Keep the points on the second polygon, whichever one the reference face was on
+            Vector2 point = isFlipped ? Vector2Subtract(clipped2[i], Vector2Scale(normal, separation)) : clipped2[i];
+            outManifold->points[outManifold->pointCount] = point;
+            outManifold->depths[outManifold->pointCount] = -separation;
+            outManifold->pointCount++;
+        }
+    }
+    outManifold->normal = isFlipped ? Vector2Negate(normal) : normal;
+    return outManifold->pointCount > 0;
+}
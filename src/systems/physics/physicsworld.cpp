@@ -0,0 +1,841 @@
+#include "../../../include/astrocore/systems/physics/physicsworld.h"
+#include "../../../include/astrocore/nodes/shapenode.h"
+#include "../../../include/astrocore/systems/debug.h"
+#include <raymath.h>
+#include <algorithm>
+#include <cmath>
+
+using namespace Astrocore;
+
+static const float LINEAR_SLOP = 0.5f;              // Overlap allowed before positions get pushed apart (pixels)
+static const float POSITION_CORRECTION = 0.8f;      // Fraction of the overlap pushed out per iteration
+static const float MAX_POSITION_CORRECTION = 2.0f;  // Pixels per iteration, so deep overlaps get eased apart instead of jumping
+static const int POSITION_ITERATIONS = 3;
+static const float MAX_BLOCK_CONDITION = 1000.0f;   // Past this, two contact points get solved one at a time
+static const float RESTITUTION_THRESHOLD = 30.0f;   // Slower impacts than this don't bounce (pixels/second)
+static const float LINEAR_SLEEP_TOLERANCE = 2.0f;   // How far a body can drift (pixels) and still count as still
+static const float ANGULAR_SLEEP_TOLERANCE = 0.1f;  // And turn (radians)
+static const float TIME_TO_SLEEP = 0.5f;            // Seconds an island has to stay still before it sleeps
+static const float SWEEP_AXIS_HYSTERESIS = 1.5f;    // How much more spread out the other axis has to be to switch to it
+static const float ANCHOR_MATCH_DISTANCE = 4.0f;    // How far a contact point can move between steps and still be the same one
+static const size_t MAX_INSERTION_SORT_ADDS = 64;   // Bodies added since the last step before the broadphase gets fully re-sorted
+
+static inline float Cross(Vector2 a, Vector2 b)
+{
+    return a.x * b.y - a.y * b.x;
+}
+
+// Angular velocity crossed with an offset: the linear velocity the rotation gives that point
+static inline Vector2 Cross(float angularVelocity, Vector2 offset)
+{
+    return {-angularVelocity * offset.y, angularVelocity * offset.x};
+}
+
+PolygonID PhysicsWorld::CreatePolygon(const std::vector<Vector2>& points)
+{
+    ConvexPolygon polygon;
+    if(!polygon.Build(points))
+    {
+        return NULL_POLYGON;
+    }
+    polygons.push_back(std::move(polygon));
+    return polygons.size() - 1;
+}
+
+PolygonID PhysicsWorld::CreatePolygon(const Shape& shape)
+{
+    return CreatePolygon(shape.points);
+}
+
+PhysicsWorld::~PhysicsWorld()
+{
+    // The nodes can outlive the world, they'd try to remove their bodies from it
+    for(Node* node : nodes)
+    {
+        if(node != nullptr)
+        {
+            node->physicsWorld = nullptr;
+            node->physicsBody = NULL_BODY;
+        }
+    }
+}
+
+BodyID PhysicsWorld::AddBody(const BodyDef& def)
+{
+    if(def.polygon < 0 || def.polygon >= (int)polygons.size())
+    {
+        return NULL_BODY;
+    }
+
+    BodyID id;
+    if(!freeIDs.empty())
+    {
+        id = freeIDs.back();
+        freeIDs.pop_back();
+    }
+    else
+    {
+        id = idToIndex.size();
+        idToIndex.push_back(-1);
+    }
+    int index = positions.size();
+    idToIndex[id] = index;
+    indexToID.push_back(id);
+
+    const ConvexPolygon& polygon = polygons[def.polygon];
+    positions.push_back(Vector2Add(def.position, Vector2Rotate(polygon.centroid, def.angle)));
+    angles.push_back(def.angle);
+    velocities.push_back(def.velocity);
+    angularVelocities.push_back(def.angularVelocity);
+    if(def.type == BODY_DYNAMIC)
+    {
+        inverseMasses.push_back(1.0f / (def.density * polygon.area));
+        inverseInertias.push_back(1.0f / (def.density * polygon.inertia));
+    }
+    else
+    {
+        inverseMasses.push_back(0);
+        inverseInertias.push_back(0);
+    }
+    frictions.push_back(def.friction);
+    restitutions.push_back(def.restitution);
+    sleepTimes.push_back(0);
+    sleepPositions.push_back(positions.back());
+    sleepAngles.push_back(def.angle);
+    types.push_back(def.type);
+    isAwake.push_back(def.type != BODY_STATIC);
+    bodyPolygons.push_back(def.polygon);
+    bounds.push_back(Aabb());
+    nodes.push_back(def.node);
+    UpdateBounds(index);
+    if(def.node != nullptr)
+    {
+        if(def.node->physicsWorld != nullptr)
+        {
+            DBG_WARN("Node {} already had a body, it won't be moved by that one anymore", def.node->name);
+            def.node->physicsWorld->nodes[def.node->physicsWorld->idToIndex[def.node->physicsBody]] = nullptr;
+        }
+        def.node->physicsWorld = this;
+        def.node->physicsBody = id;
+    }
+
+    sweepEntries.push_back({0, 0, 0, 0, id, index, false});
+    addedSinceSort++;
+    return id;
+}
+
+void PhysicsWorld::RemoveBody(BodyID body)
+{
+    if(!IsValid(body))
+    {
+        return;
+    }
+
+    int index = idToIndex[body];
+    // A whole pool is being torn down, there's nothing worth waking
+    if(Node::BULK_TEARDOWN_DEPTH == 0)
+    {
+        WakeTouching(index);
+    }
+    if(nodes[index] != nullptr)
+    {
+        nodes[index]->physicsWorld = nullptr;
+        nodes[index]->physicsBody = NULL_BODY;
+    }
+
+    // Swap the last body into the removed one's place
+    int last = positions.size() - 1;
+    positions[index] = positions[last];
+    angles[index] = angles[last];
+    velocities[index] = velocities[last];
+    angularVelocities[index] = angularVelocities[last];
+    inverseMasses[index] = inverseMasses[last];
+    inverseInertias[index] = inverseInertias[last];
+    frictions[index] = frictions[last];
+    restitutions[index] = restitutions[last];
+    sleepTimes[index] = sleepTimes[last];
+    sleepPositions[index] = sleepPositions[last];
+    sleepAngles[index] = sleepAngles[last];
+    types[index] = types[last];
+    isAwake[index] = isAwake[last];
+    bodyPolygons[index] = bodyPolygons[last];
+    bounds[index] = bounds[last];
+    nodes[index] = nodes[last];
+    indexToID[index] = indexToID[last];
+    idToIndex[indexToID[index]] = index;
+
+    positions.pop_back();
+    angles.pop_back();
+    velocities.pop_back();
+    angularVelocities.pop_back();
+    inverseMasses.pop_back();
+    inverseInertias.pop_back();
+    frictions.pop_back();
+    restitutions.pop_back();
+    sleepTimes.pop_back();
+    sleepPositions.pop_back();
+    sleepAngles.pop_back();
+    types.pop_back();
+    isAwake.pop_back();
+    bodyPolygons.pop_back();
+    bounds.pop_back();
+    nodes.pop_back();
+    indexToID.pop_back();
+
+    // Note: The broadphase drops its entry on the next step, the ID can't be reused before then
+    idToIndex[body] = -1;
+    removedIDs.push_back(body);
+}
+
+bool PhysicsWorld::IsValid(BodyID body)
+{
+    return body >= 0 && body < (int)idToIndex.size() && idToIndex[body] >= 0;
+}
+
+Vector2 PhysicsWorld::GetPosition(BodyID body)
+{
+    int index = idToIndex[body];
+    return Vector2Subtract(positions[index], Vector2Rotate(polygons[bodyPolygons[index]].centroid, angles[index]));
+}
+
+float PhysicsWorld::GetAngle(BodyID body)
+{
+    return angles[idToIndex[body]];
+}
+
+Vector2 PhysicsWorld::GetVelocity(BodyID body)
+{
+    return velocities[idToIndex[body]];
+}
+
+void PhysicsWorld::SetTransform(BodyID body, Vector2 position, float angle)
+{
+    int index = idToIndex[body];
+    // Wake what it's leaving behind and what it lands on
+    WakeTouching(index);
+    positions[index] = Vector2Add(position, Vector2Rotate(polygons[bodyPolygons[index]].centroid, angle));
+    angles[index] = angle;
+    UpdateBounds(index);
+    WakeIndex(index);
+    WakeTouching(index);
+}
+
+void PhysicsWorld::SetVelocity(BodyID body, Vector2 velocity, float angularVelocity)
+{
+    int index = idToIndex[body];
+    velocities[index] = velocity;
+    angularVelocities[index] = angularVelocity;
+    WakeIndex(index);
+}
+
+void PhysicsWorld::ApplyImpulse(BodyID body, Vector2 impulse)
+{
+    int index = idToIndex[body];
+    velocities[index] = Vector2Add(velocities[index], Vector2Scale(impulse, inverseMasses[index]));
+    WakeIndex(index);
+}
+
+bool PhysicsWorld::IsAwake(BodyID body)
+{
+    return isAwake[idToIndex[body]];
+}
+
+void PhysicsWorld::Wake(BodyID body)
+{
+    WakeIndex(idToIndex[body]);
+}
+
+void PhysicsWorld::WakeIndex(int index)
+{
+    if(types[index] != BODY_STATIC)
+    {
+        isAwake[index] = true;
+        sleepTimes[index] = 0;
+    }
+}
+
+void PhysicsWorld::WakeTouching(int index)
+{
+    // Only sleeping bodies need waking. Their bounds haven't changed since the last broadphase, so their
+    // entries are still sorted and anything touching the box starts within the largest body size of it.
+    // Entries added since then are all awake (or static) and can be skipped
+    // Resting contacts overlap by up to the slop, the margin catches anything sitting right on the edge
+    const Aabb& box = bounds[index];
+    float low = (isSweepingY ? box.minY : box.minX) - LINEAR_SLOP - maxMovingExtent;
+    float high = (isSweepingY ? box.maxY : box.maxX) + LINEAR_SLOP;
+    auto sortedEnd = sweepEntries.end() - addedSinceSort;
+    auto first = std::lower_bound(sweepEntries.begin(), sortedEnd, low, [](const SweepEntry& entry, float value) { return entry.min < value; });
+    for(auto entry = first; entry != sortedEnd && entry->min <= high; entry++)
+    {
+        int other = idToIndex[entry->body];
+        if(other < 0 || other == index || isAwake[other] || types[other] == BODY_STATIC)
+        {
+            continue;
+        }
+        const Aabb& otherBox = bounds[other];
+        if(otherBox.minX <= box.maxX + LINEAR_SLOP && box.minX <= otherBox.maxX + LINEAR_SLOP &&
+           otherBox.minY <= box.maxY + LINEAR_SLOP && box.minY <= otherBox.maxY + LINEAR_SLOP)
+        {
+            WakeIndex(other);
+        }
+    }
+}
+
+size_t PhysicsWorld::GetAwakeCount()
+{
+    size_t count = 0;
+    for(size_t i = 0; i < isAwake.size(); i++)
+    {
+        count += isAwake[i];
+    }
+    return count;
+}
+
+void PhysicsWorld::UpdateBounds(int index)
+{
+    const ConvexPolygon& polygon = polygons[bodyPolygons[index]];
+    PolygonTransform transform = {positions[index], sinf(angles[index]), cosf(angles[index])};
+    Aabb& box = bounds[index];
+    box = {INFINITY, INFINITY, -INFINITY, -INFINITY};
+    for(const Vector2& vertex : polygon.vertices)
+    {
+        Vector2 point = transform.Apply(vertex);
+        box.minX = std::min(box.minX, point.x);
+        box.minY = std::min(box.minY, point.y);
+        box.maxX = std::max(box.maxX, point.x);
+        box.maxY = std::max(box.maxY, point.y);
+    }
+}
+
+void PhysicsWorld::Step(float deltaTime)
+{
+    if(deltaTime <= 0)
+    {
+        return;
+    }
+
+    for(size_t i = 0; i < positions.size(); i++)
+    {
+        if(isAwake[i] && types[i] == BODY_DYNAMIC)
+        {
+            velocities[i] = Vector2Add(velocities[i], Vector2Scale(gravity, deltaTime));
+        }
+        if(isAwake[i])
+        {
+            UpdateBounds(i);
+        }
+    }
+
+    UpdateBroadphase();
+    FindContacts();
+    WarmStart();
+    SolveVelocities();
+    CacheContacts();
+
+    for(size_t i = 0; i < positions.size(); i++)
+    {
+        if(isAwake[i])
+        {
+            positions[i] = Vector2Add(positions[i], Vector2Scale(velocities[i], deltaTime));
+            angles[i] += angularVelocities[i] * deltaTime;
+        }
+    }
+    CorrectPositions();
+
+    SyncNodes();
+    UpdateSleep(deltaTime);
+}
+
+void PhysicsWorld::UpdateBroadphase()
+{
+    // Sweep along whichever axis the bodies are most spread out on, so fewer of them overlap on it
+    double sumX = 0, sumY = 0, sumSquaredX = 0, sumSquaredY = 0;
+    for(const Aabb& box : bounds)
+    {
+        double centerX = (box.minX + box.maxX) * 0.5;
+        double centerY = (box.minY + box.maxY) * 0.5;
+        sumX += centerX;
+        sumY += centerY;
+        sumSquaredX += centerX * centerX;
+        sumSquaredY += centerY * centerY;
+    }
+    double count = std::max<size_t>(bounds.size(), 1);
+    double varianceX = sumSquaredX / count - (sumX / count) * (sumX / count);
+    double varianceY = sumSquaredY / count - (sumY / count) * (sumY / count);
+    bool wasSweepingY = isSweepingY;
+    if(isSweepingY ? varianceX > varianceY * SWEEP_AXIS_HYSTERESIS : varianceY > varianceX * SWEEP_AXIS_HYSTERESIS)
+    {
+        isSweepingY = !isSweepingY;
+    }
+
+    // Refresh the entries in place, dropping removed bodies
+    size_t kept = 0;
+    maxMovingExtent = 0;
+    for(size_t i = 0; i < sweepEntries.size(); i++)
+    {
+        SweepEntry entry = sweepEntries[i];
+        int index = idToIndex[entry.body];
+        if(index < 0)
+        {
+            continue;
+        }
+        const Aabb& box = bounds[index];
+        entry.min = isSweepingY ? box.minY : box.minX;
+        entry.max = isSweepingY ? box.maxY : box.maxX;
+        entry.crossMin = isSweepingY ? box.minX : box.minY;
+        entry.crossMax = isSweepingY ? box.maxX : box.maxY;
+        entry.index = index;
+        entry.isActive = isAwake[index];
+        if(types[index] != BODY_STATIC)
+        {
+            maxMovingExtent = std::max(maxMovingExtent, entry.max - entry.min);
+        }
+        sweepEntries[kept++] = entry;
+    }
+    sweepEntries.resize(kept);
+    freeIDs.insert(freeIDs.end(), removedIDs.begin(), removedIDs.end());
+    removedIDs.clear();
+
+    // Bodies only move a little each step, so last step's order is nearly sorted already and an
+    // insertion sort only has a few entries to move. New bodies are just tacked on the end though,
+    // so lots of them at once (e.g. loading a level) get a full sort instead
+    sortSwapCount = 0;
+    if(wasSweepingY != isSweepingY || addedSinceSort > MAX_INSERTION_SORT_ADDS)
+    {
+        std::sort(sweepEntries.begin(), sweepEntries.end(), [](const SweepEntry& a, const SweepEntry& b) { return a.min < b.min; });
+        sortSwapCount = sweepEntries.size();
+    }
+    else
+    {
+        for(size_t i = 1; i < sweepEntries.size(); i++)
+        {
+            SweepEntry entry = sweepEntries[i];
+            size_t j = i;
+            while(j > 0 && sweepEntries[j - 1].min > entry.min)
+            {
+                sweepEntries[j] = sweepEntries[j - 1];
+                j--;
+            }
+            sweepEntries[j] = entry;
+            sortSwapCount += i - j;
+        }
+    }
+    addedSinceSort = 0;
+
+    // Everything that overlaps an entry along the axis comes right after it
+    pairs.clear();
+    for(size_t i = 0; i < sweepEntries.size(); i++)
+    {
+        const SweepEntry& entry = sweepEntries[i];
+        for(size_t j = i + 1; j < sweepEntries.size() && sweepEntries[j].min <= entry.max; j++)
+        {
+            const SweepEntry& other = sweepEntries[j];
+            // Two bodies that can't move can't start touching
+            if(!entry.isActive && !other.isActive)
+            {
+                continue;
+            }
+            if(other.crossMin <= entry.crossMax && entry.crossMin <= other.crossMax)
+            {
+                pairs.push_back({entry.index, other.index});
+            }
+        }
+    }
+}
+
+void PhysicsWorld::FindContacts()
+{
+    contacts.clear();
+    for(const std::pair<int, int>& pair : pairs)
+    {
+        // Lower ID first, so the same two bodies always make the same contact
+        int a = indexToID[pair.first] < indexToID[pair.second] ? pair.first : pair.second;
+        int b = a == pair.first ? pair.second : pair.first;
+        if(inverseMasses[a] == 0 && inverseMasses[b] == 0)
+        {
+            continue;
+        }
+
+        PolygonTransform transformA = {positions[a], sinf(angles[a]), cosf(angles[a])};
+        PolygonTransform transformB = {positions[b], sinf(angles[b]), cosf(angles[b])};
+        ContactManifold manifold;
+        if(!CollidePolygons(polygons[bodyPolygons[a]], transformA, polygons[bodyPolygons[b]], transformB, &manifold))
+        {
+            continue;
+        }
+
+        // Something awake ran into a sleeping body
+        if(!isAwake[a])
+        {
+            WakeIndex(a);
+        }
+        if(!isAwake[b])
+        {
+            WakeIndex(b);
+        }
+
+        Contact contact;
+        contact.bodyA = a;
+        contact.bodyB = b;
+        contact.normal = manifold.normal;
+        contact.pointCount = manifold.pointCount;
+        contact.localNormal = Vector2Rotate(manifold.normal, -angles[a]);
+        contact.friction = sqrtf(frictions[a] * frictions[b]);
+        float restitution = std::max(restitutions[a], restitutions[b]);
+        Vector2 tangent = {contact.normal.y, -contact.normal.x};
+
+        for(int i = 0; i < manifold.pointCount; i++)
+        {
+            ContactPoint& point = contact.points[i];
+            point.offsetA = Vector2Subtract(manifold.points[i], positions[a]);
+            point.offsetB = Vector2Subtract(manifold.points[i], positions[b]);
+            point.depth = manifold.depths[i];
+            point.normalImpulse = 0;
+            point.tangentImpulse = 0;
+
+            float normalA = Cross(point.offsetA, contact.normal);
+            float normalB = Cross(point.offsetB, contact.normal);
+            point.normalMass = 1.0f / (inverseMasses[a] + inverseMasses[b] + inverseInertias[a] * normalA * normalA + inverseInertias[b] * normalB * normalB);
+            float tangentA = Cross(point.offsetA, tangent);
+            float tangentB = Cross(point.offsetB, tangent);
+            point.tangentMass = 1.0f / (inverseMasses[a] + inverseMasses[b] + inverseInertias[a] * tangentA * tangentA + inverseInertias[b] * tangentB * tangentB);
+
+            Vector2 relativeVelocity = Vector2Subtract(Vector2Add(velocities[b], Cross(angularVelocities[b], point.offsetB)),
+                                                       Vector2Add(velocities[a], Cross(angularVelocities[a], point.offsetA)));
+            float approachSpeed = Vector2DotProduct(relativeVelocity, contact.normal);
+            point.velocityBias = approachSpeed < -RESTITUTION_THRESHOLD ? -restitution * approachSpeed : 0;
+
+            // The point on each surface, so the overlap can be measured again as the bodies move
+            point.localAnchorA = Vector2Rotate(Vector2Add(point.offsetA, Vector2Scale(contact.normal, point.depth)), -angles[a]);
+            point.localAnchorB = Vector2Rotate(point.offsetB, -angles[b]);
+        }
+
+        // Two points get solved together (see SolveVelocities), if they aren't so close together
+        // that doing so would be badly conditioned
+        contact.isBlockSolved = false;
+        if(contact.pointCount == 2)
+        {
+            const ContactPoint& point1 = contact.points[0];
+            const ContactPoint& point2 = contact.points[1];
+            float normalA1 = Cross(point1.offsetA, contact.normal);
+            float normalB1 = Cross(point1.offsetB, contact.normal);
+            float normalA2 = Cross(point2.offsetA, contact.normal);
+            float normalB2 = Cross(point2.offsetB, contact.normal);
+            float inverseMassSum = inverseMasses[a] + inverseMasses[b];
+            float k11 = inverseMassSum + inverseInertias[a] * normalA1 * normalA1 + inverseInertias[b] * normalB1 * normalB1;
+            float k22 = inverseMassSum + inverseInertias[a] * normalA2 * normalA2 + inverseInertias[b] * normalB2 * normalB2;
+            float k12 = inverseMassSum + inverseInertias[a] * normalA1 * normalA2 + inverseInertias[b] * normalB1 * normalB2;
+            float determinant = k11 * k22 - k12 * k12;
+            if(k11 * k11 < MAX_BLOCK_CONDITION * determinant)
+            {
+                contact.isBlockSolved = true;
+                contact.blockK[0] = k11;
+                contact.blockK[1] = k12;
+                contact.blockK[2] = k22;
+                contact.blockMass[0] = k22 / determinant;
+                contact.blockMass[1] = -k12 / determinant;
+                contact.blockMass[2] = k11 / determinant;
+            }
+        }
+        contacts.push_back(contact);
+    }
+}
+
+static inline void ApplyContactImpulse(Vector2 impulse, Vector2 offsetA, Vector2 offsetB, float inverseMassA, float inverseInertiaA, float inverseMassB, float inverseInertiaB,
+                                Vector2* velocityA, float* angularVelocityA, Vector2* velocityB, float* angularVelocityB)
+{
+    *velocityA = Vector2Subtract(*velocityA, Vector2Scale(impulse, inverseMassA));
+    *angularVelocityA -= inverseInertiaA * Cross(offsetA, impulse);
+    *velocityB = Vector2Add(*velocityB, Vector2Scale(impulse, inverseMassB));
+    *angularVelocityB += inverseInertiaB * Cross(offsetB, impulse);
+}
+
+void PhysicsWorld::WarmStart()
+{
+    // Contacts that were already touching last step start from the impulses they ended with,
+    // which is what lets stacks settle instead of jittering
+    for(Contact& contact : contacts)
+    {
+        std::unordered_map<uint64_t, CachedContact>::iterator cached = contactCache.find(((uint64_t)indexToID[contact.bodyA] << 32) | (uint32_t)indexToID[contact.bodyB]);
+        if(cached == contactCache.end())
+        {
+            continue;
+        }
+
+        int a = contact.bodyA;
+        int b = contact.bodyB;
+        Vector2 tangent = {contact.normal.y, -contact.normal.x};
+        for(int i = 0; i < contact.pointCount; i++)
+        {
+            ContactPoint& point = contact.points[i];
+            Vector2 anchor = Vector2Rotate(point.offsetA, -angles[a]);
+            for(int j = 0; j < cached->second.pointCount; j++)
+            {
+                if(Vector2DistanceSqr(anchor, cached->second.localAnchors[j]) < ANCHOR_MATCH_DISTANCE * ANCHOR_MATCH_DISTANCE)
+                {
+                    point.normalImpulse = cached->second.normalImpulses[j];
+                    point.tangentImpulse = cached->second.tangentImpulses[j];
+                    break;
+                }
+            }
+
+            Vector2 impulse = Vector2Add(Vector2Scale(contact.normal, point.normalImpulse), Vector2Scale(tangent, point.tangentImpulse));
+            ApplyContactImpulse(impulse, point.offsetA, point.offsetB, inverseMasses[a], inverseInertias[a], inverseMasses[b], inverseInertias[b],
+                                &velocities[a], &angularVelocities[a], &velocities[b], &angularVelocities[b]);
+        }
+    }
+}
+
+void PhysicsWorld::CacheContacts()
+{
+    nextContactCache.clear();
+    for(const Contact& contact : contacts)
+    {
+        CachedContact& cached = nextContactCache[((uint64_t)indexToID[contact.bodyA] << 32) | (uint32_t)indexToID[contact.bodyB]];
+        cached.pointCount = contact.pointCount;
+        for(int i = 0; i < contact.pointCount; i++)
+        {
+            cached.localAnchors[i] = Vector2Rotate(contact.points[i].offsetA, -angles[contact.bodyA]);
+            cached.normalImpulses[i] = contact.points[i].normalImpulse;
+            cached.tangentImpulses[i] = contact.points[i].tangentImpulse;
+        }
+    }
+    contactCache.swap(nextContactCache);
+}
+
+void PhysicsWorld::SolveVelocities()
+{
+    // Sequential impulses: nudge each contact towards resolved in turn, a few times over
+    for(int iteration = 0; iteration < velocityIterations; iteration++)
+    {
+        for(Contact& contact : contacts)
+        {
+            int a = contact.bodyA;
+            int b = contact.bodyB;
+            Vector2 tangent = {contact.normal.y, -contact.normal.x};
+
+            for(int i = 0; i < contact.pointCount; i++)
+            {
+                ContactPoint& point = contact.points[i];
+
+                // Friction, limited by how hard the contact is being pushed together
+                Vector2 relativeVelocity = Vector2Subtract(Vector2Add(velocities[b], Cross(angularVelocities[b], point.offsetB)),
+                                                           Vector2Add(velocities[a], Cross(angularVelocities[a], point.offsetA)));
+                float maxFriction = contact.friction * point.normalImpulse;
+                float tangentImpulse = std::clamp(point.tangentImpulse - point.tangentMass * Vector2DotProduct(relativeVelocity, tangent), -maxFriction, maxFriction);
+                float tangentChange = tangentImpulse - point.tangentImpulse;
+                point.tangentImpulse = tangentImpulse;
+                ApplyContactImpulse(Vector2Scale(tangent, tangentChange), point.offsetA, point.offsetB, inverseMasses[a], inverseInertias[a], inverseMasses[b], inverseInertias[b],
+                                           &velocities[a], &angularVelocities[a], &velocities[b], &angularVelocities[b]);
+
+                // Normal, the total can only ever push apart
+                if(contact.isBlockSolved)
+                {
+                    continue;
+                }
+                relativeVelocity = Vector2Subtract(Vector2Add(velocities[b], Cross(angularVelocities[b], point.offsetB)),
+                                                   Vector2Add(velocities[a], Cross(angularVelocities[a], point.offsetA)));
+                float normalSpeed = Vector2DotProduct(relativeVelocity, contact.normal);
+                float normalImpulse = std::max(point.normalImpulse - point.normalMass * (normalSpeed - point.velocityBias), 0.0f);
+                float normalChange = normalImpulse - point.normalImpulse;
+                point.normalImpulse = normalImpulse;
+                ApplyContactImpulse(Vector2Scale(contact.normal, normalChange), point.offsetA, point.offsetB, inverseMasses[a], inverseInertias[a], inverseMasses[b], inverseInertias[b],
+                                           &velocities[a], &angularVelocities[a], &velocities[b], &angularVelocities[b]);
+            }
+
+            if(contact.isBlockSolved)
+            {
+                SolveNormalBlock(contact);
+            }
+        }
+    }
+}
+
+void PhysicsWorld::SolveNormalBlock(Contact& contact)
+{
+    // Solving two points of a flat contact one after the other keeps tipping the body a little each
+    // way, which adds up to stacks leaning over. Instead find the pair of impulses that satisfies
+    // both at once, trying each combination of which points are pushing in turn
+    int a = contact.bodyA;
+    int b = contact.bodyB;
+    ContactPoint& point1 = contact.points[0];
+    ContactPoint& point2 = contact.points[1];
+    const float* k = contact.blockK;
+    const float* mass = contact.blockMass;
+
+    Vector2 relativeVelocity1 = Vector2Subtract(Vector2Add(velocities[b], Cross(angularVelocities[b], point1.offsetB)),
+                                                Vector2Add(velocities[a], Cross(angularVelocities[a], point1.offsetA)));
+    Vector2 relativeVelocity2 = Vector2Subtract(Vector2Add(velocities[b], Cross(angularVelocities[b], point2.offsetB)),
+                                                Vector2Add(velocities[a], Cross(angularVelocities[a], point2.offsetA)));
+    float old1 = point1.normalImpulse;
+    float old2 = point2.normalImpulse;
+    // Speeds the points would have with no impulse at all
+    float b1 = Vector2DotProduct(relativeVelocity1, contact.normal) - point1.velocityBias - (k[0] * old1 + k[1] * old2);
+    float b2 = Vector2DotProduct(relativeVelocity2, contact.normal) - point2.velocityBias - (k[1] * old1 + k[2] * old2);
+
+    float x1 = -(mass[0] * b1 + mass[1] * b2);     // Both pushing
+    float x2 = -(mass[1] * b1 + mass[2] * b2);
+    if(x1 < 0 || x2 < 0)
+    {
+        x1 = -point1.normalMass * b1;           // Only the first
+        x2 = 0;
+        if(x1 < 0 || k[1] * x1 + b2 < 0)
+        {
+            x1 = 0;                             // Only the second
+            x2 = -point2.normalMass * b2;
+            if(x2 < 0 || k[1] * x2 + b1 < 0)
+            {
+                x2 = 0;                         // Neither (separating)
+                if(b1 < 0 || b2 < 0)
+                {
+                    return;
+                }
+            }
+        }
+    }
+
+    point1.normalImpulse = x1;
+    point2.normalImpulse = x2;
+    ApplyContactImpulse(Vector2Scale(contact.normal, x1 - old1), point1.offsetA, point1.offsetB, inverseMasses[a], inverseInertias[a], inverseMasses[b], inverseInertias[b],
+                        &velocities[a], &angularVelocities[a], &velocities[b], &angularVelocities[b]);
+    ApplyContactImpulse(Vector2Scale(contact.normal, x2 - old2), point2.offsetA, point2.offsetB, inverseMasses[a], inverseInertias[a], inverseMasses[b], inverseInertias[b],
+                        &velocities[a], &angularVelocities[a], &velocities[b], &angularVelocities[b]);
+}
+
+void PhysicsWorld::CorrectPositions()
+{
+    // Velocities only stop things sinking further, so push whatever still overlaps apart directly,
+    // rotating the bodies as well so a box resting on one corner doesn't get lifted flat. Both
+    // points of a contact are measured before either is pushed, otherwise whichever went first
+    // would keep tipping the body the same way
+    for(int iteration = 0; iteration < POSITION_ITERATIONS; iteration++)
+    {
+        for(Contact& contact : contacts)
+        {
+            int a = contact.bodyA;
+            int b = contact.bodyB;
+            Vector2 normal = Vector2Rotate(contact.localNormal, angles[a]);
+
+            Vector2 anchorsA[2];
+            Vector2 anchorsB[2];
+            float corrections[2];
+            for(int i = 0; i < contact.pointCount; i++)
+            {
+                anchorsA[i] = Vector2Rotate(contact.points[i].localAnchorA, angles[a]);
+                anchorsB[i] = Vector2Rotate(contact.points[i].localAnchorB, angles[b]);
+                float separation = Vector2DotProduct(Vector2Subtract(Vector2Add(positions[b], anchorsB[i]), Vector2Add(positions[a], anchorsA[i])), normal);
+                corrections[i] = std::clamp(POSITION_CORRECTION * (separation + LINEAR_SLOP), -MAX_POSITION_CORRECTION, 0.0f);
+            }
+
+            for(int i = 0; i < contact.pointCount; i++)
+            {
+                if(corrections[i] == 0)
+                {
+                    continue;
+                }
+                float normalA = Cross(anchorsA[i], normal);
+                float normalB = Cross(anchorsB[i], normal);
+                float mass = inverseMasses[a] + inverseMasses[b] + inverseInertias[a] * normalA * normalA + inverseInertias[b] * normalB * normalB;
+                // Split between the points, since they're all pushing at once
+                Vector2 impulse = Vector2Scale(normal, -corrections[i] / (mass * contact.pointCount));
+                positions[a] = Vector2Subtract(positions[a], Vector2Scale(impulse, inverseMasses[a]));
+                angles[a] -= inverseInertias[a] * Cross(anchorsA[i], impulse);
+                positions[b] = Vector2Add(positions[b], Vector2Scale(impulse, inverseMasses[b]));
+                angles[b] += inverseInertias[b] * Cross(anchorsB[i], impulse);
+            }
+        }
+    }
+}
+
+int PhysicsWorld::FindIsland(int index)
+{
+    while(islandParents[index] != index)
+    {
+        islandParents[index] = islandParents[islandParents[index]];
+        index = islandParents[index];
+    }
+    return index;
+}
+
+void PhysicsWorld::UpdateSleep(float deltaTime)
+{
+    size_t count = positions.size();
+    for(size_t i = 0; i < count; i++)
+    {
+        if(!isAwake[i] || types[i] != BODY_DYNAMIC)
+        {
+            continue;
+        }
+        // Judged by how far bodies have got from where they were, rather than their velocities, since
+        // bodies in a big pile keep trading small impulses back and forth without going anywhere
+        bool hasMoved = Vector2DistanceSqr(positions[i], sleepPositions[i]) > LINEAR_SLEEP_TOLERANCE * LINEAR_SLEEP_TOLERANCE ||
+                        fabsf(angles[i] - sleepAngles[i]) > ANGULAR_SLEEP_TOLERANCE;
+        if(sleepTimes[i] == 0 || hasMoved)
+        {
+            sleepPositions[i] = positions[i];
+            sleepAngles[i] = angles[i];
+            sleepTimes[i] = 0;
+        }
+        sleepTimes[i] += deltaTime;
+    }
+
+    // Islands are groups of dynamic bodies touching each other (static ground doesn't join them up),
+    // which can only fall asleep together
+    islandParents.resize(count);
+    for(size_t i = 0; i < count; i++)
+    {
+        islandParents[i] = i;
+    }
+    for(const Contact& contact : contacts)
+    {
+        int a = contact.bodyA;
+        int b = contact.bodyB;
+        if(types[a] == BODY_DYNAMIC && types[b] == BODY_DYNAMIC)
+        {
+            islandParents[FindIsland(a)] = FindIsland(b);
+        }
+        // A moving kinematic body keeps whatever it's pushing awake
+        else if(types[a] == BODY_KINEMATIC || types[b] == BODY_KINEMATIC)
+        {
+            int kinematic = types[a] == BODY_KINEMATIC ? a : b;
+            if(Vector2LengthSqr(velocities[kinematic]) > 0 || angularVelocities[kinematic] != 0)
+            {
+                sleepTimes[kinematic == a ? b : a] = 0;
+            }
+        }
+    }
+
+    islandSleepTimes.assign(count, INFINITY);
+    for(size_t i = 0; i < count; i++)
+    {
+        if(isAwake[i] && types[i] == BODY_DYNAMIC)
+        {
+            int island = FindIsland(i);
+            islandSleepTimes[island] = std::min(islandSleepTimes[island], sleepTimes[i]);
+        }
+    }
+    for(size_t i = 0; i < count; i++)
+    {
+        if(isAwake[i] && types[i] == BODY_DYNAMIC && islandSleepTimes[FindIsland(i)] >= TIME_TO_SLEEP)
+        {
+            isAwake[i] = false;
+            velocities[i] = {0, 0};
+            angularVelocities[i] = 0;
+        }
+    }
+}
+
+void PhysicsWorld::SyncNodes()
+{
+    for(size_t i = 0; i < positions.size(); i++)
+    {
+        if(nodes[i] == nullptr || !isAwake[i])
+        {
+            continue;
+        }
+        // The node sits at the polygon's origin, not its centroid
+        Vector2 origin = Vector2Subtract(positions[i], Vector2Rotate(polygons[bodyPolygons[i]].centroid, angles[i]));
+        nodes[i]->GetTransform()->SetPosition(origin);
+        nodes[i]->GetTransform()->SetRotation(angles[i]);
+    }
+}
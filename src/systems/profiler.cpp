@@ -0,0 +1,216 @@
+#include "../../include/astrocore/systems/profiler.h"
+#include "../../include/astrocore/systems/debug.h"
+#include <algorithm>
+#include <cstdio>
+
+using namespace Astrocore;
+
+ProfileRing* Profiler::RegisterThread()
+{
+    std::lock_guard<std::mutex> lock(ringsMutex);
+    rings.push_back(std::make_unique<ProfileRing>((uint32_t)rings.size()));
+    threadRing = rings.back().get();
+    return threadRing;
+}
+
+const char* Profiler::InternName(std::string_view name)
+{
+    std::lock_guard<std::mutex> lock(namesMutex);
+    for(const std::string& interned : internedNames)
+    {
+        if(interned == name)
+        {
+            return interned.c_str();
+        }
+    }
+    // Note: A deque never moves its elements, so the pointers stay valid
+    internedNames.emplace_back(name);
+    return internedNames.back().c_str();
+}
+
+size_t Profiler::GetZoneIndex(const char* name)
+{
+    // Keyed by the name's own characters, which outlive the profiler
+    std::unordered_map<std::string_view, size_t>::iterator found = zoneIndices.find(name);
+    if(found != zoneIndices.end())
+    {
+        return found->second;
+    }
+
+    ZoneStats stats;
+    stats.name = name;
+    stats.frameMs.resize(WINDOW_FRAMES, 0);
+    stats.frameCalls.resize(WINDOW_FRAMES, 0);
+    stats.firstFrame = frameCount;
+    zones.push_back(std::move(stats));
+    zoneIndices.emplace(name, zones.size() - 1);
+    return zones.size() - 1;
+}
+
+void Profiler::EndFrame()
+{
+    {
+        std::lock_guard<std::mutex> lock(ringsMutex);
+        for(std::unique_ptr<ProfileRing>& ring : rings)
+        {
+            uint64_t writeCount = ring->writeCount.load(std::memory_order_acquire);
+            uint64_t readCount = ring->readCount.load(std::memory_order_relaxed);
+
+            for(uint64_t i = readCount; i < writeCount; i++)
+            {
+                const ZoneEvent& event = ring->events[i & (ProfileRing::CAPACITY - 1)];
+                ZoneStats& stats = zones[GetZoneIndex(event.name)];
+                stats.currentMs += (event.endNs - event.startNs) / 1000000.0;
+                stats.currentCalls++;
+
+                if(isCapturing && event.startNs >= captureStartNs && capturedEvents.size() < MAX_CAPTURED_EVENTS)
+                {
+                    capturedEvents.push_back(event);
+                    capturedThreads.push_back(ring->threadID);
+                }
+            }
+            // Releases the slots back to the writer only now that they've been read
+            ring->readCount.store(writeCount, std::memory_order_release);
+
+            uint64_t dropped = ring->droppedCount.exchange(0, std::memory_order_relaxed);
+            if(dropped > 0)
+            {
+                DBG_WARN("Profiler dropped {} zones on thread {}, more than {} finished in a frame", dropped, ring->threadID, ProfileRing::CAPACITY);
+            }
+        }
+    }
+
+    size_t slot = frameCount % WINDOW_FRAMES;
+    for(ZoneStats& stats : zones)
+    {
+        stats.frameMs[slot] = stats.currentMs;
+        stats.frameCalls[slot] = stats.currentCalls;
+        stats.currentMs = 0;
+        stats.currentCalls = 0;
+    }
+    frameCount++;
+
+    if(summaryInterval > 0 && frameCount % summaryInterval == 0)
+    {
+        PrintSummary();
+    }
+}
+
+std::string Profiler::GetSummary()
+{
+    std::string summary;
+    char line[160];
+    snprintf(line, sizeof(line), "%-32s %8s %9s %9s %9s\n", "zone", "calls", "min ms", "avg ms", "p99 ms");
+    summary += line;
+
+    std::vector<double> samples;
+    for(ZoneStats& stats : zones)
+    {
+        // Only the frames since the zone first showed up
+        size_t sampleCount = std::min<uint64_t>(WINDOW_FRAMES, frameCount - stats.firstFrame);
+        if(sampleCount == 0)
+        {
+            continue;
+        }
+
+        samples.clear();
+        double total = 0;
+        uint64_t calls = 0;
+        for(size_t i = 0; i < sampleCount; i++)
+        {
+            size_t slot = (frameCount - 1 - i) % WINDOW_FRAMES;
+            samples.push_back(stats.frameMs[slot]);
+            total += stats.frameMs[slot];
+            calls += stats.frameCalls[slot];
+        }
+
+        size_t p99Index = std::min(sampleCount - 1, (size_t)(sampleCount * 0.99));
+        std::nth_element(samples.begin(), samples.begin() + p99Index, samples.end());
+        double p99 = samples[p99Index];
+        double min = *std::min_element(samples.begin(), samples.begin() + p99Index + 1);
+
+        snprintf(line, sizeof(line), "%-32.32s %8.1f %9.3f %9.3f %9.3f\n",
+                 stats.name.c_str(), (double)calls / sampleCount, min, total / sampleCount, p99);
+        summary += line;
+    }
+    return summary;
+}
+
+void Profiler::PrintSummary()
+{
+    std::string summary = GetSummary();
+    size_t lineStart = 0;
+    while(lineStart < summary.size())
+    {
+        size_t lineEnd = summary.find('\n', lineStart);
+        DBG_LOG(summary.substr(lineStart, lineEnd - lineStart));
+        lineStart = lineEnd + 1;
+    }
+}
+
+void Profiler::BeginCapture()
+{
+    capturedEvents.clear();
+    capturedThreads.clear();
+    captureStartNs = GetTimeNs();
+    isCapturing = true;
+}
+
+bool Profiler::EndCapture(std::string path)
+{
+    isCapturing = false;
+
+    FILE* file = fopen(path.c_str(), "w");
+    if(file == nullptr)
+    {
+        DBG_ERR("Couldn't open {} to write the profiler capture", path);
+        return false;
+    }
+
+    // Complete ("X") events, in microseconds. Nesting is worked out from the times
+    fprintf(file, "{\"displayTimeUnit\":\"ms\",\"traceEvents\":[\n");
+    for(size_t i = 0; i < capturedEvents.size(); i++)
+    {
+        const ZoneEvent& event = capturedEvents[i];
+        std::string name;
+        for(const char* c = event.name; *c != '\0'; c++)
+        {
+            if(*c == '"' || *c == '\\')
+            {
+                name += '\\';
+                name += *c;
+            }
+            else if((unsigned char)*c < 0x20)
+            {
+                // Control characters aren't allowed in JSON strings as they are
+                char escaped[8];
+                snprintf(escaped, sizeof(escaped), "\\u%04x", (unsigned)*c);
+                name += escaped;
+            }
+            else
+            {
+                name += *c;
+            }
+        }
+        fprintf(file, "{\"name\":\"%s\",\"ph\":\"X\",\"pid\":1,\"tid\":%u,\"ts\":%.3f,\"dur\":%.3f},\n",
+                name.c_str(), capturedThreads[i], (event.startNs - captureStartNs) / 1000.0, (event.endNs - event.startNs) / 1000.0);
+    }
+    {
+        std::lock_guard<std::mutex> lock(ringsMutex);
+        for(size_t i = 0; i < rings.size(); i++)
+        {
+            fprintf(file, "{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":1,\"tid\":%zu,\"args\":{\"name\":\"Thread %zu\"}}%s\n",
+                    i, i, i + 1 < rings.size() ? "," : "");
+        }
+    }
+    fprintf(file, "]}\n");
+
+    bool isWritten = !ferror(file);
+    fclose(file);
+
+    capturedEvents.clear();
+    capturedEvents.shrink_to_fit();
+    capturedThreads.clear();
+    capturedThreads.shrink_to_fit();
+    return isWritten;
+}
@@ -0,0 +1,119 @@
+#include "../../../include/astrocore/systems/rendering/nullrenderbackend.h"
+#include "../../../include/astrocore/systems/rendering/shapebatch.h"
+
+using namespace Astrocore;
+
+NullRenderBackend::NullRenderBackend(uint64_t frameLimit, float frameTime, int screenWidth, int screenHeight)
+{
+    this->frameLimit = frameLimit;
+    this->frameTime = frameTime;
+    this->screenWidth = screenWidth;
+    this->screenHeight = screenHeight;
+}
+
+Vector2 NullRenderBackend::GetTextureSize(RenderTextureID texture)
+{
+    return texture != NULL_RENDER_TEXTURE && (size_t)texture <= textureSizes.size() ? textureSizes[texture - 1] : Vector2{0, 0};
+}
+
+void NullRenderBackend::OpenWindow(int width, int height, std::string title)
+{
+    screenWidth = width;
+    screenHeight = height;
+    isClosed = false;
+}
+
+void NullRenderBackend::CloseWindow()
+{
+    isClosed = true;
+}
+
+bool NullRenderBackend::ShouldClose()
+{
+    return isClosed || (frameLimit > 0 && frameCount >= frameLimit);
+}
+
+bool NullRenderBackend::IsWindowResized()
+{
+    return false;
+}
+
+int NullRenderBackend::GetScreenWidth()
+{
+    return screenWidth;
+}
+
+int NullRenderBackend::GetScreenHeight()
+{
+    return screenHeight;
+}
+
+float NullRenderBackend::GetFrameTime()
+{
+    return frameTime;
+}
+
+void NullRenderBackend::BeginFrame()
+{
+    // Note: Keeps the capacity, so steady-state frames don't allocate
+    draws.clear();
+    currentTarget = NULL_RENDER_TEXTURE;
+}
+
+void NullRenderBackend::EndFrame()
+{
+    frameCount++;
+}
+
+RenderTextureID NullRenderBackend::CreateRenderTexture(int width, int height)
+{
+    if(!freeTextures.empty())
+    {
+        RenderTextureID id = freeTextures.back();
+        freeTextures.pop_back();
+        textureSizes[id - 1] = {(float)width, (float)height};
+        isTextureAlive[id - 1] = true;
+        return id;
+    }
+    textureSizes.push_back({(float)width, (float)height});
+    isTextureAlive.push_back(true);
+    return (RenderTextureID)textureSizes.size();
+}
+
+RenderTextureID NullRenderBackend::CreateTextureFromImage(const Image& image)
+{
+    return CreateRenderTexture(image.width, image.height);
+}
+
+void NullRenderBackend::DestroyRenderTexture(RenderTextureID texture)
+{
+    // Already destroyed IDs are ignored, freeing one again would hand it out twice
+    if(texture == NULL_RENDER_TEXTURE || (size_t)texture > textureSizes.size() || !isTextureAlive[texture - 1])
+    {
+        return;
+    }
+    textureSizes[texture - 1] = {0, 0};
+    isTextureAlive[texture - 1] = false;
+    freeTextures.push_back(texture);
+}
+
+void NullRenderBackend::BeginTexture(RenderTextureID texture, const Camera2D* camera, Color clearColor)
+{
+    currentTarget = texture;
+}
+
+void NullRenderBackend::EndTexture()
+{
+    currentTarget = NULL_RENDER_TEXTURE;
+}
+
+void NullRenderBackend::DrawTexture(RenderTextureID texture, Rectangle sourceRect, Rectangle destRect)
+{
+    draws.push_back({RecordedDraw::DRAW_TEXTURE, currentTarget, texture, 0, 0});
+}
+
+void NullRenderBackend::DrawVertices(const VertexStream& triangles, const VertexStream& lines)
+{
+    draws.push_back({RecordedDraw::DRAW_VERTICES, currentTarget, NULL_RENDER_TEXTURE, (uint32_t)triangles.Size(), (uint32_t)lines.Size()});
+    totalVertexCount += triangles.Size() + lines.Size();
+}
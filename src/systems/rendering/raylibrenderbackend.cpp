@@ -0,0 +1,184 @@
+#include "../../../include/astrocore/systems/rendering/raylibrenderbackend.h"
+#include "../../../include/astrocore/systems/rendering/shapebatch.h"
+#include <rlgl.h>
+#include <algorithm>
+
+using namespace Astrocore;
+
+// Vertices sent per rlBegin/rlEnd pair, a multiple of both 2 and 3 so primitives never get split
+static const size_t SUBMIT_CHUNK_SIZE = 6 * 512;
+
+RaylibRenderBackend::~RaylibRenderBackend()
+{
+    for(RenderTexture2D& texture : textures)
+    {
+        if(IsRenderTextureReady(texture))
+        {
+            UnloadRenderTexture(texture);
+        }
+        else if(texture.texture.id != 0)
+        {
+            UnloadTexture(texture.texture);
+        }
+    }
+}
+
+void RaylibRenderBackend::OpenWindow(int width, int height, std::string title)
+{
+    InitWindow(width, height, title.c_str());
+}
+
+void RaylibRenderBackend::CloseWindow()
+{
+    // Textures go with the GL context
+    for(RenderTexture2D& texture : textures)
+    {
+        if(IsRenderTextureReady(texture))
+        {
+            UnloadRenderTexture(texture);
+        }
+        texture = RenderTexture2D();
+    }
+    ::CloseWindow();
+}
+
+bool RaylibRenderBackend::ShouldClose()
+{
+    return WindowShouldClose();
+}
+
+bool RaylibRenderBackend::IsWindowResized()
+{
+    return ::IsWindowResized();
+}
+
+int RaylibRenderBackend::GetScreenWidth()
+{
+    return ::GetScreenWidth();
+}
+
+int RaylibRenderBackend::GetScreenHeight()
+{
+    return ::GetScreenHeight();
+}
+
+float RaylibRenderBackend::GetFrameTime()
+{
+    return ::GetFrameTime();
+}
+
+void RaylibRenderBackend::BeginFrame()
+{
+    BeginDrawing();
+}
+
+void RaylibRenderBackend::EndFrame()
+{
+    EndDrawing();
+}
+
+RenderTextureID RaylibRenderBackend::CreateRenderTexture(int width, int height)
+{
+    return AddTexture(LoadRenderTexture(width, height));
+}
+
+RenderTextureID RaylibRenderBackend::CreateTextureFromImage(const Image& image)
+{
+    // No framebuffer, just the color texture
+    RenderTexture2D texture = RenderTexture2D();
+    texture.texture = LoadTextureFromImage(image);
+    return AddTexture(texture);
+}
+
+RenderTextureID RaylibRenderBackend::AddTexture(const RenderTexture2D& texture)
+{
+    if(!freeTextures.empty())
+    {
+        RenderTextureID id = freeTextures.back();
+        freeTextures.pop_back();
+        textures[id - 1] = texture;
+        isTextureAlive[id - 1] = true;
+        return id;
+    }
+    textures.push_back(texture);
+    isTextureAlive.push_back(true);
+    return (RenderTextureID)textures.size();
+}
+
+void RaylibRenderBackend::DestroyRenderTexture(RenderTextureID texture)
+{
+    // Already destroyed IDs are ignored, freeing one again would hand it out twice
+    if(texture == NULL_RENDER_TEXTURE || (size_t)texture > textures.size() || !isTextureAlive[texture - 1])
+    {
+        return;
+    }
+    if(IsRenderTextureReady(textures[texture - 1]))
+    {
+        UnloadRenderTexture(textures[texture - 1]);
+    }
+    else if(textures[texture - 1].texture.id != 0)
+    {
+        UnloadTexture(textures[texture - 1].texture);
+    }
+    textures[texture - 1] = RenderTexture2D();
+    isTextureAlive[texture - 1] = false;
+    freeTextures.push_back(texture);
+}
+
+void RaylibRenderBackend::BeginTexture(RenderTextureID texture, const Camera2D* camera, Color clearColor)
+{
+    BeginTextureMode(textures[texture - 1]);
+    isInCameraMode = camera != nullptr;
+    if(isInCameraMode)
+    {
+        BeginMode2D(*camera);
+    }
+    ClearBackground(clearColor);
+}
+
+void RaylibRenderBackend::EndTexture()
+{
+    if(isInCameraMode)
+    {
+        EndMode2D();
+        isInCameraMode = false;
+    }
+    EndTextureMode();
+}
+
+void RaylibRenderBackend::DrawTexture(RenderTextureID texture, Rectangle sourceRect, Rectangle destRect)
+{
+    DrawTexturePro(textures[texture - 1].texture, sourceRect, destRect, {0, 0}, 0, WHITE);
+}
+
+void RaylibRenderBackend::SubmitVertices(const VertexStream& vertices, int primitiveMode)
+{
+    for(size_t start = 0; start < vertices.Size(); start += SUBMIT_CHUNK_SIZE)
+    {
+        size_t end = std::min(start + SUBMIT_CHUNK_SIZE, vertices.Size());
+
+        // Lets rlgl flush its internal buffer up front instead of mid-primitive
+        rlCheckRenderBatchLimit(end - start);
+        rlBegin(primitiveMode);
+        for(size_t i = start; i < end; i++)
+        {
+            const Color& color = vertices.colors[i];
+            rlColor4ub(color.r, color.g, color.b, color.a);
+            rlVertex2f(vertices.positions[i].x, vertices.positions[i].y);
+        }
+        rlEnd();
+    }
+}
+
+void RaylibRenderBackend::DrawVertices(const VertexStream& triangles, const VertexStream& lines)
+{
+    // Winding isn't consistent between fills and line quads, so don't cull either
+    rlDrawRenderBatchActive();
+    rlDisableBackfaceCulling();
+
+    SubmitVertices(triangles, RL_TRIANGLES);
+    SubmitVertices(lines, RL_LINES);
+
+    rlDrawRenderBatchActive();
+    rlEnableBackfaceCulling();
+}
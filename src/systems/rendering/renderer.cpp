@@ -1,9 +1,12 @@
 #include "../../../include/astrocore/systems/rendering/renderer.h"
+#include "../../../include/astrocore/systems/rendering/raylibrenderbackend.h"
 
 using namespace Astrocore;
 
-Renderer::Renderer()
+Renderer::Renderer(RenderBackend* backend)
 {
+    SetBackend(backend);
+
     //SetFinalTargetDimensions(GetScreenWidth(), GetScreenHeight());
     renderTargets = std::map<std::string, RenderTarget*>();
 
@@ -12,17 +15,27 @@ Renderer::Renderer()
     renderTargets.emplace("basic", basicTarget);
 }
 
+void Renderer::SetBackend(RenderBackend* newBackend)
+{
+    if(RenderBackend::GetCurrent() == backend.get())
+    {
+        RenderBackend::SetCurrent(nullptr);
+    }
+    backend.reset(newBackend != nullptr ? newBackend : new RaylibRenderBackend());
+    RenderBackend::SetCurrent(backend.get());
+}
+
 void Renderer::SetFinalTargetDimensions(float width, float height)
 {
-    if(IsRenderTextureReady(finalRenderTexture))
+    if(finalRenderTexture != NULL_RENDER_TEXTURE)
     {
-        UnloadRenderTexture(finalRenderTexture);
+        backend->DestroyRenderTexture(finalRenderTexture);
     }
 
     targetRenderResolution = {width, height};
 
-    this->finalRenderTexture = LoadRenderTexture(width, height);
-    virtualScreenWidth = GetScreenWidth()/width;
+    this->finalRenderTexture = backend->CreateRenderTexture(width, height);
+    virtualScreenWidth = backend->GetScreenWidth()/width;
 
     if(basicTarget != nullptr)
     {
@@ -32,7 +45,7 @@ void Renderer::SetFinalTargetDimensions(float width, float height)
     }
     
     srcRect = {0,0, width, -height};
-    destRect = {0,0,(float)GetScreenWidth(), (float)GetScreenHeight()};
+    destRect = {0,0,(float)backend->GetScreenWidth(), (float)backend->GetScreenHeight()};
 }
 
 void Renderer::AddRenderTarget(std::string name, RenderTarget* target)
@@ -47,9 +60,13 @@ RenderTarget* Renderer::GetRenderTarget(std::string name)
 
 Renderer::~Renderer()
 {
-    if(IsRenderTextureReady(finalRenderTexture))
+    if(finalRenderTexture != NULL_RENDER_TEXTURE)
+    {
+        backend->DestroyRenderTexture(finalRenderTexture);
+    }
+    if(RenderBackend::GetCurrent() == backend.get())
     {
-        UnloadRenderTexture(finalRenderTexture);
+        RenderBackend::SetCurrent(nullptr);
     }
 }
 
@@ -59,34 +76,39 @@ void Renderer::SetClearColor(Color newColor)
 }
     
 
-void Renderer::Render(std::vector<std::weak_ptr<TreeNode>>* nodesToDraw)
+void Renderer::Render(SceneTree* tree)
 {
     // Recalculate the render sizes
-    if(IsWindowResized())
+    if(backend->IsWindowResized())
     {
         SetFinalTargetDimensions(targetRenderResolution.x,targetRenderResolution.y );
     }
 
-    BeginDrawing();
+    backend->BeginFrame();
     
     // Render each of the targets
     std::map<std::string, RenderTarget*>::iterator it;
 
     for(it = renderTargets.begin(); it != renderTargets.end(); it++)
     {
-        it->second->DrawToTarget(nodesToDraw);
+        DBG_PROFILE_ZONE(it->second->GetProfileZoneName());
+        it->second->DrawToTarget(tree);
     }
 
     // Render each of the targets to the final render texture
-    BeginTextureMode(finalRenderTexture);
-    ClearBackground(clearColor);
+    DBG_PROFILE_ZONE("Composite");
+    backend->BeginTexture(finalRenderTexture, nullptr, clearColor);
     for(it = renderTargets.begin(); it != renderTargets.end(); it++)
     {
         it->second->DrawToFinal();
     }
-    EndTextureMode(); // finalRenderTarget
+    backend->EndTexture(); // finalRenderTarget
 
     // Render the final texture to the screen
-    DrawTexturePro(finalRenderTexture.texture, srcRect, destRect, {0,0}, 0, WHITE);
-    EndDrawing();
+    backend->DrawTexture(finalRenderTexture, srcRect, destRect);
+    {
+        // Includes waiting on vsync
+        DBG_PROFILE_ZONE("Present");
+        backend->EndFrame();
+    }
 }
\ No newline at end of file
@@ -0,0 +1,130 @@
+#include "../../../include/astrocore/systems/rendering/renderqueue.h"
+#include <algorithm>
+#include <cstring>
+#include <iterator>
+
+using namespace Astrocore;
+
+void RenderQueue::Begin()
+{
+    previousCount = items.size();
+    items.clear();
+    frame++;
+}
+
+void RenderQueue::Add(TreeNode* node)
+{
+    Add(node, MakeKey(node->GetRenderLayer(), node->GetZIndex(), node->GetMaterialKey()));
+}
+
+void RenderQueue::Add(TreeNode* node, uint64_t key)
+{
+    items.push_back({key, node});
+}
+
+void RenderQueue::Sort()
+{
+    // Drop every item that was drawn last frame with the same key back into its old position
+    byPreviousRank.assign(previousCount, {0, nullptr});
+    changed.clear();
+    for(const RenderItem& item : items)
+    {
+        NodeHandle handle = item.node->treeHandle;
+        const Placement* placement = handle.index < placements.size() ? &placements[handle.index] : nullptr;
+        bool canReuse = placement != nullptr && placement->generation == handle.generation &&
+                        placement->frame == frame - 1 && placement->key == item.key &&
+                        placement->rank < previousCount && byPreviousRank[placement->rank].node == nullptr;
+        if(canReuse)
+        {
+            byPreviousRank[placement->rank] = item;
+        }
+        else
+        {
+            changed.push_back(item);
+        }
+    }
+
+    // Last frame's order was sorted, so any subset of it still is
+    retained.clear();
+    for(const RenderItem& item : byPreviousRank)
+    {
+        if(item.node != nullptr)
+        {
+            retained.push_back(item);
+        }
+    }
+
+    resortedCount = changed.size();
+    RadixSort(changed, radixScratch);
+
+    // Merge the two sorted runs (retained items win ties, so they don't shuffle around)
+    items.clear();
+    std::merge(retained.begin(), retained.end(), changed.begin(), changed.end(), std::back_inserter(items),
+               [](const RenderItem& a, const RenderItem& b) { return a.key < b.key; });
+
+    for(size_t i = 0; i < items.size(); i++)
+    {
+        NodeHandle handle = items[i].node->treeHandle;
+        if(handle == NULL_NODE_HANDLE)
+        {
+            continue;
+        }
+        if(handle.index >= placements.size())
+        {
+            placements.resize(handle.index + 1);
+        }
+        placements[handle.index] = {handle.generation, frame, (uint32_t)i, items[i].key};
+    }
+}
+
+void RenderQueue::RadixSort(std::vector<RenderItem>& items, std::vector<RenderItem>& scratch)
+{
+    size_t count = items.size();
+    if(count < 2)
+    {
+        return;
+    }
+
+    // Build the histogram of every byte in a single pass
+    size_t histograms[8][256];
+    memset(histograms, 0, sizeof(histograms));
+    for(const RenderItem& item : items)
+    {
+        for(int byte = 0; byte < 8; byte++)
+        {
+            histograms[byte][(item.key >> (byte * 8)) & 0xFF]++;
+        }
+    }
+
+    scratch.resize(count);
+    std::vector<RenderItem>* source = &items;
+    std::vector<RenderItem>* destination = &scratch;
+    for(int byte = 0; byte < 8; byte++)
+    {
+        size_t* histogram = histograms[byte];
+
+        // Every item has the same value for this byte, the pass wouldn't change anything
+        if(histogram[((*source)[0].key >> (byte * 8)) & 0xFF] == count)
+        {
+            continue;
+        }
+
+        size_t offset = 0;
+        for(int bucket = 0; bucket < 256; bucket++)
+        {
+            size_t bucketCount = histogram[bucket];
+            histogram[bucket] = offset;
+            offset += bucketCount;
+        }
+        for(const RenderItem& item : *source)
+        {
+            (*destination)[histogram[(item.key >> (byte * 8)) & 0xFF]++] = item;
+        }
+        std::swap(source, destination);
+    }
+
+    if(source != &items)
+    {
+        items.swap(scratch);
+    }
+}
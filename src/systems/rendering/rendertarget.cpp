@@ -1,19 +1,26 @@
 #include "../../../include/astrocore/systems/rendering/rendertarget.h"
+#include <algorithm>
 using namespace Astrocore;
 
 RenderTarget::RenderTarget(std::string name)
 {
     this->name = name;
+#ifdef ASTROCORE_PROFILING
+    profileZoneName = Profiler::InternName("RenderTarget " + name);
+#endif
 }
 
 void RenderTarget::SetRenderTargetDimensions(float width, float height)
 {
-    if(IsRenderTextureReady(renderTarget))
+    RenderBackend* backend = RenderBackend::GetCurrent();
+    if(renderTarget != NULL_RENDER_TEXTURE)
     {
-        UnloadRenderTexture(renderTarget);
+        backend->DestroyRenderTexture(renderTarget);
     }
     // TODO: This should update the destination rect
-    renderTarget = LoadRenderTexture(width, height);
+    renderTarget = backend->CreateRenderTexture(width, height);
+    this->width = width;
+    this->height = height;
 }
 
 void RenderTarget::SetSourceRect(Rectangle src)
@@ -40,32 +47,70 @@ Rectangle RenderTarget::GetSourceRect()
     return sourceRect;
 }
 
-void RenderTarget::DrawToTarget(std::vector<std::weak_ptr<TreeNode>>* nodesToDraw)
+Rectangle RenderTarget::GetCameraViewRect()
+{
+    // Un-project the corners of the target (handles camera zoom and rotation)
+    Vector2 corners[4] = {
+        GetScreenToWorld2D({0, 0}, *renderCamera),
+        GetScreenToWorld2D({width, 0}, *renderCamera),
+        GetScreenToWorld2D({0, height}, *renderCamera),
+        GetScreenToWorld2D({width, height}, *renderCamera)};
+
+    Vector2 min = corners[0];
+    Vector2 max = corners[0];
+    for(int i = 1; i < 4; i++)
+    {
+        min = {std::min(min.x, corners[i].x), std::min(min.y, corners[i].y)};
+        max = {std::max(max.x, corners[i].x), std::max(max.y, corners[i].y)};
+    }
+    return {min.x, min.y, max.x - min.x, max.y - min.y};
+}
+
+void RenderTarget::DrawToTarget(SceneTree* tree)
 {
     if(renderCamera == nullptr)
     {
-        DBG_WARN("No active camera was found for render target " + this->name + ". Creating a default one...");
+        DBG_WARN("No active camera was found for render target {}. Creating a default one...", name);
         renderCamera = std::shared_ptr<Camera2D>(new Camera2D());
         renderCamera.get()->offset = {destRect.width/2.0f, destRect.height/2.0f};
         renderCamera.get()->zoom = 1.0f;
     }
    
-    BeginTextureMode(renderTarget);
-    BeginMode2D(*renderCamera);
-    ClearBackground(BLANK);
+    RenderBackend::GetCurrent()->BeginTexture(renderTarget, renderCamera.get(), BLANK);
 
-    // Do drawing of each node
-    for(int i = 0; i < nodesToDraw->size();i++)
+    // Only visit what the camera can actually see, on the layers this target draws
+    visibleNodes.clear();
+    tree->QueryVisible(GetCameraViewRect(), &visibleNodes, cullMask);
+
+    // Sort into (render layer, z index, material) order
+    renderQueue.Begin();
+    for(TreeNode* node : visibleNodes)
     {
-        std::shared_ptr<TreeNode> node = nodesToDraw->at(i).lock();
         if(node->IsDrawn())
         {
-            node->Draw();
+            renderQueue.Add(node);
         }
     }
-    
-    EndMode2D();
-    EndTextureMode();
+    renderQueue.Sort();
+
+    // Do drawing of each node
+    // Shapes get collected into the batch, which is submitted whenever the key changes
+    // so anything drawn after it still ends up on top
+    shapeBatch.Clear();
+    ShapeBatch::SetActive(&shapeBatch);
+    const std::vector<RenderItem>& items = renderQueue.GetItems();
+    for(size_t i = 0; i < items.size(); i++)
+    {
+        if(i > 0 && items[i].key != items[i - 1].key)
+        {
+            shapeBatch.Flush();
+        }
+        items[i].node->Draw();
+    }
+    shapeBatch.Flush();
+    ShapeBatch::SetActive(nullptr);
+
+    RenderBackend::GetCurrent()->EndTexture();
 }
 
 void RenderTarget::SetActiveCamera(std::shared_ptr<Camera2D> cam)
@@ -75,5 +120,5 @@ void RenderTarget::SetActiveCamera(std::shared_ptr<Camera2D> cam)
 
 void RenderTarget::DrawToFinal()
 {   
-    DrawTexturePro(renderTarget.texture, sourceRect, destRect, {0, 0}, 0, WHITE);
+    RenderBackend::GetCurrent()->DrawTexture(renderTarget, sourceRect, destRect);
 }
\ No newline at end of file
@@ -0,0 +1,201 @@
+#include "../../../include/astrocore/systems/rendering/shapebatch.h"
+#include "../../../include/astrocore/systems/rendering/renderbackend.h"
+#include <raymath.h>
+#include <algorithm>
+
+using namespace Astrocore;
+
+void VertexStream::Append(const std::vector<Vector2>& localPoints, const Affine2D& transform, Color color)
+{
+    size_t count = localPoints.size();
+    if(count == 0)
+    {
+        return;
+    }
+    size_t start = positions.size();
+    positions.resize(start + count);
+    transform.ApplyToPoints(localPoints.data(), positions.data() + start, count);
+    colors.resize(start + count, color);
+}
+
+void ShapeBatch::Clear()
+{
+    // Note: Keeps the capacity, so steady-state frames don't allocate
+    triangles.Clear();
+    lines.Clear();
+}
+
+void ShapeBatch::AddTriangle(Vector2 a, Vector2 b, Vector2 c, Color color)
+{
+    triangles.Push(a, color);
+    triangles.Push(b, color);
+    triangles.Push(c, color);
+}
+
+void ShapeBatch::AddLine(Vector2 start, Vector2 end, float thickness, Color color)
+{
+    if(thickness <= 1.0f)
+    {
+        lines.Push(start, color);
+        lines.Push(end, color);
+        return;
+    }
+
+    ExpandLine(start, end, thickness, &triangles.positions);
+    triangles.colors.resize(triangles.positions.size(), color);
+}
+
+void ShapeBatch::AddShape(const Shape& shape, const Affine2D& transform)
+{
+    // Only the world transform is applied per frame, the tessellation itself is cached on the shape
+    shape.UpdateTessellation();
+    triangles.Append(shape.localTriangles, transform, shape.color);
+    lines.Append(shape.localLines, transform, shape.color);
+}
+
+void ShapeBatch::Flush()
+{
+    if(triangles.Size() == 0 && lines.Size() == 0)
+    {
+        return;
+    }
+
+    RenderBackend::GetCurrent()->DrawVertices(triangles, lines);
+    Clear();
+}
+
+void ShapeBatch::FlushActive()
+{
+    if(activeBatch != nullptr)
+    {
+        activeBatch->Flush();
+    }
+}
+
+// Twice the signed area of the triangle (o, a, b), positive when counter clockwise
+static inline float Cross(Vector2 o, Vector2 a, Vector2 b)
+{
+    return (a.x - o.x) * (b.y - o.y) - (a.y - o.y) * (b.x - o.x);
+}
+
+// Expects (a, b, c) to be counter clockwise, points on an edge count as inside
+static inline bool IsPointInTriangle(Vector2 p, Vector2 a, Vector2 b, Vector2 c)
+{
+    return Cross(a, b, p) >= 0 && Cross(b, c, p) >= 0 && Cross(c, a, p) >= 0;
+}
+
+static inline bool PointsEqual(Vector2 a, Vector2 b)
+{
+    return a.x == b.x && a.y == b.y;
+}
+
+void ShapeBatch::TriangulatePolygon(const std::vector<Vector2>& points, std::vector<Vector2>* outTriangles)
+{
+    size_t count = points.size();
+    if(count < 3)
+    {
+        return;
+    }
+
+    // Walk the points counter clockwise, whatever order they were given in
+    float doubleArea = 0;
+    for(size_t i = 0; i < count; i++)
+    {
+        const Vector2& current = points[i];
+        const Vector2& next = points[(i + 1) % count];
+        doubleArea += current.x * next.y - next.x * current.y;
+    }
+    std::vector<size_t> remaining(count);
+    for(size_t i = 0; i < count; i++)
+    {
+        remaining[i] = doubleArea >= 0 ? i : count - 1 - i;
+    }
+
+    outTriangles->reserve(outTriangles->size() + (count - 2) * 3);
+
+    size_t current = 0;
+    size_t failedAttempts = 0;
+    while(remaining.size() > 3)
+    {
+        size_t remainingCount = remaining.size();
+        size_t previous = (current + remainingCount - 1) % remainingCount;
+        size_t next = (current + 1) % remainingCount;
+        Vector2 a = points[remaining[previous]];
+        Vector2 b = points[remaining[current]];
+        Vector2 c = points[remaining[next]];
+
+        // An ear is a convex corner with no other point inside it
+        bool isEar = Cross(a, b, c) > 0;
+        for(size_t j = 0; isEar && j < remainingCount; j++)
+        {
+            if(j == previous || j == current || j == next)
+            {
+                continue;
+            }
+            Vector2 p = points[remaining[j]];
+            if(PointsEqual(p, a) || PointsEqual(p, b) || PointsEqual(p, c))
+            {
+                continue;
+            }
+            isEar = !IsPointInTriangle(p, a, b, c);
+        }
+
+        if(isEar)
+        {
+            outTriangles->push_back(a);
+            outTriangles->push_back(b);
+            outTriangles->push_back(c);
+            remaining.erase(remaining.begin() + current);
+            if(current >= remaining.size())
+            {
+                current = 0;
+            }
+            failedAttempts = 0;
+        }
+        else
+        {
+            current = next;
+            failedAttempts++;
+
+            // Went all the way around without an ear: the polygon is self-intersecting
+            // (or fully degenerate), so give up and fan whatever is left
+            if(failedAttempts >= remainingCount)
+            {
+                break;
+            }
+        }
+    }
+
+    for(size_t i = 1; i + 1 < remaining.size(); i++)
+    {
+        outTriangles->push_back(points[remaining[0]]);
+        outTriangles->push_back(points[remaining[i]]);
+        outTriangles->push_back(points[remaining[i + 1]]);
+    }
+}
+
+void ShapeBatch::ExpandLine(Vector2 start, Vector2 end, float thickness, std::vector<Vector2>* outTriangles)
+{
+    Vector2 delta = Vector2Subtract(end, start);
+    float length = Vector2Length(delta);
+    if(length <= 0)
+    {
+        return;
+    }
+
+    // Offset both ends by half the thickness along the line's normal
+    float halfScale = thickness / (2.0f * length);
+    Vector2 offset = {-delta.y * halfScale, delta.x * halfScale};
+
+    Vector2 startLeft = Vector2Add(start, offset);
+    Vector2 startRight = Vector2Subtract(start, offset);
+    Vector2 endLeft = Vector2Add(end, offset);
+    Vector2 endRight = Vector2Subtract(end, offset);
+
+    outTriangles->push_back(startLeft);
+    outTriangles->push_back(startRight);
+    outTriangles->push_back(endRight);
+    outTriangles->push_back(startLeft);
+    outTriangles->push_back(endRight);
+    outTriangles->push_back(endLeft);
+}
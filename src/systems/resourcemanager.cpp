@@ -0,0 +1,510 @@
+#include "../../include/astrocore/systems/resourcemanager.h"
+#include "../../include/astrocore/systems/debug.h"
+#include <chrono>
+
+using namespace Astrocore;
+
+// Handles
+
+ResourceHandle::ResourceHandle(ResourceManager* manager, uint32_t slot)
+{
+    this->manager = manager;
+    this->slot = slot;
+    manager->AddRef(slot);
+}
+
+ResourceHandle::ResourceHandle(const ResourceHandle& other) : manager(other.manager), slot(other.slot)
+{
+    if(manager != nullptr)
+    {
+        manager->AddRef(slot);
+    }
+}
+
+ResourceHandle::ResourceHandle(ResourceHandle&& other) : manager(other.manager), slot(other.slot)
+{
+    other.manager = nullptr;
+    other.slot = UINT32_MAX;
+}
+
+ResourceHandle& ResourceHandle::operator=(const ResourceHandle& other)
+{
+    if(this != &other)
+    {
+        // Take the new reference first, in case both refer to the same resource
+        if(other.manager != nullptr)
+        {
+            other.manager->AddRef(other.slot);
+        }
+        Reset();
+        manager = other.manager;
+        slot = other.slot;
+    }
+    return *this;
+}
+
+ResourceHandle& ResourceHandle::operator=(ResourceHandle&& other)
+{
+    if(this != &other)
+    {
+        Reset();
+        manager = other.manager;
+        slot = other.slot;
+        other.manager = nullptr;
+        other.slot = UINT32_MAX;
+    }
+    return *this;
+}
+
+ResourceHandle::~ResourceHandle()
+{
+    Reset();
+}
+
+void ResourceHandle::Reset()
+{
+    if(manager != nullptr)
+    {
+        manager->Release(slot);
+    }
+    manager = nullptr;
+    slot = UINT32_MAX;
+}
+
+RESOURCE_STATE ResourceHandle::GetState() const
+{
+    return IsValid() ? manager->resources[slot].state : RESOURCE_FAILED;
+}
+
+const std::string& ResourceHandle::GetPath() const
+{
+    static const std::string noPath;
+    return IsValid() ? manager->resources[slot].path : noPath;
+}
+
+RenderTextureID ResourceHandle::GetTexture() const
+{
+    return IsReady() ? manager->resources[slot].texture : NULL_RENDER_TEXTURE;
+}
+
+int ResourceHandle::GetWidth() const
+{
+    return IsValid() ? manager->resources[slot].width : 0;
+}
+
+int ResourceHandle::GetHeight() const
+{
+    return IsValid() ? manager->resources[slot].height : 0;
+}
+
+const Wave* ResourceHandle::GetWave() const
+{
+    return IsReady() && manager->resources[slot].type == RESOURCE_AUDIO ? &manager->resources[slot].wave : nullptr;
+}
+
+const unsigned char* ResourceHandle::GetData() const
+{
+    return IsReady() ? manager->resources[slot].data : nullptr;
+}
+
+size_t ResourceHandle::GetDataSize() const
+{
+    return IsReady() ? manager->resources[slot].dataSize : 0;
+}
+
+// Manager
+
+ResourceManager::~ResourceManager()
+{
+    Shutdown();
+}
+
+void ResourceManager::Start(int loaderCount)
+{
+    if(!loaders.empty())
+    {
+        return;
+    }
+    isStopping = false;
+    for(int i = 0; i < loaderCount; i++)
+    {
+        loaders.emplace_back(&ResourceManager::LoaderLoop, this);
+    }
+}
+
+void ResourceManager::Stop()
+{
+    if(loaders.empty())
+    {
+        return;
+    }
+    {
+        std::lock_guard<std::mutex> lock(requestMutex);
+        isStopping = true;
+    }
+    requestCondition.notify_all();
+    for(std::thread& loader : loaders)
+    {
+        loader.join();
+    }
+    loaders.clear();
+}
+
+void ResourceManager::Shutdown()
+{
+    Stop();
+
+    // Whatever didn't get loaded won't be now
+    for(const LoadRequest& request : requests)
+    {
+        resources[request.slot].state = RESOURCE_FAILED;
+        loadingCount--;
+    }
+    requests.clear();
+    for(LoadResult& result : results)
+    {
+        resources[result.slot].state = RESOURCE_FAILED;
+        loadingCount--;
+        FreeResult(result);
+    }
+    results.clear();
+    pendingUploads.clear();
+
+    for(uint32_t slot = 0; slot < resources.size(); slot++)
+    {
+        Resource& resource = resources[slot];
+        if(resource.isInUse)
+        {
+            FreeData(resource);
+            resource.state = RESOURCE_FAILED;
+        }
+    }
+}
+
+void ResourceManager::LoaderLoop()
+{
+    while(true)
+    {
+        LoadRequest request;
+        {
+            std::unique_lock<std::mutex> lock(requestMutex);
+            requestCondition.wait(lock, [this]() { return isStopping || !requests.empty(); });
+            if(isStopping)
+            {
+                // Note: Anything still queued is left for Update() (or the loaders from the next Start())
+                return;
+            }
+            request = std::move(requests.front());
+            requests.pop_front();
+        }
+
+        LoadResult result = Decode(request);
+        std::lock_guard<std::mutex> lock(resultMutex);
+        results.push_back(result);
+    }
+}
+
+ResourceManager::LoadResult ResourceManager::Decode(const LoadRequest& request)
+{
+    LoadResult result = {request.slot, false, Image(), Wave(), nullptr, 0};
+    // Paths in the mounted pack are read from it, anything else from disk
+    const PackFile* pack = request.pack != nullptr && request.pack->Contains(request.path) ? request.pack : nullptr;
+    switch(request.type)
+    {
+    case RESOURCE_TEXTURE:
+        result.image = pack != nullptr ? pack->LoadImage(request.path) : LoadImage(request.path.c_str());
+        result.isLoaded = result.image.data != nullptr;
+        break;
+    case RESOURCE_AUDIO:
+        result.wave = pack != nullptr ? pack->LoadWave(request.path) : LoadWave(request.path.c_str());
+        result.isLoaded = result.wave.data != nullptr;
+        break;
+    case RESOURCE_DATA:
+    {
+        int dataSize = 0;
+        result.data = pack != nullptr ? pack->LoadFileData(request.path, &dataSize) : LoadFileData(request.path.c_str(), &dataSize);
+        result.dataSize = dataSize;
+        result.isLoaded = result.data != nullptr;
+        break;
+    }
+    }
+    return result;
+}
+
+ResourceHandle ResourceManager::Load(const std::string& path, RESOURCE_TYPE type)
+{
+    auto existing = slotsByPath.find(path);
+    if(existing != slotsByPath.end())
+    {
+        Resource& resource = resources[existing->second];
+        if(resource.type != type)
+        {
+            DBG_WARN("{} is already loaded as a different type of resource", path);
+            return ResourceHandle();
+        }
+        if(resource.state != RESOURCE_FAILED)
+        {
+            return ResourceHandle(this, existing->second);
+        }
+        // Failed last time, but the file might be there now
+        FreeData(resource);
+        resource.state = RESOURCE_LOADING;
+        ResourceHandle handle(this, existing->second);
+        loadingCount++;
+        {
+            std::lock_guard<std::mutex> lock(requestMutex);
+            requests.push_back({existing->second, type, path, pack});
+        }
+        requestCondition.notify_one();
+        return handle;
+    }
+
+    uint32_t slot;
+    if(!freeSlots.empty())
+    {
+        slot = freeSlots.back();
+        freeSlots.pop_back();
+    }
+    else
+    {
+        slot = resources.size();
+        resources.push_back(Resource());
+    }
+    Resource& resource = resources[slot];
+    resource = Resource();
+    resource.path = path;
+    resource.type = type;
+    resource.isInUse = true;
+    slotsByPath[path] = slot;
+
+    ResourceHandle handle(this, slot);
+    loadingCount++;
+    {
+        std::lock_guard<std::mutex> lock(requestMutex);
+        requests.push_back({slot, type, path, pack});
+    }
+    requestCondition.notify_one();
+    return handle;
+}
+
+void ResourceManager::Update()
+{
+    std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+    auto isOverBudget = [&]()
+    {
+        return std::chrono::duration<float, std::milli>(std::chrono::steady_clock::now() - start).count() >= uploadBudgetMs;
+    };
+
+    // Swapped out, so the loaders aren't kept waiting on the lock while these are handled
+    {
+        std::lock_guard<std::mutex> lock(resultMutex);
+        completedScratch.swap(results);
+    }
+    for(LoadResult& result : completedScratch)
+    {
+        Complete(result);
+    }
+    completedScratch.clear();
+
+    // With no loader threads, loading shares the upload budget (one file always gets through)
+    bool isFirst = true;
+    while(loaders.empty() && !requests.empty() && (isFirst || !isOverBudget()))
+    {
+        LoadRequest request = std::move(requests.front());
+        requests.pop_front();
+        LoadResult result = Decode(request);
+        Complete(result);
+        isFirst = false;
+    }
+
+    if(RenderBackend::GetCurrent() != nullptr)
+    {
+        isFirst = true;
+        while(!pendingUploads.empty() && (isFirst || !isOverBudget()))
+        {
+            Upload(pendingUploads.front());
+            pendingUploads.pop_front();
+            isFirst = false;
+        }
+    }
+
+    EvictToBudget();
+}
+
+void ResourceManager::Complete(LoadResult& result)
+{
+    Resource& resource = resources[result.slot];
+    loadingCount--;
+    if(!result.isLoaded)
+    {
+        resource.state = RESOURCE_FAILED;
+        DBG_WARN("Couldn't load {}", resource.path);
+        FreeResult(result);
+    }
+    else if(resource.type == RESOURCE_TEXTURE)
+    {
+        resource.pendingImage = result.image;
+        resource.width = result.image.width;
+        resource.height = result.image.height;
+        resource.memorySize = GetPixelDataSize(result.image.width, result.image.height, result.image.format);
+        resource.state = RESOURCE_UPLOADING;
+        pendingUploads.push_back(result.slot);
+    }
+    else if(resource.type == RESOURCE_AUDIO)
+    {
+        resource.wave = result.wave;
+        resource.memorySize = (size_t)result.wave.frameCount * result.wave.channels * result.wave.sampleSize / 8;
+        resource.state = RESOURCE_READY;
+    }
+    else
+    {
+        resource.data = result.data;
+        resource.dataSize = result.dataSize;
+        resource.memorySize = result.dataSize;
+        resource.state = RESOURCE_READY;
+    }
+    memoryUsed += resource.memorySize;
+
+    if(resource.refCount == 0 && resource.state != RESOURCE_UPLOADING)
+    {
+        LinkUnused(result.slot);
+    }
+}
+
+void ResourceManager::FreeResult(LoadResult& result)
+{
+    if(result.image.data != nullptr)
+    {
+        UnloadImage(result.image);
+    }
+    if(result.wave.data != nullptr)
+    {
+        UnloadWave(result.wave);
+    }
+    if(result.data != nullptr)
+    {
+        UnloadFileData(result.data);
+    }
+    result = {result.slot, false, Image(), Wave(), nullptr, 0};
+}
+
+void ResourceManager::Upload(uint32_t slot)
+{
+    Resource& resource = resources[slot];
+    // Note: The GPU copy is counted as the same size as the image it came from
+    resource.texture = RenderBackend::GetCurrent()->CreateTextureFromImage(resource.pendingImage);
+    UnloadImage(resource.pendingImage);
+    resource.pendingImage = Image();
+    resource.state = RESOURCE_READY;
+    if(resource.refCount == 0)
+    {
+        LinkUnused(slot);
+    }
+}
+
+void ResourceManager::FreeData(Resource& resource)
+{
+    if(resource.texture != NULL_RENDER_TEXTURE && RenderBackend::GetCurrent() != nullptr)
+    {
+        RenderBackend::GetCurrent()->DestroyRenderTexture(resource.texture);
+    }
+    if(resource.pendingImage.data != nullptr)
+    {
+        UnloadImage(resource.pendingImage);
+    }
+    if(resource.wave.data != nullptr)
+    {
+        UnloadWave(resource.wave);
+    }
+    if(resource.data != nullptr)
+    {
+        UnloadFileData(resource.data);
+    }
+    resource.texture = NULL_RENDER_TEXTURE;
+    resource.pendingImage = Image();
+    resource.wave = Wave();
+    resource.data = nullptr;
+    resource.dataSize = 0;
+    memoryUsed -= resource.memorySize;
+    resource.memorySize = 0;
+}
+
+void ResourceManager::AddRef(uint32_t slot)
+{
+    Resource& resource = resources[slot];
+    if(resource.refCount == 0)
+    {
+        UnlinkUnused(slot);
+    }
+    resource.refCount++;
+}
+
+void ResourceManager::Release(uint32_t slot)
+{
+    Resource& resource = resources[slot];
+    resource.refCount--;
+    // Still loading ones are added once they're done. Freeing happens in Update(), so something
+    // released and loaded again in the same frame doesn't get reloaded
+    if(resource.refCount == 0 && (resource.state == RESOURCE_READY || resource.state == RESOURCE_FAILED))
+    {
+        LinkUnused(slot);
+    }
+}
+
+void ResourceManager::LinkUnused(uint32_t slot)
+{
+    Resource& resource = resources[slot];
+    resource.previousUnused = NULL_SLOT;
+    resource.nextUnused = unusedHead;
+    if(unusedHead != NULL_SLOT)
+    {
+        resources[unusedHead].previousUnused = slot;
+    }
+    unusedHead = slot;
+    if(unusedTail == NULL_SLOT)
+    {
+        unusedTail = slot;
+    }
+}
+
+void ResourceManager::UnlinkUnused(uint32_t slot)
+{
+    Resource& resource = resources[slot];
+    if(unusedHead != (int)slot && resource.previousUnused == NULL_SLOT)
+    {
+        return;     // Not in the list
+    }
+    if(resource.previousUnused != NULL_SLOT)
+    {
+        resources[resource.previousUnused].nextUnused = resource.nextUnused;
+    }
+    else
+    {
+        unusedHead = resource.nextUnused;
+    }
+    if(resource.nextUnused != NULL_SLOT)
+    {
+        resources[resource.nextUnused].previousUnused = resource.previousUnused;
+    }
+    else
+    {
+        unusedTail = resource.previousUnused;
+    }
+    resource.previousUnused = NULL_SLOT;
+    resource.nextUnused = NULL_SLOT;
+}
+
+void ResourceManager::EvictToBudget()
+{
+    // Least recently released first
+    while(memoryUsed > memoryBudget && unusedTail != NULL_SLOT)
+    {
+        uint32_t slot = unusedTail;
+        UnlinkUnused(slot);
+        Resource& resource = resources[slot];
+        FreeData(resource);
+        slotsByPath.erase(resource.path);
+        resource = Resource();
+        freeSlots.push_back(slot);
+    }
+}
@@ -0,0 +1,566 @@
+#include "../../include/astrocore/systems/scenefile.h"
+#include "../../include/astrocore/systems/debug.h"
+#include <cstring>
+#include <cstdlib>
+#include <sstream>
+
+using namespace Astrocore;
+
+// The file layout is the in-memory layout, so it can't change without bumping the version
+static_assert(sizeof(SceneFileHeader) == 56, "Scene file header layout changed");
+static_assert(sizeof(SceneFileNode) == 56, "Scene file node layout changed");
+static_assert(sizeof(SceneFileShape) == 20, "Scene file shape layout changed");
+static_assert(sizeof(Vector2) == 8, "Scene file points are 2 floats");
+
+static const uint64_t SECTION_ALIGNMENT = 8;
+
+static inline uint64_t AlignSection(uint64_t offset)
+{
+    return (offset + SECTION_ALIGNMENT - 1) & ~(SECTION_ALIGNMENT - 1);
+}
+
+// Loading
+
+SceneFile::~SceneFile()
+{
+    Close();
+}
+
+bool SceneFile::Open(const std::string& path)
+{
+    Close();
+    if(!file.Open(path))
+    {
+        return false;
+    }
+    data = file.GetData();
+    size = file.GetSize();
+    if(!Validate())
+    {
+        DBG_ERR("{} isn't a valid scene", path);
+        Close();
+        return false;
+    }
+    return true;
+}
+
+void SceneFile::Close()
+{
+    file.Close();
+    data = nullptr;
+    size = 0;
+    header = nullptr;
+    nodes = nullptr;
+    shapes = nullptr;
+    points = nullptr;
+    names = nullptr;
+}
+
+bool SceneFile::Validate()
+{
+    if(size < sizeof(SceneFileHeader))
+    {
+        return false;
+    }
+    const SceneFileHeader* fileHeader = (const SceneFileHeader*)data;
+    if(memcmp(fileHeader->magic, SCENE_FILE_MAGIC, sizeof(SCENE_FILE_MAGIC)) != 0)
+    {
+        return false;
+    }
+    if(fileHeader->version != SCENE_FILE_VERSION)
+    {
+        DBG_ERR("Unsupported scene version {}", fileHeader->version);
+        return false;
+    }
+
+    // Every array has to be aligned and inside the file (counts are 32 bit, so none of this can overflow)
+    auto isInFile = [this](uint64_t offset, uint64_t count, uint64_t elementSize)
+    {
+        return offset % 4 == 0 && offset <= size && count * elementSize <= size - offset;
+    };
+    if(fileHeader->nodeCount == 0 ||
+       !isInFile(fileHeader->nodesOffset, fileHeader->nodeCount, sizeof(SceneFileNode)) ||
+       !isInFile(fileHeader->shapesOffset, fileHeader->shapeCount, sizeof(SceneFileShape)) ||
+       !isInFile(fileHeader->pointsOffset, fileHeader->pointCount, sizeof(Vector2)) ||
+       fileHeader->namesOffset > size || fileHeader->nameBytes > size - fileHeader->namesOffset)
+    {
+        return false;
+    }
+    const SceneFileNode* fileNodes = (const SceneFileNode*)(data + fileHeader->nodesOffset);
+    const SceneFileShape* fileShapes = (const SceneFileShape*)(data + fileHeader->shapesOffset);
+
+    // One root, and parents before children, so instantiating never has to look ahead
+    // Shape and point ranges have to follow each other in order (the way they're written), so no two
+    // nodes can share one and instantiating never copies more than the file holds
+    std::vector<uint32_t> childCounts(fileHeader->nodeCount, 0);
+    uint64_t shapeTotal = 0;
+    for(uint32_t i = 0; i < fileHeader->nodeCount; i++)
+    {
+        const SceneFileNode& node = fileNodes[i];
+        bool isParentValid = i == 0 ? node.parent == -1 : node.parent >= 0 && (uint32_t)node.parent < i;
+        if(!isParentValid || node.type > SCENE_SHAPE_NODE || node.firstShape != shapeTotal ||
+           (uint64_t)node.nameOffset + node.nameLength > fileHeader->nameBytes)
+        {
+            return false;
+        }
+        shapeTotal += node.shapeCount;
+        if(node.parent >= 0)
+        {
+            childCounts[node.parent]++;
+        }
+    }
+    if(shapeTotal != fileHeader->shapeCount)
+    {
+        return false;
+    }
+    // Child counts get reserved up front, so they have to be the real ones (otherwise every node could
+    // claim almost the whole file's worth of children)
+    for(uint32_t i = 0; i < fileHeader->nodeCount; i++)
+    {
+        if(fileNodes[i].childCount != childCounts[i])
+        {
+            return false;
+        }
+    }
+    uint64_t pointTotal = 0;
+    for(uint32_t i = 0; i < fileHeader->shapeCount; i++)
+    {
+        if(fileShapes[i].firstPoint != pointTotal)
+        {
+            return false;
+        }
+        pointTotal += fileShapes[i].pointCount;
+    }
+    if(pointTotal != fileHeader->pointCount)
+    {
+        return false;
+    }
+
+    header = fileHeader;
+    nodes = fileNodes;
+    shapes = fileShapes;
+    points = (const Vector2*)(data + fileHeader->pointsOffset);
+    names = (const char*)(data + fileHeader->namesOffset);
+    return true;
+}
+
+Node* SceneFile::Instantiate(NodePool<Node>* nodePool, NodePool<ShapeNode>* shapePool)
+{
+    if(header == nullptr)
+    {
+        return nullptr;
+    }
+
+    std::vector<Node*> created(header->nodeCount);
+    for(uint32_t i = 0; i < header->nodeCount; i++)
+    {
+        const SceneFileNode& fileNode = nodes[i];
+        Node* node;
+        if(fileNode.type == SCENE_SHAPE_NODE)
+        {
+            ShapeNode* shapeNode = shapePool != nullptr ? shapePool->Create() : new ShapeNode();
+            for(uint32_t s = fileNode.firstShape; s < fileNode.firstShape + fileNode.shapeCount; s++)
+            {
+                const SceneFileShape& fileShape = shapes[s];
+                Shape shape;
+                shape.points.assign(points + fileShape.firstPoint, points + fileShape.firstPoint + fileShape.pointCount);
+                shape.color = {fileShape.color[0], fileShape.color[1], fileShape.color[2], fileShape.color[3]};
+                shape.lineWidth = fileShape.lineWidth;
+                shape.isFilled = fileShape.isFilled != 0;
+                shape.isClosed = fileShape.isClosed != 0;
+                shapeNode->AddShape(std::move(shape));
+            }
+            node = shapeNode;
+        }
+        else
+        {
+            node = nodePool != nullptr ? nodePool->Create() : new Node();
+        }
+
+        node->name.assign(names + fileNode.nameOffset, fileNode.nameLength);
+        Transform2D* transform = node->GetTransform();
+        transform->SetPosition({fileNode.position[0], fileNode.position[1]});
+        transform->SetRotation(fileNode.rotation);
+        transform->SetScale(fileNode.scale[0], fileNode.scale[1]);
+        node->SetZIndex(fileNode.zIndex);
+        node->SetRenderLayer(fileNode.renderLayer);
+        node->SetLayerMask(fileNode.layerMask);
+        node->SetInheritsParentTransform(fileNode.inheritsParentTransform != 0);
+        node->ReserveChildren(fileNode.childCount);
+
+        created[i] = node;
+        if(fileNode.parent >= 0)
+        {
+            created[fileNode.parent]->AddChild(node);
+        }
+    }
+    return created[0];
+}
+
+// Writing
+
+int SceneFileWriter::AddNode(int parent, const std::string& name, SCENE_NODE_TYPE type, const Transform2D& transform)
+{
+    if(parent < -1 || parent >= (int)nodes.size() || (parent == -1 && !nodes.empty()) || (parent != -1 && nodes.empty()))
+    {
+        DBG_ERR("Scene node {} needs a parent that's already in the scene (only the first node is the root)", name);
+        return -1;
+    }
+
+    PendingNode pending;
+    pending.node = SceneFileNode();
+    pending.node.parent = parent;
+    pending.node.layerMask = 1;
+    pending.node.type = type;
+    pending.node.inheritsParentTransform = 1;
+    pending.name = name;
+    nodes.push_back(std::move(pending));
+    if(parent >= 0)
+    {
+        nodes[parent].node.childCount++;
+    }
+    SetTransform(nodes.size() - 1, transform);
+    return nodes.size() - 1;
+}
+
+void SceneFileWriter::SetTransform(int node, const Transform2D& transform)
+{
+    if(node >= 0 && node < (int)nodes.size())
+    {
+        nodes[node].node.position[0] = transform.GetPosition().x;
+        nodes[node].node.position[1] = transform.GetPosition().y;
+        nodes[node].node.rotation = transform.GetRotation();
+        nodes[node].node.scale[0] = transform.GetScale().x;
+        nodes[node].node.scale[1] = transform.GetScale().y;
+    }
+}
+
+void SceneFileWriter::AddShape(int node, const Shape& shape)
+{
+    if(node >= 0 && node < (int)nodes.size())
+    {
+        nodes[node].shapes.push_back(shape);
+    }
+}
+
+void SceneFileWriter::SetZIndex(int node, int zIndex)
+{
+    if(node >= 0 && node < (int)nodes.size())
+    {
+        nodes[node].node.zIndex = zIndex;
+    }
+}
+
+void SceneFileWriter::SetRenderLayer(int node, uint8_t renderLayer, uint32_t layerMask)
+{
+    if(node >= 0 && node < (int)nodes.size())
+    {
+        nodes[node].node.renderLayer = renderLayer;
+        nodes[node].node.layerMask = layerMask;
+    }
+}
+
+void SceneFileWriter::SetInheritsParentTransform(int node, bool inheritsParentTransform)
+{
+    if(node >= 0 && node < (int)nodes.size())
+    {
+        nodes[node].node.inheritsParentTransform = inheritsParentTransform ? 1 : 0;
+    }
+}
+
+static void WritePadding(std::ostream& stream, uint64_t* offset, uint64_t target)
+{
+    static const char zeros[SECTION_ALIGNMENT] = {};
+    stream.write(zeros, target - *offset);
+    *offset = target;
+}
+
+bool SceneFileWriter::Write(std::ostream& outputStream)
+{
+    if(nodes.empty())
+    {
+        DBG_ERR("Can't write a scene without a root node");
+        return false;
+    }
+
+    // Flatten everything, in node order
+    std::vector<SceneFileNode> fileNodes;
+    std::vector<SceneFileShape> fileShapes;
+    std::vector<Vector2> filePoints;
+    std::string fileNames;
+    fileNodes.reserve(nodes.size());
+    for(const PendingNode& pending : nodes)
+    {
+        SceneFileNode node = pending.node;
+        node.firstShape = fileShapes.size();
+        node.shapeCount = node.type == SCENE_SHAPE_NODE ? pending.shapes.size() : 0;
+        node.nameOffset = fileNames.size();
+        node.nameLength = pending.name.size();
+        fileNames += pending.name;
+        for(uint32_t i = 0; i < node.shapeCount; i++)
+        {
+            const Shape& shape = pending.shapes[i];
+            SceneFileShape fileShape = SceneFileShape();
+            fileShape.firstPoint = filePoints.size();
+            fileShape.pointCount = shape.points.size();
+            fileShape.color[0] = shape.color.r;
+            fileShape.color[1] = shape.color.g;
+            fileShape.color[2] = shape.color.b;
+            fileShape.color[3] = shape.color.a;
+            fileShape.lineWidth = shape.lineWidth;
+            fileShape.isFilled = shape.isFilled ? 1 : 0;
+            fileShape.isClosed = shape.isClosed ? 1 : 0;
+            fileShapes.push_back(fileShape);
+            filePoints.insert(filePoints.end(), shape.points.begin(), shape.points.end());
+        }
+        fileNodes.push_back(node);
+    }
+
+    SceneFileHeader header = SceneFileHeader();
+    memcpy(header.magic, SCENE_FILE_MAGIC, sizeof(SCENE_FILE_MAGIC));
+    header.version = SCENE_FILE_VERSION;
+    header.nodeCount = fileNodes.size();
+    header.shapeCount = fileShapes.size();
+    header.pointCount = filePoints.size();
+    header.nameBytes = fileNames.size();
+    header.nodesOffset = AlignSection(sizeof(SceneFileHeader));
+    header.shapesOffset = AlignSection(header.nodesOffset + fileNodes.size() * sizeof(SceneFileNode));
+    header.pointsOffset = AlignSection(header.shapesOffset + fileShapes.size() * sizeof(SceneFileShape));
+    header.namesOffset = AlignSection(header.pointsOffset + filePoints.size() * sizeof(Vector2));
+
+    uint64_t offset = sizeof(SceneFileHeader);
+    outputStream.write((const char*)&header, sizeof(header));
+    WritePadding(outputStream, &offset, header.nodesOffset);
+    outputStream.write((const char*)fileNodes.data(), fileNodes.size() * sizeof(SceneFileNode));
+    offset += fileNodes.size() * sizeof(SceneFileNode);
+    WritePadding(outputStream, &offset, header.shapesOffset);
+    outputStream.write((const char*)fileShapes.data(), fileShapes.size() * sizeof(SceneFileShape));
+    offset += fileShapes.size() * sizeof(SceneFileShape);
+    WritePadding(outputStream, &offset, header.pointsOffset);
+    outputStream.write((const char*)filePoints.data(), filePoints.size() * sizeof(Vector2));
+    offset += filePoints.size() * sizeof(Vector2);
+    WritePadding(outputStream, &offset, header.namesOffset);
+    outputStream.write(fileNames.data(), fileNames.size());
+    outputStream.flush();
+
+    if(!outputStream)
+    {
+        DBG_ERR("Couldn't write the scene");
+        return false;
+    }
+    return true;
+}
+
+// Text baking
+
+// Reads 'count' comma separated numbers
+static bool ParseFloats(const std::string& text, float* values, int count)
+{
+    const char* start = text.c_str();
+    for(int i = 0; i < count; i++)
+    {
+        char* end;
+        values[i] = strtof(start, &end);
+        if(end == start || (i < count - 1 ? *end != ',' : *end != '\0'))
+        {
+            return false;
+        }
+        start = end + 1;
+    }
+    return true;
+}
+
+static bool ParseNodeOption(const std::string& key, const std::string& value, Transform2D* transform, SceneFileWriter* writer, int node,
+                            uint8_t* renderLayer, uint32_t* layerMask)
+{
+    float values[2];
+    if(key == "pos" && ParseFloats(value, values, 2))
+    {
+        transform->SetPosition({values[0], values[1]});
+    }
+    else if(key == "rot" && ParseFloats(value, values, 1))
+    {
+        transform->SetRotationDegrees(values[0]);
+    }
+    else if(key == "scale" && ParseFloats(value, values, 2))
+    {
+        transform->SetScale(values[0], values[1]);
+    }
+    else if(key == "z" && ParseFloats(value, values, 1))
+    {
+        writer->SetZIndex(node, (int)values[0]);
+    }
+    else if(key == "layer" && ParseFloats(value, values, 1))
+    {
+        *renderLayer = (uint8_t)values[0];
+    }
+    else if(key == "mask")
+    {
+        char* end;
+        *layerMask = strtoul(value.c_str(), &end, 0);
+        return *end == '\0';
+    }
+    else if(key == "inherit" && (value == "0" || value == "1"))
+    {
+        writer->SetInheritsParentTransform(node, value == "1");
+    }
+    else
+    {
+        return false;
+    }
+    return true;
+}
+
+static bool ParseShapeOption(const std::string& key, const std::string& value, Shape* shape)
+{
+    float values[4];
+    if(key == "fill" && (value == "0" || value == "1"))
+    {
+        shape->isFilled = value == "1";
+    }
+    else if(key == "closed" && (value == "0" || value == "1"))
+    {
+        shape->isClosed = value == "1";
+    }
+    else if(key == "width" && ParseFloats(value, values, 1))
+    {
+        shape->lineWidth = values[0];
+    }
+    else if(key == "color" && ParseFloats(value, values, 4))
+    {
+        shape->color = {(unsigned char)values[0], (unsigned char)values[1], (unsigned char)values[2], (unsigned char)values[3]};
+    }
+    else
+    {
+        return false;
+    }
+    return true;
+}
+
+bool Astrocore::BakeSceneText(std::istream& textStream, std::ostream& outputStream)
+{
+    struct OpenNode
+    {
+        size_t indent;
+        int node;
+        bool isShapeNode;
+    };
+    std::vector<OpenNode> openNodes;    // The current line's ancestors, innermost last
+    SceneFileWriter writer;
+
+    std::string line;
+    int lineNumber = 0;
+    while(std::getline(textStream, line))
+    {
+        lineNumber++;
+        if(!line.empty() && line.back() == '\r')
+        {
+            line.pop_back();
+        }
+        size_t indent = line.find_first_not_of(" \t");
+        if(indent == std::string::npos || line[indent] == '#')
+        {
+            continue;
+        }
+
+        std::istringstream tokens(line.substr(indent));
+        std::string keyword;
+        tokens >> keyword;
+        while(!openNodes.empty() && openNodes.back().indent >= indent)
+        {
+            openNodes.pop_back();
+        }
+
+        if(keyword == "node" || keyword == "shapenode")
+        {
+            std::string name;
+            if(!(tokens >> name))
+            {
+                DBG_ERR("Scene line {}: {} needs a name", lineNumber, keyword);
+                return false;
+            }
+            if(openNodes.empty() && writer.GetNodeCount() > 0)
+            {
+                DBG_ERR("Scene line {}: there can only be one root node", lineNumber);
+                return false;
+            }
+
+            bool isShapeNode = keyword == "shapenode";
+            int parent = openNodes.empty() ? -1 : openNodes.back().node;
+            int node = writer.AddNode(parent, name, isShapeNode ? SCENE_SHAPE_NODE : SCENE_NODE, Transform2D());
+            Transform2D transform;
+            uint8_t renderLayer = 0;
+            uint32_t layerMask = 1;
+            std::string option;
+            while(tokens >> option)
+            {
+                size_t equals = option.find('=');
+                if(equals == std::string::npos ||
+                   !ParseNodeOption(option.substr(0, equals), option.substr(equals + 1), &transform, &writer, node, &renderLayer, &layerMask))
+                {
+                    DBG_ERR("Scene line {}: bad option '{}'", lineNumber, option);
+                    return false;
+                }
+            }
+
+            // Options are applied on top of the node once they're all read
+            writer.SetRenderLayer(node, renderLayer, layerMask);
+            writer.SetTransform(node, transform);
+            openNodes.push_back({indent, node, isShapeNode});
+        }
+        else if(keyword == "rect" || keyword == "circle" || keyword == "points")
+        {
+            if(openNodes.empty() || !openNodes.back().isShapeNode)
+            {
+                DBG_ERR("Scene line {}: shapes have to be under a shape node", lineNumber);
+                return false;
+            }
+
+            Shape shape;
+            std::string option;
+            if(keyword == "rect" || keyword == "circle")
+            {
+                std::string first, second;
+                float values[2];
+                if(!(tokens >> first >> second) || !ParseFloats(first, &values[0], 1) || !ParseFloats(second, &values[1], 1))
+                {
+                    DBG_ERR("Scene line {}: {} needs two sizes", lineNumber, keyword);
+                    return false;
+                }
+                shape = keyword == "rect" ? Shape().AsRect(values[0], values[1]) : Shape().AsCircle(values[0], (int)values[1]);
+            }
+
+            bool isValid = true;
+            while(isValid && tokens >> option)
+            {
+                size_t equals = option.find('=');
+                float point[2];
+                if(equals != std::string::npos)
+                {
+                    isValid = ParseShapeOption(option.substr(0, equals), option.substr(equals + 1), &shape);
+                }
+                else if(keyword == "points" && ParseFloats(option, point, 2))
+                {
+                    shape.points.push_back({point[0], point[1]});
+                }
+                else
+                {
+                    isValid = false;
+                }
+            }
+            if(!isValid)
+            {
+                DBG_ERR("Scene line {}: bad option '{}'", lineNumber, option);
+                return false;
+            }
+            writer.AddShape(openNodes.back().node, shape);
+        }
+        else
+        {
+            DBG_ERR("Scene line {}: unknown keyword '{}'", lineNumber, keyword);
+            return false;
+        }
+    }
+
+    return writer.Write(outputStream);
+}
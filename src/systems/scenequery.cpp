@@ -0,0 +1,469 @@
+#include "../../include/astrocore/systems/scenequery.h"
+#include <algorithm>
+#include <utility>
+
+using namespace Astrocore;
+
+static inline float Cross(Vector2 a, Vector2 b)
+{
+    return a.x * b.y - a.y * b.x;
+}
+
+static inline Vector2 Subtract(Vector2 a, Vector2 b)
+{
+    return {a.x - b.x, a.y - b.y};
+}
+
+// Unit normal of an edge, flipped to face against a direction
+static inline Vector2 FacingNormal(Vector2 edge, Vector2 direction)
+{
+    float length = sqrtf(edge.x * edge.x + edge.y * edge.y);
+    Vector2 normal = {edge.y / length, -edge.x / length};
+    if(normal.x * direction.x + normal.y * direction.y > 0)
+    {
+        normal = {-normal.x, -normal.y};
+    }
+    return normal;
+}
+
+// Where along a ray (origin + t * direction) it crosses the segment start -> end, or -1 if it doesn't
+static inline float RaySegment(Vector2 origin, Vector2 direction, Vector2 start, Vector2 end)
+{
+    Vector2 edge = Subtract(end, start);
+    float denominator = Cross(direction, edge);
+    if(denominator == 0)
+    {
+        return -1;      // Parallel
+    }
+    Vector2 toStart = Subtract(start, origin);
+    float t = Cross(toStart, edge) / denominator;
+    float s = Cross(toStart, direction) / denominator;
+    return t >= 0 && s >= 0 && s <= 1 ? t : -1;
+}
+
+static inline bool SegmentsIntersect(Vector2 a1, Vector2 a2, Vector2 b1, Vector2 b2)
+{
+    Vector2 a = Subtract(a2, a1);
+    Vector2 b = Subtract(b2, b1);
+    float d1 = Cross(a, Subtract(b1, a1));
+    float d2 = Cross(a, Subtract(b2, a1));
+    float d3 = Cross(b, Subtract(a1, b1));
+    float d4 = Cross(b, Subtract(a2, b1));
+    if(((d1 > 0 && d2 < 0) || (d1 < 0 && d2 > 0)) && ((d3 > 0 && d4 < 0) || (d3 < 0 && d4 > 0)))
+    {
+        return true;
+    }
+
+    // Touching or collinear, check if the end points are on the other segment
+    auto onSegment = [](Vector2 p, Vector2 q, Vector2 r)
+    {
+        return fminf(p.x, q.x) <= r.x && r.x <= fmaxf(p.x, q.x) && fminf(p.y, q.y) <= r.y && r.y <= fmaxf(p.y, q.y);
+    };
+    return (d1 == 0 && onSegment(a1, a2, b1)) || (d2 == 0 && onSegment(a1, a2, b2)) ||
+        (d3 == 0 && onSegment(b1, b2, a1)) || (d4 == 0 && onSegment(b1, b2, a2));
+}
+
+// Even-odd rule, so it works for any simple polygon (not just convex ones)
+static bool PointInPolygon(Vector2 point, const Vector2* polygon, size_t count)
+{
+    bool isInside = false;
+    for(size_t i = 0, j = count - 1; i < count; j = i++)
+    {
+        Vector2 a = polygon[i];
+        Vector2 b = polygon[j];
+        if((a.y > point.y) != (b.y > point.y) && point.x < (b.x - a.x) * (point.y - a.y) / (b.y - a.y) + a.x)
+        {
+            isInside = !isInside;
+        }
+    }
+    return isInside;
+}
+
+static inline Vector2 ClosestOnSegment(Vector2 point, Vector2 start, Vector2 end)
+{
+    Vector2 edge = Subtract(end, start);
+    float lengthSquared = edge.x * edge.x + edge.y * edge.y;
+    if(lengthSquared == 0)
+    {
+        return start;
+    }
+    Vector2 toPoint = Subtract(point, start);
+    float t = std::clamp((toPoint.x * edge.x + toPoint.y * edge.y) / lengthSquared, 0.0f, 1.0f);
+    return {start.x + edge.x * t, start.y + edge.y * t};
+}
+
+static inline size_t EdgeCount(const QueryOutline& outline)
+{
+    if(outline.count < 2)
+    {
+        return 0;
+    }
+    return outline.isClosed ? outline.count : outline.count - 1;
+}
+
+void QueryGeometry::AddOutline(const std::vector<Vector2>& localPoints, const Affine2D& transform, bool isClosed)
+{
+    if(localPoints.empty())
+    {
+        return;
+    }
+    uint32_t start = points.size();
+    points.resize(start + localPoints.size());
+    transform.ApplyToPoints(localPoints.data(), &points[start], localPoints.size());
+    outlines.push_back({start, (uint32_t)localPoints.size(), isClosed && localPoints.size() >= 3});
+}
+
+int SceneQuery::SyncNode(TreeNode* node, int proxy)
+{
+    scratchGeometry.Clear();
+    if(!node->GetQueryGeometry(&scratchGeometry) || scratchGeometry.points.empty())
+    {
+        RemoveNode(proxy);
+        return NULL_TREE_NODE;
+    }
+
+    AabbTree::Aabb bounds = {INFINITY, INFINITY, -INFINITY, -INFINITY};
+    for(const Vector2& point : scratchGeometry.points)
+    {
+        bounds = {fminf(bounds.minX, point.x), fminf(bounds.minY, point.y), fmaxf(bounds.maxX, point.x), fmaxf(bounds.maxY, point.y)};
+    }
+
+    if(proxy == NULL_TREE_NODE)
+    {
+        // Proxy data is looked up by proxy ID, so the tree's user data isn't needed
+        proxy = tree.CreateProxy(bounds, 0);
+        if(proxy >= (int)proxies.size())
+        {
+            proxies.resize(proxy + 1);
+        }
+    }
+    else
+    {
+        tree.MoveProxy(proxy, bounds);
+    }
+
+    // Swapped rather than copied, so neither side has to reallocate next time
+    QueryProxy& entry = proxies[proxy];
+    entry.node = node;
+    entry.layerMask = node->GetLayerMask();
+    std::swap(entry.geometry, scratchGeometry);
+    return proxy;
+}
+
+void SceneQuery::RemoveNode(int proxy)
+{
+    if(proxy == NULL_TREE_NODE)
+    {
+        return;
+    }
+    tree.DestroyProxy(proxy);
+    proxies[proxy].node = nullptr;
+    proxies[proxy].layerMask = 0;
+    proxies[proxy].geometry.Clear();
+}
+
+void SceneQuery::RaycastProxy(const QueryProxy& proxy, Vector2 origin, Vector2 direction, QueryHit* hit) const
+{
+    const std::vector<Vector2>& points = proxy.geometry.points;
+    for(const QueryOutline& outline : proxy.geometry.outlines)
+    {
+        size_t edgeCount = EdgeCount(outline);
+        for(size_t i = 0; i < edgeCount; i++)
+        {
+            Vector2 start = points[outline.start + i];
+            Vector2 end = points[outline.start + (i + 1) % outline.count];
+            float t = RaySegment(origin, direction, start, end);
+            if(t < 0 || t >= hit->distance)
+            {
+                continue;
+            }
+            hit->node = proxy.node;
+            hit->distance = t;
+            hit->point = {origin.x + direction.x * t, origin.y + direction.y * t};
+            hit->normal = FacingNormal(Subtract(end, start), direction);
+        }
+    }
+}
+
+bool SceneQuery::Raycast(Vector2 origin, Vector2 direction, float maxDistance, QueryHit* outHit, uint32_t layerMask) const
+{
+    QueryHit hit;
+    hit.distance = maxDistance;
+    float length = sqrtf(direction.x * direction.x + direction.y * direction.y);
+    if(length > 0)
+    {
+        // Normalized, so distances along the ray and through the tree are in world units
+        direction = {direction.x / length, direction.y / length};
+        tree.RayCast(origin, direction, maxDistance, [&](int proxyID, float maxFraction)
+        {
+            const QueryProxy& proxy = proxies[proxyID];
+            if(!(proxy.layerMask & layerMask))
+            {
+                return maxFraction;
+            }
+            // Only hits closer than the closest so far count, so the traversal gets clipped to it
+            RaycastProxy(proxy, origin, direction, &hit);
+            return hit.distance;
+        });
+    }
+
+    *outHit = hit;
+    return hit.node != nullptr;
+}
+
+void SceneQuery::RaycastBatch(const RayQuery* rays, size_t count, QueryHit* outHits, JobSystem* jobSystem) const
+{
+    auto castRays = [&](size_t begin, size_t end)
+    {
+        for(size_t i = begin; i < end; i++)
+        {
+            Raycast(rays[i].origin, rays[i].direction, rays[i].maxDistance, &outHits[i], rays[i].layerMask);
+        }
+    };
+
+    if(jobSystem != nullptr && count > RAY_BATCH_SIZE)
+    {
+        jobSystem->ParallelFor(count, RAY_BATCH_SIZE, std::move(castRays));
+    }
+    else
+    {
+        castRays(0, count);
+    }
+}
+
+// The first contact between two polygons sliding past each other is always a corner of one touching an
+// edge of the other, so it's enough to cast rays from every corner of each against the edges of the other
+void SceneQuery::ShapeCastProxy(const QueryProxy& proxy, const std::vector<Vector2>& points, Vector2 direction, QueryHit* hit) const
+{
+    // The swept polygon's corners, forward into the proxy's edges
+    for(const Vector2& point : points)
+    {
+        RaycastProxy(proxy, point, direction, hit);
+    }
+
+    // The proxy's corners, backward into the swept polygon's edges
+    size_t count = points.size();
+    if(count < 2)
+    {
+        return;
+    }
+    Vector2 backward = {-direction.x, -direction.y};
+    for(const Vector2& corner : proxy.geometry.points)
+    {
+        for(size_t i = 0; i < count; i++)
+        {
+            Vector2 start = points[i];
+            Vector2 end = points[(i + 1) % count];
+            float t = RaySegment(corner, backward, start, end);
+            if(t < 0 || t >= hit->distance)
+            {
+                continue;
+            }
+            hit->node = proxy.node;
+            hit->distance = t;
+            hit->point = corner;
+            // Note: Only the swept polygon's edge is known here, so its normal is used
+            hit->normal = FacingNormal(Subtract(end, start), direction);
+        }
+    }
+}
+
+bool SceneQuery::ShapeCast(const std::vector<Vector2>& points, Vector2 direction, float maxDistance, QueryHit* outHit, uint32_t layerMask) const
+{
+    QueryHit hit;
+    hit.distance = maxDistance;
+    float length = sqrtf(direction.x * direction.x + direction.y * direction.y);
+    if(points.empty() || length == 0)
+    {
+        *outHit = hit;
+        return false;
+    }
+    direction = {direction.x / length, direction.y / length};
+
+    // Everything the polygon could touch is inside the box it sweeps through
+    AabbTree::Aabb start = {INFINITY, INFINITY, -INFINITY, -INFINITY};
+    Vector2 center = {0, 0};
+    for(const Vector2& point : points)
+    {
+        start = {fminf(start.minX, point.x), fminf(start.minY, point.y), fmaxf(start.maxX, point.x), fmaxf(start.maxY, point.y)};
+        center = {center.x + point.x, center.y + point.y};
+    }
+    center = {center.x / points.size(), center.y / points.size()};
+    float reachX = direction.x != 0 ? direction.x * maxDistance : 0;
+    float reachY = direction.y != 0 ? direction.y * maxDistance : 0;
+    AabbTree::Aabb swept = {start.minX + fminf(reachX, 0), start.minY + fminf(reachY, 0), start.maxX + fmaxf(reachX, 0), start.maxY + fmaxf(reachY, 0)};
+
+    tree.Query(swept, [&](int proxyID)
+    {
+        const QueryProxy& proxy = proxies[proxyID];
+        if(!(proxy.layerMask & layerMask))
+        {
+            return true;
+        }
+        if(OverlapsPolygon(proxy, points.data(), points.size()))
+        {
+            hit.node = proxy.node;
+            hit.distance = 0;
+            hit.point = center;
+            hit.normal = {-direction.x, -direction.y};
+            return false;   // Nothing can be closer
+        }
+        ShapeCastProxy(proxy, points, direction, &hit);
+        return true;
+    });
+
+    *outHit = hit;
+    return hit.node != nullptr;
+}
+
+bool SceneQuery::OverlapsPolygon(const QueryProxy& proxy, const Vector2* polygon, size_t count) const
+{
+    const std::vector<Vector2>& points = proxy.geometry.points;
+    for(const QueryOutline& outline : proxy.geometry.outlines)
+    {
+        // Crossing edges
+        size_t edgeCount = EdgeCount(outline);
+        for(size_t i = 0; i < edgeCount; i++)
+        {
+            Vector2 start = points[outline.start + i];
+            Vector2 end = points[outline.start + (i + 1) % outline.count];
+            for(size_t j = 0; j < count; j++)
+            {
+                if(SegmentsIntersect(start, end, polygon[j], polygon[(j + 1) % count]))
+                {
+                    return true;
+                }
+            }
+        }
+
+        // No edges cross, so one can only overlap the other by being completely inside it
+        if(count >= 3 && PointInPolygon(points[outline.start], polygon, count))
+        {
+            return true;
+        }
+        if(outline.isClosed && PointInPolygon(polygon[0], &points[outline.start], outline.count))
+        {
+            return true;
+        }
+    }
+    return false;
+}
+
+void SceneQuery::QueryPoint(Vector2 point, std::vector<TreeNode*>* results, uint32_t layerMask) const
+{
+    tree.Query({point.x, point.y, point.x, point.y}, [&](int proxyID)
+    {
+        const QueryProxy& proxy = proxies[proxyID];
+        if(!(proxy.layerMask & layerMask))
+        {
+            return true;
+        }
+        for(const QueryOutline& outline : proxy.geometry.outlines)
+        {
+            if(outline.isClosed && PointInPolygon(point, &proxy.geometry.points[outline.start], outline.count))
+            {
+                results->push_back(proxy.node);
+                break;
+            }
+        }
+        return true;
+    });
+}
+
+void SceneQuery::QueryRectangle(Rectangle area, std::vector<TreeNode*>* results, uint32_t layerMask) const
+{
+    Vector2 corners[4] = {
+        {area.x, area.y},
+        {area.x + area.width, area.y},
+        {area.x + area.width, area.y + area.height},
+        {area.x, area.y + area.height}};
+
+    tree.Query(AabbTree::FromRectangle(area), [&](int proxyID)
+    {
+        const QueryProxy& proxy = proxies[proxyID];
+        if((proxy.layerMask & layerMask) && OverlapsPolygon(proxy, corners, 4))
+        {
+            results->push_back(proxy.node);
+        }
+        return true;
+    });
+}
+
+float SceneQuery::ClosestPoint(const QueryProxy& proxy, Vector2 point, Vector2* outClosest) const
+{
+    const std::vector<Vector2>& points = proxy.geometry.points;
+    float bestSquared = INFINITY;
+    for(const QueryOutline& outline : proxy.geometry.outlines)
+    {
+        if(outline.isClosed && PointInPolygon(point, &points[outline.start], outline.count))
+        {
+            *outClosest = point;
+            return 0;
+        }
+
+        size_t edgeCount = EdgeCount(outline);
+        for(size_t i = 0; i < edgeCount || (edgeCount == 0 && i == 0); i++)
+        {
+            // A single point outline is its own closest point
+            Vector2 start = points[outline.start + i];
+            Vector2 end = edgeCount == 0 ? start : points[outline.start + (i + 1) % outline.count];
+            Vector2 closest = ClosestOnSegment(point, start, end);
+            Vector2 offset = Subtract(point, closest);
+            float distanceSquared = offset.x * offset.x + offset.y * offset.y;
+            if(distanceSquared < bestSquared)
+            {
+                bestSquared = distanceSquared;
+                *outClosest = closest;
+            }
+        }
+    }
+    return sqrtf(bestSquared);
+}
+
+void SceneQuery::QueryNearest(Vector2 point, size_t count, std::vector<QueryHit>* results, float maxDistance, uint32_t layerMask) const
+{
+    results->clear();
+    if(count == 0)
+    {
+        return;
+    }
+
+    // Results are kept as a heap with the furthest on top, so it can be swapped out when something closer turns up.
+    // The tree's boxes are never further away than what's in them, so once there are enough results
+    // anything further than the furthest one can be skipped
+    auto isCloser = [](const QueryHit& a, const QueryHit& b) { return a.distance < b.distance; };
+    tree.QueryNearest(point, maxDistance * maxDistance, [&](int proxyID, float maxDistanceSquared)
+    {
+        const QueryProxy& proxy = proxies[proxyID];
+        if(!(proxy.layerMask & layerMask))
+        {
+            return maxDistanceSquared;
+        }
+
+        QueryHit hit;
+        hit.node = proxy.node;
+        hit.distance = ClosestPoint(proxy, point, &hit.point);
+        if(hit.distance > maxDistance || (results->size() == count && hit.distance >= results->front().distance))
+        {
+            return maxDistanceSquared;
+        }
+        if(hit.distance > 0)
+        {
+            hit.normal = {(point.x - hit.point.x) / hit.distance, (point.y - hit.point.y) / hit.distance};
+        }
+
+        if(results->size() == count)
+        {
+            std::pop_heap(results->begin(), results->end(), isCloser);
+            results->pop_back();
+        }
+        results->push_back(hit);
+        std::push_heap(results->begin(), results->end(), isCloser);
+        if(results->size() < count)
+        {
+            return maxDistanceSquared;
+        }
+        return results->front().distance * results->front().distance;
+    });
+    std::sort_heap(results->begin(), results->end(), isCloser);
+}
@@ -1,9 +1,11 @@
 #include "../../include/astrocore/systems/scenetree.h"
+#include <algorithm>
 using namespace Astrocore;
 
 SceneTree::SceneTree()
 {
     SceneTree::created = true;
+    transformSystem.SetTrackChanges(true);
     treeRoot = std::unique_ptr<TreeNode>(new TreeNode());
 }
 
@@ -23,14 +25,335 @@ void SceneTree::SetCurrentScene(std::weak_ptr<TreeNode> newSceneRoot)
     RegisterToTree(newSceneRoot);
 }
 
+void SceneTree::Update(float deltaTime)
+{
+    if(std::shared_ptr<TreeNode> scene = currentScene.lock())
+    {
+        isDeferringParallel = jobSystem != nullptr;
+        parallelDeltaTime = deltaTime;
+        isParallelFixed = false;
+        scene->Update(deltaTime);
+        isDeferringParallel = false;
+        RunParallelUpdates();
+    }
+}
+
+void SceneTree::FixedUpdate(float deltaTime)
+{
+    if(std::shared_ptr<TreeNode> scene = currentScene.lock())
+    {
+        isDeferringParallel = jobSystem != nullptr;
+        parallelDeltaTime = deltaTime;
+        isParallelFixed = true;
+        scene->FixedUpdate(deltaTime);
+        isDeferringParallel = false;
+        RunParallelUpdates();
+    }
+}
+
+bool SceneTree::DeferParallelUpdate(TreeNode* node)
+{
+    if(!isDeferringParallel)
+    {
+        return false;
+    }
+    parallelUpdates.push_back({node, parallelDeltaTime, isParallelFixed});
+    return true;
+}
+
+void SceneTree::RunParallelUpdates()
+{
+    if(parallelUpdates.empty())
+    {
+        return;
+    }
+
+    // Every subtree starts from the same world transforms, whichever order they run in
+    transformSystem.Propagate();
+    transformSystem.SetConcurrent(true);
+
+    JobCounter counter;
+    for(ParallelUpdate& update : parallelUpdates)
+    {
+        jobSystem->Submit([](void* data)
+        {
+            ParallelUpdate* update = (ParallelUpdate*)data;
+            // Restored after, this thread may have been waiting inside another subtree's update
+            ParallelUpdate* previousUpdate = currentParallelUpdate;
+            currentParallelUpdate = update;
+            if(update->isFixed)
+            {
+                update->node->FixedUpdate(update->deltaTime);
+            }
+            else
+            {
+                update->node->Update(update->deltaTime);
+            }
+            currentParallelUpdate = previousUpdate;
+        }, &update, &counter);
+    }
+    jobSystem->Wait(&counter);
+
+    transformSystem.SetConcurrent(false);
+
+    // The spatial index is shared by every subtree, so their changes to it are applied here, in the
+    // order the subtrees were reached rather than the order they happened to finish in
+    for(ParallelUpdate& update : parallelUpdates)
+    {
+        for(TreeNode* node : update.boundsDirty)
+        {
+            MarkBoundsDirty(node);
+        }
+        for(TreeNode* node : update.layerMaskChanged)
+        {
+            OnLayerMaskChanged(node);
+        }
+    }
+    parallelUpdates.clear();
+}
+
+void SceneTree::PropagateTransforms()
+{
+    transformSystem.Propagate();
+}
+
 void SceneTree::RegisterToTree(std::weak_ptr<TreeNode> nodeToRegister)
 {
-    drawnNodesInScene->push_back(nodeToRegister);
-    nodeToRegister.lock()->EnterTree(this);
+    if(std::shared_ptr<TreeNode> node = nodeToRegister.lock())
+    {
+        RegisterToTree(node.get());
+    }
+}
+
+void SceneTree::RegisterToTree(TreeNode* nodeToRegister)
+{
+    nodeToRegister->EnterTree(this);
+
+    // Nodes add themselves on entering the tree, this catches anything that didn't
+    TrackNode(nodeToRegister);
+    if(nodeToRegister->IsDrawn() && nodeToRegister->spatialProxy == NULL_PROXY)
+    {
+        AddToSpatialIndex(nodeToRegister);
+    }
 }
 
 void SceneTree::DeRegisterToTree(std::weak_ptr<TreeNode> nodeToDeRegister)
 {
-    //drawnNodesInScene->erase();
-    // TODO: Find in tree and push 
-}
\ No newline at end of file
+    if(std::shared_ptr<TreeNode> node = nodeToDeRegister.lock())
+    {
+        DeRegisterToTree(node.get());
+    }
+}
+
+void SceneTree::DeRegisterToTree(TreeNode* nodeToDeRegister)
+{
+    nodeToDeRegister->ExitTree();
+
+    // Same as registering, clean up after nodes that don't do it themselves
+    UntrackNode(nodeToDeRegister);
+    RemoveFromSpatialIndex(nodeToDeRegister);
+}
+
+void SceneTree::TrackNode(TreeNode* node)
+{
+    if(!nodesInScene.IsValid(node->treeHandle))
+    {
+        node->treeHandle = nodesInScene.Add(node);
+    }
+}
+
+void SceneTree::UntrackNode(TreeNode* node)
+{
+    nodesInScene.Remove(node->treeHandle);
+    node->treeHandle = NULL_NODE_HANDLE;
+}
+
+void SceneTree::AddToSpatialIndex(TreeNode* node, TransformID transformID)
+{
+    if(node->spatialProxy != NULL_PROXY)
+    {
+        return;
+    }
+
+    int entryID;
+    if(!freeSpatialEntries.empty())
+    {
+        entryID = freeSpatialEntries.back();
+        freeSpatialEntries.pop_back();
+    }
+    else
+    {
+        entryID = spatialEntries.size();
+        spatialEntries.push_back(SpatialEntry());
+    }
+    node->spatialProxy = entryID;
+
+    SpatialEntry& entry = spatialEntries[entryID];
+    entry.node = node;
+    entry.queryStamp = 0;
+    Rectangle bounds;
+    bool hasBounds = node->GetWorldBounds(&bounds);
+    PlaceInLayers(entry, hasBounds ? &bounds : nullptr);
+    entry.queryProxy = query.SyncNode(node, NULL_TREE_NODE);
+
+    if(transformID != NULL_TRANSFORM)
+    {
+        if(transformID >= (int)spatialNodesByTransform.size())
+        {
+            spatialNodesByTransform.resize(transformID + 1, nullptr);
+        }
+        spatialNodesByTransform[transformID] = node;
+    }
+}
+
+void SceneTree::RemoveFromSpatialIndex(TreeNode* node, TransformID transformID)
+{
+    if(node->spatialProxy == NULL_PROXY)
+    {
+        return;
+    }
+
+    SpatialEntry& entry = spatialEntries[node->spatialProxy];
+    RemoveFromLayers(entry);
+    query.RemoveNode(entry.queryProxy);
+    entry.queryProxy = NULL_TREE_NODE;
+    entry.node = nullptr;
+    entry.isBoundsDirtyQueued = false;
+    freeSpatialEntries.push_back(node->spatialProxy);
+    node->spatialProxy = NULL_PROXY;
+
+    if(transformID != NULL_TRANSFORM && transformID < (int)spatialNodesByTransform.size())
+    {
+        spatialNodesByTransform[transformID] = nullptr;
+    }
+}
+
+void SceneTree::PlaceInLayers(SpatialEntry& entry, const Rectangle* bounds)
+{
+    entry.layerMask = entry.node->GetLayerMask();
+    entry.proxies.clear();
+    for(int layer = 0; layer < LAYER_COUNT; layer++)
+    {
+        if(entry.layerMask & (1u << layer))
+        {
+            entry.proxies.push_back(layerIndices[layer].CreateProxy(entry.node, bounds));
+        }
+    }
+}
+
+void SceneTree::RemoveFromLayers(SpatialEntry& entry)
+{
+    size_t proxyIndex = 0;
+    for(int layer = 0; layer < LAYER_COUNT; layer++)
+    {
+        if(entry.layerMask & (1u << layer))
+        {
+            layerIndices[layer].DestroyProxy(entry.proxies[proxyIndex++]);
+        }
+    }
+    entry.proxies.clear();
+    entry.layerMask = 0;
+}
+
+void SceneTree::MarkBoundsDirty(TreeNode* node)
+{
+    if(currentParallelUpdate != nullptr)
+    {
+        currentParallelUpdate->boundsDirty.push_back(node);
+        return;
+    }
+    if(node->spatialProxy != NULL_PROXY && !spatialEntries[node->spatialProxy].isBoundsDirtyQueued)
+    {
+        spatialEntries[node->spatialProxy].isBoundsDirtyQueued = true;
+        boundsDirtyEntries.push_back(node->spatialProxy);
+    }
+}
+
+void SceneTree::OnLayerMaskChanged(TreeNode* node)
+{
+    if(currentParallelUpdate != nullptr)
+    {
+        currentParallelUpdate->layerMaskChanged.push_back(node);
+        return;
+    }
+    if(node->spatialProxy == NULL_PROXY)
+    {
+        return;
+    }
+
+    SpatialEntry& entry = spatialEntries[node->spatialProxy];
+    RemoveFromLayers(entry);
+    Rectangle bounds;
+    bool hasBounds = node->GetWorldBounds(&bounds);
+    PlaceInLayers(entry, hasBounds ? &bounds : nullptr);
+    entry.queryProxy = query.SyncNode(node, entry.queryProxy);
+}
+
+void SceneTree::RefreshBounds(TreeNode* node)
+{
+    SpatialEntry& entry = spatialEntries[node->spatialProxy];
+    Rectangle bounds;
+    bool hasBounds = node->GetWorldBounds(&bounds);
+
+    size_t proxyIndex = 0;
+    for(int layer = 0; layer < LAYER_COUNT; layer++)
+    {
+        if(entry.layerMask & (1u << layer))
+        {
+            layerIndices[layer].UpdateProxy(entry.proxies[proxyIndex++], hasBounds ? &bounds : nullptr);
+        }
+    }
+    entry.queryProxy = query.SyncNode(node, entry.queryProxy);
+}
+
+void SceneTree::UpdateSpatialIndex()
+{
+    // Only nodes whose world transform was actually recomputed need re-binning
+    for(TransformID id : transformSystem.GetChangedIDs())
+    {
+        if(id < (int)spatialNodesByTransform.size() && spatialNodesByTransform[id] != nullptr)
+        {
+            RefreshBounds(spatialNodesByTransform[id]);
+        }
+    }
+    transformSystem.ClearChangedIDs();
+
+    for(int entryID : boundsDirtyEntries)
+    {
+        SpatialEntry& entry = spatialEntries[entryID];
+        if(entry.isBoundsDirtyQueued)
+        {
+            entry.isBoundsDirtyQueued = false;
+            RefreshBounds(entry.node);
+        }
+    }
+    boundsDirtyEntries.clear();
+}
+
+void SceneTree::QueryVisible(Rectangle area, std::vector<TreeNode*>* results, uint32_t cullMask)
+{
+    currentQueryStamp++;
+    for(int layer = 0; layer < LAYER_COUNT; layer++)
+    {
+        if(!(cullMask & (1u << layer)) || layerIndices[layer].GetProxyCount() == 0)
+        {
+            continue;
+        }
+
+        // Drop anything already found on an earlier layer
+        size_t start = results->size();
+        layerIndices[layer].Query(area, results);
+        size_t kept = start;
+        for(size_t i = start; i < results->size(); i++)
+        {
+            TreeNode* node = (*results)[i];
+            SpatialEntry& entry = spatialEntries[node->spatialProxy];
+            if(entry.queryStamp != currentQueryStamp)
+            {
+                entry.queryStamp = currentQueryStamp;
+                (*results)[kept++] = node;
+            }
+        }
+        results->resize(kept);
+    }
+}
@@ -0,0 +1,266 @@
+#include "../../include/astrocore/systems/spatialgrid.h"
+#include <algorithm>
+#include <cmath>
+
+using namespace Astrocore;
+
+static inline bool Overlaps(const Rectangle& a, const Rectangle& b)
+{
+    return a.x <= b.x + b.width && b.x <= a.x + a.width &&
+           a.y <= b.y + b.height && b.y <= a.y + a.height;
+}
+
+static void RemoveFromList(std::vector<int>& list, int value)
+{
+    std::vector<int>::iterator it = std::find(list.begin(), list.end(), value);
+    if(it != list.end())
+    {
+        // Order doesn't matter, so swap with the back instead of shifting everything
+        *it = list.back();
+        list.pop_back();
+    }
+}
+
+// Cells further out than this don't get bucketed, so the casts and cell counts can't overflow
+static const float MAX_CELL_COORDINATE = (float)(1 << 30);
+
+// The cells a rectangle covers, FALSE if its bounds aren't finite or are too far out to bucket
+static bool GetCellRange(const Rectangle& bounds, float cellSize, int* minX, int* minY, int* maxX, int* maxY)
+{
+    float cellRange[4] = {floorf(bounds.x / cellSize), floorf(bounds.y / cellSize),
+                          floorf((bounds.x + bounds.width) / cellSize), floorf((bounds.y + bounds.height) / cellSize)};
+    for(float cell : cellRange)
+    {
+        // NaN fails this too
+        if(!(fabsf(cell) < MAX_CELL_COORDINATE))
+        {
+            return false;
+        }
+    }
+    *minX = (int)cellRange[0];
+    *minY = (int)cellRange[1];
+    *maxX = (int)cellRange[2];
+    *maxY = (int)cellRange[3];
+    return true;
+}
+
+SpatialGrid::SpatialGrid(float cellSize)
+{
+    this->cellSize = cellSize > 0 ? cellSize : 256.0f;
+}
+
+int SpatialGrid::CreateProxy(TreeNode* node, const Rectangle* bounds)
+{
+    int proxyID;
+    if(!freeProxies.empty())
+    {
+        proxyID = freeProxies.back();
+        freeProxies.pop_back();
+        proxies[proxyID] = Proxy();
+    }
+    else
+    {
+        proxyID = proxies.size();
+        proxies.push_back(Proxy());
+    }
+
+    proxies[proxyID].node = node;
+    proxies[proxyID].inUse = true;
+    Place(proxyID, bounds);
+    return proxyID;
+}
+
+void SpatialGrid::UpdateProxy(int proxyID, const Rectangle* bounds)
+{
+    Proxy& proxy = proxies[proxyID];
+
+    // Still covering the same cells: just store the new bounds
+    if(bounds != nullptr && proxy.placement == CELLS)
+    {
+        int minX, minY, maxX, maxY;
+        if(GetCellRange(*bounds, cellSize, &minX, &minY, &maxX, &maxY) &&
+           minX == proxy.minCellX && minY == proxy.minCellY && maxX == proxy.maxCellX && maxY == proxy.maxCellY)
+        {
+            proxy.bounds = *bounds;
+            return;
+        }
+    }
+
+    Unplace(proxyID);
+    Place(proxyID, bounds);
+}
+
+void SpatialGrid::DestroyProxy(int proxyID)
+{
+    if(proxyID < 0 || proxyID >= (int)proxies.size() || !proxies[proxyID].inUse)
+    {
+        return;
+    }
+    Unplace(proxyID);
+    proxies[proxyID].inUse = false;
+    proxies[proxyID].node = nullptr;
+    freeProxies.push_back(proxyID);
+}
+
+void SpatialGrid::Place(int proxyID, const Rectangle* bounds)
+{
+    Proxy& proxy = proxies[proxyID];
+    if(bounds == nullptr)
+    {
+        proxy.placement = UNBOUNDED;
+        unboundedProxies.push_back(proxyID);
+        return;
+    }
+
+    proxy.bounds = *bounds;
+    // Bounds that can't be bucketed (infinite, NaN, or absurdly far out) are just always tested
+    bool isInRange = GetCellRange(*bounds, cellSize, &proxy.minCellX, &proxy.minCellY, &proxy.maxCellX, &proxy.maxCellY);
+    int64_t cellCount = ((int64_t)proxy.maxCellX - proxy.minCellX + 1) * ((int64_t)proxy.maxCellY - proxy.minCellY + 1);
+    if(!isInRange || cellCount > MAX_CELLS_PER_PROXY)
+    {
+        proxy.placement = LARGE;
+        largeProxies.push_back(proxyID);
+        return;
+    }
+
+    proxy.placement = CELLS;
+    for(int x = proxy.minCellX; x <= proxy.maxCellX; x++)
+    {
+        for(int y = proxy.minCellY; y <= proxy.maxCellY; y++)
+        {
+            std::vector<int>& cell = cells[CellKey(x, y)];
+            // Reusing a cell that was left empty (brand new cells have no capacity yet)
+            if(cell.empty() && cell.capacity() > 0)
+            {
+                emptyCellCount--;
+            }
+            cell.push_back(proxyID);
+        }
+    }
+}
+
+void SpatialGrid::Unplace(int proxyID)
+{
+    Proxy& proxy = proxies[proxyID];
+    switch (proxy.placement)
+    {
+    case UNBOUNDED:
+        RemoveFromList(unboundedProxies, proxyID);
+        break;
+    case LARGE:
+        RemoveFromList(largeProxies, proxyID);
+        break;
+    case CELLS:
+        for(int x = proxy.minCellX; x <= proxy.maxCellX; x++)
+        {
+            for(int y = proxy.minCellY; y <= proxy.maxCellY; y++)
+            {
+                std::unordered_map<int64_t, std::vector<int>>::iterator cell = cells.find(CellKey(x, y));
+                if(cell != cells.end())
+                {
+                    RemoveFromList(cell->second, proxyID);
+                    if(cell->second.empty())
+                    {
+                        emptyCellCount++;
+                    }
+                }
+            }
+        }
+        break;
+    }
+}
+
+void SpatialGrid::TestProxy(int proxyID, Rectangle area)
+{
+    Proxy& proxy = proxies[proxyID];
+
+    // Proxies covering several cells would otherwise be found more than once
+    if(proxy.queryStamp == currentQueryStamp)
+    {
+        return;
+    }
+    proxy.queryStamp = currentQueryStamp;
+
+    if(Overlaps(proxy.bounds, area))
+    {
+        queryScratch.push_back(proxyID);
+    }
+}
+
+void SpatialGrid::PruneEmptyCells()
+{
+    for(std::unordered_map<int64_t, std::vector<int>>::iterator it = cells.begin(); it != cells.end();)
+    {
+        if(it->second.empty())
+        {
+            it = cells.erase(it);
+        }
+        else
+        {
+            it++;
+        }
+    }
+    emptyCellCount = 0;
+}
+
+void SpatialGrid::Query(Rectangle area, std::vector<TreeNode*>* results)
+{
+    // Empty cells are kept around so things moving back and forth don't keep reallocating them,
+    // but once there are lots of them they'd just slow down walking the occupied cells
+    if(emptyCellCount > MIN_EMPTY_CELLS_TO_PRUNE && emptyCellCount * 2 > cells.size())
+    {
+        PruneEmptyCells();
+    }
+
+    currentQueryStamp++;
+    queryScratch.clear();
+
+    int minX, minY, maxX, maxY;
+    bool isInRange = GetCellRange(area, cellSize, &minX, &minY, &maxX, &maxY);
+    int64_t areaCellCount = isInRange ? ((int64_t)maxX - minX + 1) * ((int64_t)maxY - minY + 1) : 0;
+    if(isInRange && areaCellCount <= (int64_t)(cells.size() - emptyCellCount))
+    {
+        for(int x = minX; x <= maxX; x++)
+        {
+            for(int y = minY; y <= maxY; y++)
+            {
+                std::unordered_map<int64_t, std::vector<int>>::iterator cell = cells.find(CellKey(x, y));
+                if(cell == cells.end())
+                {
+                    continue;
+                }
+                for(int proxyID : cell->second)
+                {
+                    TestProxy(proxyID, area);
+                }
+            }
+        }
+    }
+    else
+    {
+        // The area covers more cells than are occupied (zoomed far out, or unbounded), so walk the occupied ones instead
+        for(auto& cell : cells)
+        {
+            for(int proxyID : cell.second)
+            {
+                TestProxy(proxyID, area);
+            }
+        }
+    }
+
+    for(int proxyID : largeProxies)
+    {
+        TestProxy(proxyID, area);
+    }
+    for(int proxyID : unboundedProxies)
+    {
+        queryScratch.push_back(proxyID);
+    }
+
+    // Keep a stable order between frames (proxy ID order)
+    std::sort(queryScratch.begin(), queryScratch.end());
+    for(int proxyID : queryScratch)
+    {
+        results->push_back(proxies[proxyID].node);
+    }
+}
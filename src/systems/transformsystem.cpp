@@ -0,0 +1,340 @@
+#include "../../include/astrocore/systems/transformsystem.h"
+#include <algorithm>
+using namespace Astrocore;
+
+// Values for localDirty
+static const uint8_t LOCAL_CLEAN = 0;
+static const uint8_t LOCAL_SET = 1;         // Local transform was set directly
+static const uint8_t LOCAL_FROM_SOURCE = 2; // Local transform needs to be re-read from its source
+
+TransformID TransformSystem::Add(const Transform2D* source, TransformID parent)
+{
+    int slot = parents.size();
+    TransformID id;
+    if(!freeIDs.empty())
+    {
+        id = freeIDs.back();
+        freeIDs.pop_back();
+    }
+    else
+    {
+        id = idToSlot.size();
+        idToSlot.push_back(-1);
+        isChangeQueued.push_back(0);
+    }
+    idToSlot[id] = slot;
+
+    // Appending keeps the parent-before-child order, since the parent already has a slot
+    parents.push_back(IsValid(parent) ? idToSlot[parent] : -1);
+    localTransforms.push_back(Affine2D::Identity());
+    worldTransforms.push_back(Affine2D::Identity());
+    sources.push_back(source);
+    worldVersions.push_back(0);
+    seenParentVersions.push_back(0);
+    localDirty.push_back(source != nullptr ? LOCAL_FROM_SOURCE : LOCAL_SET);
+    slotToID.push_back(id);
+
+    if(slot < firstDirtySlot)
+    {
+        firstDirtySlot = slot;
+    }
+    return id;
+}
+
+void TransformSystem::Remove(TransformID id)
+{
+    if(!IsValid(id))
+    {
+        return;
+    }
+    int slot = idToSlot[id];
+    parents[slot] = REMOVED_PARENT;
+    sources[slot] = nullptr;
+    slotToID[slot] = NULL_TRANSFORM;
+    idToSlot[id] = -1;
+    freeIDs.push_back(id);
+    removedCount++;
+
+    // Compact once half the slots are dead
+    if(removedCount * 2 > (int)parents.size())
+    {
+        needsReorder = true;
+    }
+}
+
+void TransformSystem::SetParent(TransformID id, TransformID parent)
+{
+    if(!IsValid(id))
+    {
+        return;
+    }
+    int slot = idToSlot[id];
+    int parentSlot = IsValid(parent) ? idToSlot[parent] : -1;
+    parents[slot] = parentSlot;
+
+    // Force a recompute against the new parent
+    if(localDirty[slot] == LOCAL_CLEAN)
+    {
+        localDirty[slot] = LOCAL_SET;
+    }
+    if(slot < firstDirtySlot)
+    {
+        firstDirtySlot = slot;
+    }
+
+    // The parent now comes after the child, the arrays need to be re-sorted
+    if(parentSlot > slot)
+    {
+        needsReorder = true;
+    }
+}
+
+void TransformSystem::MarkDirty(TransformID id)
+{
+    if(!IsValid(id))
+    {
+        return;
+    }
+    int slot = idToSlot[id];
+    localDirty[slot] = LOCAL_FROM_SOURCE;
+    LowerFirstDirtySlot(slot);
+}
+
+void TransformSystem::SetLocal(TransformID id, const Affine2D& local)
+{
+    if(!IsValid(id))
+    {
+        return;
+    }
+    int slot = idToSlot[id];
+    localTransforms[slot] = local;
+    localDirty[slot] = LOCAL_SET;
+    LowerFirstDirtySlot(slot);
+}
+
+void TransformSystem::LowerFirstDirtySlot(int slot)
+{
+    int current = firstDirtySlot.load(std::memory_order_relaxed);
+    while(slot < current && !firstDirtySlot.compare_exchange_weak(current, slot, std::memory_order_relaxed))
+    {
+    }
+}
+
+void TransformSystem::Propagate()
+{
+    if(needsReorder)
+    {
+        Reorder();
+    }
+    Propagate(parents.size() - 1);
+}
+
+void TransformSystem::Propagate(int lastSlot)
+{
+    for(int i = firstDirtySlot; i <= lastSlot; i++)
+    {
+        int parent = parents[i];
+        if(parent == REMOVED_PARENT)
+        {
+            continue;
+        }
+
+        // Parent-before-child order means the parent is already up to date here
+        bool parentChanged = parent >= 0 && seenParentVersions[i] != worldVersions[parent];
+        if(localDirty[i] == LOCAL_CLEAN && !parentChanged)
+        {
+            continue;
+        }
+
+        if(localDirty[i] == LOCAL_FROM_SOURCE && sources[i] != nullptr)
+        {
+            localTransforms[i] = sources[i]->GetAffine();
+        }
+
+        if(parent >= 0 && parents[parent] != REMOVED_PARENT)
+        {
+            worldTransforms[i] = Affine2D::Multiply(worldTransforms[parent], localTransforms[i]);
+            seenParentVersions[i] = worldVersions[parent];
+        }
+        else
+        {
+            worldTransforms[i] = localTransforms[i];
+        }
+
+        localDirty[i] = LOCAL_CLEAN;
+        worldVersions[i]++;
+        recomputeCount++;
+        if(trackChanges && !isChangeQueued[slotToID[i]])
+        {
+            isChangeQueued[slotToID[i]] = 1;
+            changedIDs.push_back(slotToID[i]);
+        }
+    }
+
+    if(lastSlot + 1 > firstDirtySlot)
+    {
+        firstDirtySlot = lastSlot + 1;
+    }
+}
+
+void TransformSystem::Reorder()
+{
+    int count = parents.size();
+
+    // Build child lists, in slot order
+    firstChild.assign(count, -1);
+    nextSibling.assign(count, -1);
+    for(int i = count - 1; i >= 0; i--)
+    {
+        int parent = parents[i];
+        if(parent >= 0 && parents[parent] != REMOVED_PARENT)
+        {
+            nextSibling[i] = firstChild[parent];
+            firstChild[parent] = i;
+        }
+    }
+
+    // Depth-first walk from each root, which also keeps subtrees contiguous
+    order.clear();
+    visited.assign(count, 0);
+    stack.clear();
+    for(int root = 0; root < count; root++)
+    {
+        int parent = parents[root];
+        if(parent == REMOVED_PARENT || visited[root])
+        {
+            continue;
+        }
+        // Skip anything with a live parent, it gets picked up from that parent
+        // (unless it's part of a cycle, which is handled below)
+        if(parent >= 0 && parents[parent] != REMOVED_PARENT)
+        {
+            continue;
+        }
+
+        stack.push_back(root);
+        while(!stack.empty())
+        {
+            int slot = stack.back();
+            stack.pop_back();
+            visited[slot] = 1;
+            order.push_back(slot);
+
+            // Push in reverse so children come out in slot order
+            int childStart = stack.size();
+            for(int child = firstChild[slot]; child != -1; child = nextSibling[child])
+            {
+                stack.push_back(child);
+            }
+            std::reverse(stack.begin() + childStart, stack.end());
+        }
+    }
+
+    // Anything left over is stuck in a parenting cycle: break it by making it a root
+    for(int i = 0; i < count; i++)
+    {
+        if(parents[i] != REMOVED_PARENT && !visited[i])
+        {
+            parents[i] = -1;
+            localDirty[i] = LOCAL_SET;
+            order.push_back(i);
+        }
+    }
+
+    // Reuse firstChild as the old -> new slot lookup, it's no longer needed
+    std::vector<int>& oldToNew = firstChild;
+    for(int i = 0; i < (int)order.size(); i++)
+    {
+        oldToNew[order[i]] = i;
+    }
+
+    // Fill the spare set of arrays, then swap it in (the old arrays become the spares,
+    // so neither set has to be reallocated next time)
+    int newCount = order.size();
+    spareParents.resize(newCount);
+    spareLocalTransforms.resize(newCount);
+    spareWorldTransforms.resize(newCount);
+    spareSources.resize(newCount);
+    spareWorldVersions.resize(newCount);
+    spareSeenParentVersions.resize(newCount);
+    spareLocalDirty.resize(newCount);
+    spareSlotToID.resize(newCount);
+
+    for(int i = 0; i < newCount; i++)
+    {
+        int oldSlot = order[i];
+        int oldParent = parents[oldSlot];
+        spareParents[i] = oldParent >= 0 ? oldToNew[oldParent] : -1;
+        spareLocalTransforms[i] = localTransforms[oldSlot];
+        spareWorldTransforms[i] = worldTransforms[oldSlot];
+        spareSources[i] = sources[oldSlot];
+        spareWorldVersions[i] = worldVersions[oldSlot];
+        spareSeenParentVersions[i] = seenParentVersions[oldSlot];
+        spareLocalDirty[i] = localDirty[oldSlot];
+        spareSlotToID[i] = slotToID[oldSlot];
+        idToSlot[slotToID[oldSlot]] = i;
+    }
+
+    parents.swap(spareParents);
+    localTransforms.swap(spareLocalTransforms);
+    worldTransforms.swap(spareWorldTransforms);
+    sources.swap(spareSources);
+    worldVersions.swap(spareWorldVersions);
+    seenParentVersions.swap(spareSeenParentVersions);
+    localDirty.swap(spareLocalDirty);
+    slotToID.swap(spareSlotToID);
+
+    removedCount = 0;
+    needsReorder = false;
+
+    // Versions moved with their slots, so a full check pass only recomputes what actually changed
+    firstDirtySlot = 0;
+}
+
+void TransformSystem::ClearChangedIDs()
+{
+    for(TransformID id : changedIDs)
+    {
+        isChangeQueued[id] = 0;
+    }
+    changedIDs.clear();
+}
+
+const Affine2D& TransformSystem::GetWorld(TransformID id)
+{
+    if(isConcurrent)
+    {
+        return worldTransforms[idToSlot[id]];
+    }
+    if(needsReorder)
+    {
+        Reorder();
+    }
+    int slot = idToSlot[id];
+    if(slot >= firstDirtySlot)
+    {
+        Propagate(slot);
+    }
+    return worldTransforms[slot];
+}
+
+const Affine2D& TransformSystem::GetLocal(TransformID id)
+{
+    int slot = idToSlot[id];
+    if(localDirty[slot] == LOCAL_FROM_SOURCE && sources[slot] != nullptr)
+    {
+        localTransforms[slot] = sources[slot]->GetAffine();
+        localDirty[slot] = LOCAL_SET;
+    }
+    return localTransforms[slot];
+}
+
+uint32_t TransformSystem::GetWorldVersion(TransformID id)
+{
+    return worldVersions[idToSlot[id]];
+}
+
+bool TransformSystem::IsValid(TransformID id)
+{
+    return id >= 0 && id < (int)idToSlot.size() && idToSlot[id] != -1;
+}
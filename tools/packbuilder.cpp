@@ -0,0 +1,102 @@
+#include "../include/astrocore/systems/packfile.h"
+#include <algorithm>
+#include <cctype>
+#include <cstdio>
+#include <cstring>
+#include <filesystem>
+#include <string>
+#include <vector>
+
+using namespace Astrocore;
+namespace fs = std::filesystem;
+
+// Formats that are already compressed, stored as is so they can be read without copying
+static bool IsAlreadyCompressed(const fs::path& path)
+{
+    static const char* extensions[] = {".png", ".jpg", ".jpeg", ".qoi", ".ogg", ".mp3", ".flac", ".zip", ".gz"};
+    std::string extension = path.extension().string();
+    std::transform(extension.begin(), extension.end(), extension.begin(), ::tolower);
+    for (const char* compressed : extensions)
+    {
+        if (extension == compressed)
+        {
+            return true;
+        }
+    }
+    return false;
+}
+
+// Packs every file under a directory, with paths relative to it
+// Usage: astrocore_packbuilder <asset directory> <assets.apak> [--store|--lz4|--zstd]
+int main(int argc, char** argv)
+{
+    if (argc < 3 || argc > 4)
+    {
+        fprintf(stderr, "Usage: %s <asset directory> <assets.apak> [--store|--lz4|--zstd]\n", argv[0]);
+        return 1;
+    }
+    PACK_COMPRESSION compression = PACK_LZ4;
+    if (argc == 4)
+    {
+        if (strcmp(argv[3], "--store") == 0)
+        {
+            compression = PACK_STORED;
+        }
+        else if (strcmp(argv[3], "--zstd") == 0)
+        {
+            compression = PACK_ZSTD;
+        }
+        else if (strcmp(argv[3], "--lz4") != 0)
+        {
+            fprintf(stderr, "Unknown compression %s\n", argv[3]);
+            return 1;
+        }
+    }
+
+    std::error_code error;
+    fs::path root = argv[1];
+    std::vector<fs::path> files;
+    for (fs::recursive_directory_iterator it(root, error), end; !error && it != end; it.increment(error))
+    {
+        if (it->is_regular_file())
+        {
+            files.push_back(it->path());
+        }
+    }
+    if (error)
+    {
+        fprintf(stderr, "Couldn't read %s: %s\n", argv[1], error.message().c_str());
+        return 1;
+    }
+    // Sorted, so files in the same directory end up next to each other in the pack (and builds are repeatable)
+    std::sort(files.begin(), files.end());
+
+    PackWriter writer;
+    for (const fs::path& file : files)
+    {
+        PACK_COMPRESSION fileCompression = IsAlreadyCompressed(file) ? PACK_STORED : compression;
+        writer.AddFile(file.lexically_relative(root).generic_string(), file.string(), fileCompression);
+    }
+    if (!writer.Write(argv[2]))
+    {
+        std::remove(argv[2]);
+        return 1;
+    }
+
+    // Make sure it loads before calling it done
+    PackFile pack;
+    if (!pack.Open(argv[2]))
+    {
+        return 1;
+    }
+    uint64_t size = 0;
+    uint64_t storedSize = 0;
+    for (uint32_t i = 0; i < pack.GetEntryCount(); i++)
+    {
+        size += pack.GetEntry(i)->size;
+        storedSize += pack.GetEntry(i)->storedSize;
+    }
+    printf("Packed %u files in to %s: %llu bytes, %llu stored\n", pack.GetEntryCount(), argv[2],
+           (unsigned long long)size, (unsigned long long)storedSize);
+    return 0;
+}
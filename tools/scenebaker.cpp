@@ -0,0 +1,46 @@
+#include "../include/astrocore/systems/scenefile.h"
+#include <cstdio>
+#include <fstream>
+
+using namespace Astrocore;
+
+// Bakes a text scene in to the binary format SceneFile loads
+// Usage: astrocore_scenebaker <scene.txt> <scene.ascn>
+int main(int argc, char** argv)
+{
+    if (argc != 3)
+    {
+        fprintf(stderr, "Usage: %s <scene.txt> <scene.ascn>\n", argv[0]);
+        return 1;
+    }
+
+    std::ifstream input(argv[1]);
+    if (!input)
+    {
+        fprintf(stderr, "Couldn't open %s\n", argv[1]);
+        return 1;
+    }
+    std::ofstream output(argv[2], std::ios::binary | std::ios::trunc);
+    if (!output)
+    {
+        fprintf(stderr, "Couldn't open %s for writing\n", argv[2]);
+        return 1;
+    }
+
+    if (!BakeSceneText(input, output))
+    {
+        output.close();
+        std::remove(argv[2]);
+        return 1;
+    }
+    output.close();
+
+    // Make sure it loads before calling it done
+    SceneFile scene;
+    if (!scene.Open(argv[2]))
+    {
+        return 1;
+    }
+    printf("Baked %s: %u nodes, %u shapes, %u points\n", argv[2], scene.GetNodeCount(), scene.GetShapeCount(), scene.GetPointCount());
+    return 0;
+}